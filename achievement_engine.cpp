@@ -0,0 +1,170 @@
+#include "achievement_engine.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+bool parseEvent(const std::string& name, GameEventType& out) {
+    if (name == "roll") out = EVENT_ROLL;
+    else if (name == "hold") out = EVENT_HOLD;
+    else if (name == "bank") out = EVENT_BANK;
+    else if (name == "zilch") out = EVENT_ZILCH;
+    else if (name == "game_end") out = EVENT_GAME_END;
+    else return false;
+    return true;
+}
+
+bool parseKind(const std::string& name, AchievementRuleKind& out) {
+    if (name == "count") out = RULE_COUNT;
+    else if (name == "streak") out = RULE_STREAK;
+    else if (name == "win_margin") out = RULE_WIN_MARGIN;
+    else if (name == "win_ratio") out = RULE_WIN_RATIO;
+    else if (name == "comeback") out = RULE_COMEBACK;
+    else return false;
+    return true;
+}
+
+}
+
+
+// The original three achievements, used when assets/achievements.json is missing
+std::vector<AchievementRule> AchievementEngine::defaultRules() {
+    std::vector<AchievementRule> defaults(3);
+
+    defaults[0].name = "By the Skin of Your Teeth";
+    defaults[0].description = "Win against AI with 100 or fewer points more than the AI";
+    defaults[0].kind = RULE_WIN_MARGIN;
+    defaults[0].maxMargin = 100;
+
+    defaults[1].name = "Dominating Victory";
+    defaults[1].description = "Win with more than double the AI's points";
+    defaults[1].kind = RULE_WIN_RATIO;
+    defaults[1].ratio = 2.0f;
+
+    defaults[2].name = "Comeback King";
+    defaults[2].description = "Win after being behind by 500+ points";
+    defaults[2].kind = RULE_COMEBACK;
+    defaults[2].target = 500;
+
+    return defaults;
+}
+
+std::vector<AchievementRule> AchievementEngine::loadRules(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return defaultRules();
+
+    nlohmann::json jsonData = nlohmann::json::parse(file, nullptr, false);
+    if (jsonData.is_discarded() || !jsonData.contains("achievements") || !jsonData["achievements"].is_array()) {
+        std::cerr << "Error: " << path << " is not a valid achievement file, using defaults.\n";
+        return defaultRules();
+    }
+
+    std::vector<AchievementRule> loaded;
+    for (const auto& entry : jsonData["achievements"]) {
+        AchievementRule rule;
+        rule.name = entry.value("name", "");
+        rule.description = entry.value("description", "");
+
+        if (rule.name.empty() || !parseKind(entry.value("kind", ""), rule.kind)) {
+            std::cerr << "Error: Skipping achievement '" << rule.name << "' with a missing name or unknown kind.\n";
+            continue;
+        }
+        if (entry.contains("event") && !parseEvent(entry.value("event", ""), rule.event)) {
+            std::cerr << "Error: Skipping achievement '" << rule.name << "' with an unknown event.\n";
+            continue;
+        }
+        if (entry.contains("reset") && !parseEvent(entry.value("reset", ""), rule.resetOn)) {
+            std::cerr << "Error: Skipping achievement '" << rule.name << "' with an unknown reset event.\n";
+            continue;
+        }
+
+        rule.hand = entry.value("hand", "");
+        rule.minPoints = entry.value("min_points", 0);
+        rule.target = entry.value("target", 1);
+        rule.maxMargin = entry.value("max_margin", 0);
+        rule.ratio = entry.value("ratio", 1.0f);
+        rule.requireWin = entry.value("require_win", false);
+        loaded.push_back(rule);
+    }
+    return loaded;
+}
+
+void AchievementEngine::setRules(const std::vector<AchievementRule>& newRules) {
+    rules = newRules;
+    states.assign(rules.size(), RuleState());
+    for (auto& list : listeners) list.clear();
+
+    for (size_t i = 0; i < rules.size(); ++i) {
+        const AchievementRule& rule = rules[i];
+        if (rule.kind == RULE_COUNT || rule.kind == RULE_STREAK) {
+            listeners[rule.event].push_back(i);
+            if (rule.kind == RULE_STREAK && rule.resetOn != rule.event) {
+                listeners[rule.resetOn].push_back(i);
+            }
+            if (rule.requireWin && rule.event != EVENT_GAME_END) {
+                listeners[EVENT_GAME_END].push_back(i);
+            }
+        } else {
+            listeners[EVENT_GAME_END].push_back(i);
+        }
+    }
+}
+
+bool AchievementEngine::matches(const AchievementRule& rule, const GameEvent& event) const {
+    if (event.type != rule.event || event.playerIndex != 0) return false;
+    if (event.points < rule.minPoints) return false;
+    return rule.hand.empty() || event.hand.compare(0, rule.hand.size(), rule.hand) == 0;
+}
+
+void AchievementEngine::onEvent(const GameEvent& event, const std::function<void(const std::string&)>& unlocked) {
+    // Progress within a game is not saved, so a resumed one starts counting afresh
+    if (event.type == EVENT_GAME_START || event.type == EVENT_GAME_RESUME) {
+        active = !event.opponentType.empty();
+        maxDeficit = 0;
+        std::fill(states.begin(), states.end(), RuleState());
+        return;
+    }
+    if (!active) return;
+
+    maxDeficit = std::max(maxDeficit, event.scores[1] - event.scores[0]);
+    bool won = event.scores[0] > event.scores[1];
+
+    for (int index : listeners[event.type]) {
+        const AchievementRule& rule = rules[index];
+        RuleState& state = states[index];
+
+        switch (rule.kind) {
+            case RULE_COUNT:
+            case RULE_STREAK:
+                if (matches(rule, event)) {
+                    state.count++;
+                    if (state.count >= rule.target) state.reached = true;
+                } else if (rule.kind == RULE_STREAK && event.type == rule.resetOn && event.playerIndex == 0) {
+                    state.count = 0;
+                }
+
+                if (state.reached && (!rule.requireWin || (event.type == EVENT_GAME_END && won))) {
+                    unlocked(rule.name);
+                }
+                break;
+
+            case RULE_WIN_MARGIN:
+                if (won && event.scores[0] - event.scores[1] <= rule.maxMargin) unlocked(rule.name);
+                break;
+
+            case RULE_WIN_RATIO:
+                if (won && event.scores[0] >= rule.ratio * event.scores[1]) unlocked(rule.name);
+                break;
+
+            case RULE_COMEBACK:
+                if (won && maxDeficit >= rule.target) unlocked(rule.name);
+                break;
+        }
+    }
+
+    if (event.type == EVENT_GAME_END) {
+        active = false;
+    }
+}
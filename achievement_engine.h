@@ -0,0 +1,62 @@
+#ifndef ACHIEVEMENT_ENGINE_H
+#define ACHIEVEMENT_ENGINE_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "events.h"
+
+enum AchievementRuleKind {
+    RULE_COUNT,       // Matching events in one game reach target
+    RULE_STREAK,      // Matching events in a row (broken by resetOn) reach target
+    RULE_WIN_MARGIN,  // Win by at most maxMargin points
+    RULE_WIN_RATIO,   // Final score at least ratio times the opponent's
+    RULE_COMEBACK     // Win after trailing by target or more at any point
+};
+
+// One achievement as described in assets/achievements.json
+struct AchievementRule {
+    std::string name;
+    std::string description;
+    AchievementRuleKind kind;
+    GameEventType event = EVENT_HOLD;      // Counted event (count and streak rules)
+    GameEventType resetOn = EVENT_ZILCH;   // Event that breaks a streak
+    std::string hand;                      // Only holds whose label starts with this
+    int minPoints = 0;                     // Only events worth at least this many points
+    int target = 1;
+    int maxMargin = 0;
+    float ratio = 1.0f;
+    bool requireWin = false;               // Count and streak rules only unlock on a win
+};
+
+// Evaluates rules incrementally as game events arrive. Each event only visits the
+// rules that listen to its type, and each of those does constant work.
+// Only the human player (player 0) in games against an AI can unlock achievements.
+class AchievementEngine {
+public:
+    void setRules(const std::vector<AchievementRule>& newRules);
+    const std::vector<AchievementRule>& getRules() const { return rules; }
+
+    // Called with the rule name whenever an achievement is earned
+    void onEvent(const GameEvent& event, const std::function<void(const std::string&)>& unlocked);
+
+    static std::vector<AchievementRule> loadRules(const std::string& path);
+    static std::vector<AchievementRule> defaultRules();
+
+private:
+    struct RuleState {
+        int count = 0;
+        bool reached = false;
+    };
+
+    std::vector<AchievementRule> rules;
+    std::vector<RuleState> states;
+    std::vector<int> listeners[EVENT_TYPE_COUNT]; // Rule indices per event type
+
+    bool active = false;  // Current game is human vs AI
+    int maxDeficit = 0;   // Largest lead the AI has had this game
+
+    bool matches(const AchievementRule& rule, const GameEvent& event) const;
+};
+
+#endif
@@ -1,14 +1,20 @@
 #include "achievements.h"
 #include <fstream>
 #include <iostream>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <unistd.h>
 #include <nlohmann/json.hpp>
 #include "players.h"
+#include "snapshot.h"
+#include "achievement_engine.h"
+#include "shared_stats.h"
 
-std::vector<Achievement> achievements = {
-    {"By the Skin of Your Teeth", "Win against AI with 100 or fewer points more than the AI", false},
-    {"Dominating Victory", "Win with more than double the AI's points", false},
-    {"Comeback King", "Win after being behind by 500+ points", false}
-};
+// Built from the rules in assets/achievements.json when progress is loaded
+std::vector<Achievement> achievements;
 
 std::unordered_map<std::string, Statistic> statistics = {
     {"Wins against Aggressive AI", {"Wins against Aggressive AI", 0}},
@@ -18,26 +24,91 @@ std::unordered_map<std::string, Statistic> statistics = {
     {"Total number of Games against AI", {"Total number of Games against AI", 0}}
 };
 
+// Which statistic a win counts towards, by the AI type of the opponent
+const std::unordered_map<std::string, std::string> winStatisticByAIType = {
+    {"aggressive", "Wins against Aggressive AI"},
+    {"cautious", "Wins against Cautious AI"},
+    {"adaptive", "Wins against Adaptive AI"}
+};
 
 
 
 
-// Load progress from a file
-void Achievements::loadProgress() {
-    std::ifstream file("progress.json");
-    if (!file.is_open()) return;
 
+namespace {
+
+// progress.shm holds the live totals shared by every running instance.
+// progress.snap is persisted from it periodically and seeds it if it is lost.
+// progress.json is only read to migrate older saves, and is still exported.
+const std::string PROGRESS_SEGMENT = "progress.shm";
+const std::string PROGRESS_SNAPSHOT = "progress.snap";
+const std::string PROGRESS_EXPORT = "progress.json";
+const std::string ACHIEVEMENT_RULES = "assets/achievements.json";
+const std::chrono::seconds PERSIST_INTERVAL(5);
+const char SNAPSHOT_MAGIC[4] = {'Z', 'P', 'R', 'G'};
+const uint16_t SNAPSHOT_VERSION = 2;
+
+bool progressLoaded = false;
+AchievementEngine engine;
+
+// Declared before the compactor so its thread is joined before the segment is unmapped
+SharedStats sharedStats;
+std::unordered_map<std::string, int> statisticSlots;
+std::unordered_map<std::string, int> achievementSlots;
+// Guards statistics, achievements and their slots, which the background save copies
+std::mutex progressMutex;
+
+uint64_t persistedChanges = 0;
+std::chrono::steady_clock::time_point lastPersist;
+
+// Compaction runs on its own thread; joined before the next one starts and at exit
+struct Compactor {
+    std::thread worker;
+    std::atomic<bool> running{false};
+    ~Compactor() {
+        if (worker.joinable()) worker.join();
+    }
+};
+Compactor compactor;
+
+
+// Temporary files are per process, as several instances may persist at once
+std::string tempPathFor(const std::string& path) {
+    return path + ".tmp." + std::to_string(getpid());
+}
+
+void writeProgressJson(const std::unordered_map<std::string, Statistic>& stats, const std::vector<Achievement>& achs) {
+    std::string tempPath = tempPathFor(PROGRESS_EXPORT);
+    std::ofstream file(tempPath);
     nlohmann::json jsonData;
-    file >> jsonData;
+
+    for (const auto& ach : achs) {
+        jsonData["achievements"][ach.name] = ach.unlocked;
+    }
+
+    for (const auto& stat : stats) {
+        jsonData["statistics"][stat.first] = stat.second.count;
+    }
+
+    file << jsonData.dump(4);
+    file.close();
+    if (file) std::rename(tempPath.c_str(), PROGRESS_EXPORT.c_str());
+}
+
+// Only used the first time, to carry progress over from the old progress.json saves
+void importProgressJson() {
+    std::ifstream file(PROGRESS_EXPORT);
+    if (!file.is_open()) return;
+
+    nlohmann::json jsonData = nlohmann::json::parse(file, nullptr, false);
     file.close();
+    if (jsonData.is_discarded()) return;
 
     // Load achievements
     if (jsonData.contains("achievements") && jsonData["achievements"].is_object()) {
         for (auto& ach : achievements) {
             if (jsonData["achievements"].contains(ach.name) && jsonData["achievements"][ach.name].is_boolean()) {
                 ach.unlocked = jsonData["achievements"][ach.name];
-            } else {
-                ach.unlocked = false; // Default to locked if not found
             }
         }
     }
@@ -46,77 +117,229 @@ void Achievements::loadProgress() {
     if (jsonData.contains("statistics") && jsonData["statistics"].is_object()) {
         for (auto& stat : statistics) {
             if (jsonData["statistics"].contains(stat.first) && jsonData["statistics"][stat.first].is_number_integer()) {
-                statistics[stat.first].count = jsonData["statistics"][stat.first];
-            } else {
-                statistics[stat.first].count = 0; // Default to 0 if not found
+                stat.second.count = jsonData["statistics"][stat.first];
             }
         }
     }
 }
 
-// Save progress to a file
-void Achievements::saveProgress() {
-    std::ofstream file("progress.json");
-    nlohmann::json jsonData;
+// Snapshot layout, little endian: "ZPRG" | u16 version
+//   | u16 count + (u8 length + name, i32 count)[] | u16 count + (u8 length + name, u8 unlocked)[]
+//   | u32 checksum
+bool writeProgressSnapshot(const std::unordered_map<std::string, Statistic>& stats, const std::vector<Achievement>& achs) {
+    std::vector<uint8_t> data;
+    ByteWriter w{data};
+    w.bytes(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    w.u16(SNAPSHOT_VERSION);
 
-    for (const auto& ach : achievements) {
-        jsonData["achievements"][ach.name] = ach.unlocked;
+    w.u16(static_cast<uint16_t>(stats.size()));
+    for (const auto& stat : stats) {
+        w.str(stat.first);
+        w.i32(stat.second.count);
     }
 
-    for (const auto& stat : statistics) {
-        jsonData["statistics"][stat.first] = stat.second.count;
+    w.u16(static_cast<uint16_t>(achs.size()));
+    for (const auto& ach : achs) {
+        w.str(ach.name);
+        w.u8(ach.unlocked);
     }
 
-    file << jsonData.dump(4);
+    w.u32(Snapshot::checksum(data.data(), data.size()));
+
+    std::string tempPath = tempPathFor(PROGRESS_SNAPSHOT);
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
     file.close();
+    if (!file) return false;
+    return std::rename(tempPath.c_str(), PROGRESS_SNAPSHOT.c_str()) == 0;
 }
 
-// Check if an achievement should be unlocked
-void Achievements::checkAchievements(std::unique_ptr<Player>& humanPlayer, std::unique_ptr<Player>& aiPlayer, int winningPoints) {
-    int playerScore = humanPlayer->getHardPoints();  // Retrieve player's score
-    int aiScore = aiPlayer->getHardPoints();         // Retrieve AI's score
+bool readProgressSnapshot() {
+    std::ifstream file(PROGRESS_SNAPSHOT, std::ios::binary);
+    if (!file.is_open()) return false;
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 
-    // Check for "By the Skin of Your Teeth" achievement
-    if (!achievements[0].unlocked && (playerScore - aiScore) <= 100 && (playerScore > aiScore)) {
-        achievements[0].unlocked = true;
+    size_t headerSize = sizeof(SNAPSHOT_MAGIC) + sizeof(SNAPSHOT_VERSION);
+    if (data.size() < headerSize + sizeof(uint32_t) || std::memcmp(data.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        return false;
     }
+    size_t body = data.size() - sizeof(uint32_t);
+    ByteReader tail{data, body, true};
+    if (tail.u32() != Snapshot::checksum(data.data(), body)) return false;
+    data.resize(body);      // So reading the body cannot run into the checksum
+
+    ByteReader r{data, sizeof(SNAPSHOT_MAGIC), true};
+    if (r.u16() != SNAPSHOT_VERSION) return false;
 
-    // Check for "Dominating" achievement (winning with at least double the AI's score)
-    if (!achievements[1].unlocked && playerScore >= aiScore * 2) {
-        achievements[1].unlocked = true;
+    uint16_t statCount = r.u16();
+    for (int i = 0; i < statCount && r.ok; ++i) {
+        std::string name = r.str();
+        int32_t count = r.i32();
+        auto it = statistics.find(name);
+        if (r.ok && it != statistics.end()) it->second.count = count;
     }
 
-    // Retrieve the player's score history
-    const std::vector<std::pair<int, bool>>& playerHistory = humanPlayer->getHistory();
-    // Retrieve the AI's score history
-    //const std::vector<std::pair<int, bool>>& aiHistory = aiPlayer->getHistory();
+    uint16_t achCount = r.u16();
+    for (int i = 0; i < achCount && r.ok; ++i) {
+        std::string name = r.str();
+        bool unlocked = r.u8();
+        for (auto& ach : achievements) {
+            if (r.ok && ach.name == name) ach.unlocked = unlocked;
+        }
+    }
+    return r.ok;
+}
 
-    // Ensure there are at least 2 historical entries before accessing the second-most recent score
-    int previousScore = (playerHistory.size() >= 2) ? playerHistory[playerHistory.size() - 2].first : playerScore;
+// Totals from the files on disk: the snapshot, or the old progress.json
+void seedFromDisk() {
+    if (!readProgressSnapshot()) {
+        importProgressJson();
+    }
+}
+
+// Copy the live totals into statistics and achievements
+void refreshFromSegment() {
+    for (auto& stat : statistics) {
+        stat.second.count = sharedStats.get(statisticSlots[stat.first]);
+    }
+    for (auto& ach : achievements) {
+        ach.unlocked = sharedStats.isUnlocked(achievementSlots[ach.name]);
+    }
+}
+
+}
+
+
+
+// Attach to the shared totals; the first instance to create them seeds them from disk
+void Achievements::loadProgress() {
+    if (progressLoaded) return;
+    progressLoaded = true;
+
+    engine.setRules(AchievementEngine::loadRules(ACHIEVEMENT_RULES));
+    achievements.clear();
+    for (const auto& rule : engine.getRules()) {
+        achievements.push_back({rule.name, rule.description, false});
+    }
+
+    bool seeded = false;
+    sharedStats.open(PROGRESS_SEGMENT, [&seeded](SharedStats& segment, bool created) {
+        if (created) {
+            seedFromDisk();
+            seeded = true;
+        }
+        for (const auto& stat : statistics) {
+            statisticSlots[stat.first] = segment.registerStatistic(stat.first, created ? stat.second.count : 0);
+        }
+        for (const auto& ach : achievements) {
+            achievementSlots[ach.name] = segment.registerAchievement(ach.name, created && ach.unlocked);
+        }
+    });
+    refreshFromSegment();
+    persistedChanges = sharedStats.getChangeCount();
+    lastPersist = std::chrono::steady_clock::now();
 
-    // Check for "Comeback King" achievement (winning despite a large deficit)
-    if (!achievements[2].unlocked && (aiScore - previousScore >= 500) && (playerScore > aiScore) && (aiScore > winningPoints)){
-        achievements[2].unlocked = true;
+    // A snapshot straight away, so totals seeded from progress.json need not be migrated again
+    if (seeded) {
+        compactProgress();
+    }
+}
+
+// Changes are live in the shared segment as they happen; this persists them to disk,
+// at most once per PERSIST_INTERVAL and only if something changed
+void Achievements::saveProgress() {
+    loadProgress();
+    if (sharedStats.getChangeCount() != persistedChanges &&
+        std::chrono::steady_clock::now() - lastPersist >= PERSIST_INTERVAL) {
+        compactProgress();
+    }
+}
+
+// Flushes the segment and writes the snapshot (plus the progress.json export) in the background
+void Achievements::compactProgress() {
+    loadProgress();
+    if (compactor.running) return;
+    if (compactor.worker.joinable()) compactor.worker.join();
+
+    persistedChanges = sharedStats.getChangeCount();
+    lastPersist = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(progressMutex);
+    refreshFromSegment();
+    std::unordered_map<std::string, Statistic> statsCopy = statistics;
+    std::vector<Achievement> achievementsCopy = achievements;
+    lock.unlock();
+
+    compactor.running = true;
+    compactor.worker = std::thread([statsCopy, achievementsCopy]() {
+        sharedStats.sync();
+        writeProgressSnapshot(statsCopy, achievementsCopy);
+        writeProgressJson(statsCopy, achievementsCopy);
+        compactor.running = false;
+    });
+}
+
+// Write progress.json for anything that reads the old format
+void Achievements::exportProgress() {
+    loadProgress();
+    std::lock_guard<std::mutex> lock(progressMutex);
+    refreshFromSegment();
+    writeProgressJson(statistics, achievements);
+}
+
+void Achievements::unlock(Achievement& ach) {
+    std::lock_guard<std::mutex> lock(progressMutex);
+    ach.unlocked = true;
+    auto it = achievementSlots.find(ach.name);
+    if (it != achievementSlots.end()) sharedStats.unlock(it->second);
+}
+
+// Feed a game event to the achievement rules; also counts games and wins against the AI
+void Achievements::onGameEvent(const GameEvent& event) {
+    loadProgress();
+
+    engine.onEvent(event, [](const std::string& name) {
+        for (auto& ach : achievements) {
+            if (ach.name == name) unlock(ach);
+        }
+    });
+
+    if (event.type == EVENT_GAME_END && !event.opponentType.empty()) {
+        updateStatistics("Total number of Games against AI");
+        if (event.scores[0] > event.scores[1]) {
+            updateStatistics("Total Wins against AI");
+            auto it = winStatisticByAIType.find(event.opponentType);
+            if (it != winStatisticByAIType.end()) {
+                updateStatistics(it->second);
+            }
+        }
     }
 }
 
 // Update statistics
-void Achievements::updateStatistics(const std::string& key) {
-    if (statistics.find(key) != statistics.end()) {
-        statistics[key].count++;
+void Achievements::updateStatistics(const std::string& key, int amount) {
+    loadProgress();
+    std::lock_guard<std::mutex> lock(progressMutex);
+    auto it = statisticSlots.find(key);
+    if (it != statisticSlots.end()) {
+        sharedStats.add(it->second, amount);
     } else {
         std::cerr << "Error: Statistic key '" << key << "' not found.\n";
     }
 }
 
 
+
 std::vector<Achievement> Achievements::getAchievements() {
-    loadProgress();  // Ensure the latest data is loaded
+    loadProgress();  // Ensure the data is loaded (only reads the files once)
+    std::lock_guard<std::mutex> lock(progressMutex);
+    refreshFromSegment();
     return achievements;
 }
 
 // Retrieve updated statistics
 std::unordered_map<std::string, Statistic> Achievements::getStatistics() {
-    loadProgress();  // Ensure the latest data is loaded
+    loadProgress();  // Ensure the data is loaded (only reads the files once)
+    std::lock_guard<std::mutex> lock(progressMutex);
+    refreshFromSegment();
     return statistics;
 }
\ No newline at end of file
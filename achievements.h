@@ -9,6 +9,9 @@
 //For Players
 #include "players.h"
 
+//For Game Events
+#include "events.h"
+
 
 struct Achievement {
     std::string name;
@@ -25,12 +28,17 @@ class Achievements {
 public:
     static void loadProgress();
     static void saveProgress();
-    void checkAchievements(std::unique_ptr<Player>& humanPlayer, std::unique_ptr<Player>& aiPlayer, int winningPoints);
-    static void updateStatistics(const std::string& key);
+    static void compactProgress();
+    static void exportProgress();
+    static void onGameEvent(const GameEvent& event);
+    static void updateStatistics(const std::string& key, int amount = 1);
 
     // Retrieval functions
     static std::vector<Achievement> getAchievements();
     static std::unordered_map<std::string, Statistic> getStatistics();
+
+private:
+    static void unlock(Achievement& ach);
 };
 
 extern std::vector<Achievement> achievements;
@@ -0,0 +1,204 @@
+#include "advisor.h"
+#include "game.h"
+#include "players.h"
+#include "regret.h"
+#include "rules.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <deque>
+#include <algorithm>
+
+namespace {
+
+// Rolls kept before the oldest are dropped; a game makes a few hundred
+const size_t MAX_CACHED = 4096;
+// Requests waiting for the worker; older ones are for rolls long gone
+const size_t MAX_PENDING = 8;
+
+struct KeyHash {
+    size_t operator()(const AdviceKey& key) const {
+        uint64_t hash = 0;
+        for (int face = 1; face <= 6; ++face) hash = hash * 7 + key.faces[face];
+        hash = hash * 1000003 + key.turnPoints;
+        hash = hash * 1000003 + key.ownScore;
+        hash = hash * 1000003 + key.opponentScore;
+        hash = hash * 1000003 + key.target;
+        return static_cast<size_t>(hash * 4 + key.zilches);
+    }
+};
+
+std::mutex mutex;
+std::condition_variable wake;
+std::thread worker;
+bool running = false;
+std::deque<AdviceKey> pending;
+std::deque<std::function<void()>> jobs;
+AdviceKey working;                      // Taken off pending and being worked out
+std::unordered_map<AdviceKey, Advice, KeyHash> cache;
+std::deque<AdviceKey> cacheOrder;       // Oldest first, for dropping
+
+void run() {
+    TurnSolver::get();      // Solved here so the first hint is the only one that waits for it
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [] { return !running || !pending.empty() || !jobs.empty(); });
+        if (!running) return;
+        // Hints first, as someone is looking at the roll
+        if (pending.empty()) {
+            std::function<void()> job = std::move(jobs.front());
+            jobs.pop_front();
+            lock.unlock();
+            job();
+            lock.lock();
+            continue;
+        }
+        AdviceKey key = pending.back();
+        pending.pop_back();
+        if (cache.count(key)) continue;
+
+        working = key;
+        lock.unlock();
+        Advice advice = Advisor::compute(key);
+        lock.lock();
+        working = AdviceKey();
+
+        if (cache.size() >= MAX_CACHED) {
+            cache.erase(cacheOrder.front());
+            cacheOrder.pop_front();
+        }
+        cache.emplace(key, advice);
+        cacheOrder.push_back(key);
+    }
+}
+
+// With the lock held; the latest key goes first
+void enqueue(const AdviceKey& key) {
+    if (!running || cache.count(key) || key == working) return;
+    auto queued = std::find(pending.begin(), pending.end(), key);
+    if (queued != pending.end()) pending.erase(queued);
+    else if (pending.size() >= MAX_PENDING) pending.pop_front();
+    pending.push_back(key);
+    wake.notify_one();
+}
+
+}
+
+
+bool AdviceKey::isValid() const {
+    int dice = 0;
+    for (int face = 1; face <= 6; ++face) dice += faces[face];
+    return dice > 0;
+}
+
+bool AdviceKey::operator==(const AdviceKey& other) const {
+    for (int face = 1; face <= 6; ++face) {
+        if (faces[face] != other.faces[face]) return false;
+    }
+    return turnPoints == other.turnPoints && ownScore == other.ownScore && opponentScore == other.opponentScore &&
+           target == other.target && zilches == other.zilches;
+}
+
+void Advisor::start() {
+    if (running) return;
+    running = true;
+    worker = std::thread(run);
+}
+
+void Advisor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_one();
+    if (worker.joinable()) worker.join();
+
+    // Nothing else will run them now
+    std::deque<std::function<void()>> left;
+    left.swap(jobs);
+    for (std::function<void()>& job : left) job();
+}
+
+AdviceKey Advisor::keyFor(Game& game) {
+    AdviceKey key;
+    int current = game.getCurrentPlayer();
+    Player& self = *game.getPlayers()[current];
+    for (const Dice& die : game.getDice()) {
+        if (!die.held) key.faces[die.value]++;
+    }
+    key.turnPoints = self.getSoftPoints();
+    key.ownScore = self.getHardPoints();
+    key.opponentScore = game.getPlayers()[1 - current]->getHardPoints();
+    key.target = game.getWinConditionPoints();
+    key.zilches = self.getZilches();
+    return key;
+}
+
+void Advisor::request(const AdviceKey& key) {
+    if (!key.isValid()) return;
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (lock.owns_lock()) enqueue(key);
+}
+
+bool Advisor::lookup(const AdviceKey& key, Advice& advice) {
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock()) return false;
+    auto it = cache.find(key);
+    if (it == cache.end()) {
+        // In case request() found the lock taken and the key never got queued
+        if (key.isValid()) enqueue(key);
+        return false;
+    }
+    advice = it->second;
+    return true;
+}
+
+void Advisor::post(std::function<void()> job) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!running) {
+        lock.unlock();
+        job();
+        return;
+    }
+    jobs.push_back(std::move(job));
+    lock.unlock();
+    wake.notify_one();
+}
+
+// The same rating the regret analyzer gives the best choice
+Advice Advisor::compute(const AdviceKey& key) {
+    const TurnSolver& solver = TurnSolver::get();
+    Advice advice;
+    int dice = 0;
+    int faceCounts[7] = {};
+    for (int face = 1; face <= 6; ++face) {
+        faceCounts[face] = key.faces[face];
+        dice += key.faces[face];
+    }
+    bool penalty = key.zilches >= 2;
+    advice.lastTurn = key.opponentScore >= key.target;
+    int goal = key.opponentScore - key.ownScore + 1;
+
+    double best = 0;
+    bool first = true;
+    for (const HoldChoice& choice : holdChoices(offeredHolds(faceCounts))) {
+        int turnPoints = key.turnPoints + choice.points;
+        double value = advice.lastTurn ? solver.holdChance(turnPoints, dice - choice.dice, goal)
+                                       : solver.holdValue(turnPoints, dice - choice.dice, penalty);
+        if (!first && value <= best) continue;
+        first = false;
+        best = value;
+
+        advice.hold = choice.mask;
+        advice.diceLeft = dice - choice.dice <= 0 ? NUM_DICE : dice - choice.dice;
+        double roll = advice.lastTurn ? solver.rollChance(turnPoints, advice.diceLeft, goal)
+                                      : solver.rollValue(turnPoints, advice.diceLeft, penalty);
+        double bank = advice.lastTurn ? (turnPoints >= goal ? 1 : 0) : turnPoints;
+        advice.bank = turnPoints >= MIN_BANK_POINTS && bank >= roll;
+        advice.expectedPoints = advice.bank ? turnPoints : solver.rollValue(turnPoints, advice.diceLeft, penalty);
+        advice.zilchRisk = advice.bank ? 0 : solver.zilchChance(advice.diceLeft);
+        advice.winChance = advice.lastTurn ? value : 0;
+    }
+    return advice;
+}
@@ -0,0 +1,60 @@
+#ifndef ADVISOR_H
+#define ADVISOR_H
+
+#include <cstdint>
+#include <functional>
+
+class Game;
+
+// Everything the best play from a roll depends on
+struct AdviceKey {
+    uint8_t faces[7] = {};      // Unheld dice showing each face, faces[1] to [6]
+    int turnPoints = 0;         // Soft points before holding any of them
+    int ownScore = 0;
+    int opponentScore = 0;
+    int target = 0;
+    uint8_t zilches = 0;
+
+    bool isValid() const;
+    bool operator==(const AdviceKey& other) const;
+};
+
+struct Advice {
+    uint64_t hold = 0;          // Hold mask of the best buttons, 0 if nothing scores
+    bool bank = false;          // Bank after holding them rather than rolling on
+    int diceLeft = 0;           // Dice the next roll would use
+    double expectedPoints = 0;  // Banked by the end of the turn with best play
+    double zilchRisk = 0;       // Of the next roll, 0 when banking
+    bool lastTurn = false;      // The opponent has reached the target
+    double winChance = 0;       // Of passing them, on the last turn
+};
+
+// Hints for people playing: works out the best hold and whether to bank on a
+// worker thread, from TurnSolver, and keeps the answers by AdviceKey.
+// Nothing on the game thread ever waits for it: request() and lookup() only
+// try the lock, and a hint that is not ready yet is simply not shown.
+// Other slow work the game thread hands off, like rating a finished game,
+// runs on the same worker once no hint is waiting.
+class Advisor {
+public:
+    static void start();
+    // Finishes any work posted first
+    static void stop();
+
+    // The roll just made, before anything is held
+    static AdviceKey keyFor(Game& game);
+
+    // Queues the key unless its advice is known; the latest request goes first
+    static void request(const AdviceKey& key);
+    // False until the worker has it; queues the key again if it got lost,
+    // so asking every frame is enough for a request made while the lock was busy
+    static bool lookup(const AdviceKey& key, Advice& advice);
+
+    // Runs job on the worker, or straight away if it is not running
+    static void post(std::function<void()> job);
+
+    // The work itself, on whatever thread calls it
+    static Advice compute(const AdviceKey& key);
+};
+
+#endif
@@ -0,0 +1,691 @@
+#include "ai_profile.h"
+#include "rules.h"
+#include <fstream>
+#include <memory>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+const int FACES = 6;
+const int MAX_DICE = 6;
+// Sets of up to six dice, counting only how many of each face
+const int DICE_SETS = 924;
+
+// Built-in hand order, used by profiles that do not give their own
+const std::vector<std::vector<std::string>> twoButtonCombos = {
+    {"Three 1s", "Three 2s"},
+    {"Three 1s", "Three 3s"},
+    {"Three 1s", "Three 4s"},
+    {"Three 1s", "Three 5s"},
+    {"Three 1s", "Three 6s"},
+
+    {"Three 2s", "Three 1s"},
+    {"Three 2s", "Three 3s"},
+    {"Three 2s", "Three 4s"},
+    {"Three 2s", "Three 5s"},
+    {"Three 2s", "Three 6s"},
+    
+    {"Three 3s", "Three 1s"},
+    {"Three 3s", "Three 2s"},
+    {"Three 3s", "Three 4s"},
+    {"Three 3s", "Three 5s"},
+    {"Three 3s", "Three 6s"},
+
+    {"Three 4s", "Three 1s"},
+    {"Three 4s", "Three 2s"},
+    {"Three 4s", "Three 3s"},
+    {"Three 4s", "Three 5s"},
+    {"Three 4s", "Three 6s"},
+
+    {"Three 5s", "Three 1s"},
+    {"Three 5s", "Three 2s"},
+    {"Three 5s", "Three 3s"},
+    {"Three 5s", "Three 4s"},
+    {"Three 5s", "Three 6s"},
+
+    {"Three 6s", "Three 1s"},
+    {"Three 6s", "Three 2s"},
+    {"Three 6s", "Three 3s"},
+    {"Three 6s", "Three 4s"},
+    {"Three 6s", "Three 5s"},
+
+
+    {"Five 6s", "Single 1"},
+    {"Five 5s", "Single 1"},
+    {"Five 4s", "Single 1"},
+    {"Five 3s", "Single 1"},
+    {"Five 2s", "Single 1"},
+
+
+    {"Five 1s", "Single 5"},
+    {"Five 6s", "Single 5"},
+    {"Five 4s", "Single 5"},
+    {"Five 3s", "Single 5"},
+    {"Five 2s", "Single 5"},
+
+
+    {"Four 6s", "Double 1"},
+    {"Four 5s", "Double 1"},
+    {"Four 4s", "Double 1"},
+    {"Four 3s", "Double 1"},
+    {"Four 2s", "Double 1"},
+
+
+    {"Four 6s", "Single 1"},
+    {"Four 5s", "Single 1"},
+    {"Four 4s", "Single 1"},
+    {"Four 3s", "Single 1"},
+    {"Four 2s", "Single 1"},
+    
+
+    {"Four 1s", "Double 5"},
+    {"Four 6s", "Double 5"},
+    {"Four 4s", "Double 5"},
+    {"Four 3s", "Double 5"},
+    {"Four 2s", "Double 5"},
+
+
+    {"Four 1s", "Single 5"},
+    {"Four 6s", "Single 5"},
+    {"Four 4s", "Single 5"},
+    {"Four 3s", "Single 5"},
+    {"Four 2s", "Single 5"},
+
+
+    {"Three 6s", "Double 1"},
+    {"Three 5s", "Double 1"},
+    {"Three 4s", "Double 1"},
+    {"Three 3s", "Double 1"},
+    {"Three 2s", "Double 1"},
+
+
+    {"Three 6s", "Single 1"},
+    {"Three 5s", "Single 1"},
+    {"Three 4s", "Single 1"},
+    {"Three 3s", "Single 1"},
+    {"Three 2s", "Single 1"},
+
+
+    {"Three 1s", "Double 5"},
+    {"Three 6s", "Double 5"},
+    {"Three 4s", "Double 5"},
+    {"Three 3s", "Double 5"},
+    {"Three 2s", "Double 5"},
+    
+
+    {"Three 1s", "Single 5"},
+    {"Three 6s", "Single 5"},
+    {"Three 4s", "Single 5"},
+    {"Three 3s", "Single 5"},
+    {"Three 2s", "Single 5"},
+
+    
+    {"Double 1", "Double 5"},
+    {"Double 1", "Single 5"},
+    {"Single 1", "Double 5"},
+    {"Single 1", "Single 5"}
+};
+
+const std::vector<std::vector<std::string>> threeButtonCombos = {
+    {"Four 2s", "Single 1", "Single 5"},
+    {"Four 3s", "Single 1", "Single 5"},
+    {"Four 4s", "Single 1", "Single 5"},
+    {"Four 6s", "Single 1", "Single 5"},
+
+    {"Three 2s", "Double 1", "Single 5"},
+    {"Three 3s", "Double 1", "Single 5"},
+    {"Three 4s", "Double 1", "Single 5"},
+    {"Three 6s", "Double 1", "Single 5"},
+    
+    {"Three 2s", "Single 1", "Double 5"},
+    {"Three 3s", "Single 1", "Double 5"},
+    {"Three 4s", "Single 1", "Double 5"},
+    {"Three 6s", "Single 1", "Double 5"},
+
+    {"Three 2s", "Single 1", "Single 5"},
+    {"Three 3s", "Single 1", "Single 5"},
+    {"Three 4s", "Single 1", "Single 5"},
+    {"Three 6s", "Single 1", "Single 5"},
+};
+
+const std::vector<std::string> priorityLabels = {
+    "Six 1s", "Six 6s", "Six 5s", "Six 4s", "Six 3s", "Six 2s",
+    "Five 1s", "Five 6s", "Five 5s", "Five 4s", "Five 3s", "Five 2s",
+    "Four 1s", "Four 6s", "Four 5s", "Four 4s", "Four 3s", "Four 2s",
+    "Three 1s", "Three 6s", "Three 5s", "Three 4s", "Three 3s",
+    "Three 2s", "Double 1", 
+    "Single 1", "Double 5", 
+    "Single 5"
+};
+
+const std::vector<std::string> specialLabels = {"Nothing", "Straight", "Three Pairs"};
+
+// Numbers every set of up to six dice from 0 to DICE_SETS - 1: the sets of
+// n dice follow the smaller ones, ranked by where the face boundaries fall
+int diceSetIndex(const int counts[7]) {
+    static const int SMALLER_SETS[MAX_DICE + 1] = {0, 1, 7, 28, 84, 210, 462};
+    static const int CHOOSE[11][6] = {
+        {1}, {1, 1}, {1, 2, 1}, {1, 3, 3, 1}, {1, 4, 6, 4, 1}, {1, 5, 10, 10, 5, 1},
+        {1, 6, 15, 20, 15, 6}, {1, 7, 21, 35, 35, 21}, {1, 8, 28, 56, 70, 56},
+        {1, 9, 36, 84, 126, 126}, {1, 10, 45, 120, 210, 252}
+    };
+    int dice = 0;
+    for (int face = 1; face <= FACES; ++face) dice += counts[face];
+
+    int index = 0, boundary = -1;
+    for (int face = 1; face < FACES; ++face) {
+        boundary += counts[face] + 1;
+        index += CHOOSE[boundary][face];
+    }
+    return SMALLER_SETS[dice] + index;
+}
+
+template <typename Visit>
+void forEachDiceSet(int counts[7], int face, int dice, const Visit& visit) {
+    if (face > FACES) {
+        visit(dice);
+        return;
+    }
+    for (int n = 0; dice + n <= MAX_DICE; ++n) {
+        counts[face] = n;
+        forEachDiceSet(counts, face + 1, dice + n, visit);
+    }
+    counts[face] = 0;
+}
+
+void addBounds(std::vector<int>& bounds, int min, int max) {
+    if (min != INT_MIN) bounds.push_back(min);
+    if (max != INT_MAX) bounds.push_back(max + 1);
+}
+
+int bucket(const std::vector<int>& bounds, int value) {
+    return std::upper_bound(bounds.begin(), bounds.end(), value) - bounds.begin();
+}
+
+// A value that falls in the bucket, to test the rules with
+int bucketValue(const std::vector<int>& bounds, int bucket) {
+    if (bucket > 0) return bounds[bucket - 1];
+    return bounds.empty() ? 0 : bounds[0] - 1;
+}
+
+long long combination(int n, int r) {
+    if (r > n) return 0;
+    if (r == 0 || r == n) return 1;
+
+    long long result = 1;
+    for (int i = 0; i < r; ++i) {
+        result *= (n - i);
+        result /= (i + 1);
+    }
+    return result;
+}
+
+std::vector<std::string> splitHand(const std::string& text) {
+    std::vector<std::string> labels;
+    size_t start = 0;
+    while (true) {
+        size_t plus = text.find(" + ", start);
+        labels.push_back(text.substr(start, plus - start));
+        if (plus == std::string::npos) break;
+        start = plus + 3;
+    }
+    return labels;
+}
+
+std::string joinHand(const std::vector<std::string>& labels) {
+    std::string text;
+    for (size_t i = 0; i < labels.size(); ++i) {
+        text += (i == 0 ? "" : " + ") + labels[i];
+    }
+    return text;
+}
+
+void readLimit(const nlohmann::json& entry, const std::string& name, int& min, int& max) {
+    if (entry.contains(name)) {
+        min = max = entry.value(name, 0);
+    }
+    min = entry.value("min_" + name, min);
+    max = entry.value("max_" + name, max);
+}
+
+void writeLimit(nlohmann::ordered_json& entry, const std::string& name, int min, int max, int anyMin, int anyMax) {
+    if (min == max) {
+        entry[name] = min;
+        return;
+    }
+    if (min != anyMin) entry["min_" + name] = min;
+    if (max != anyMax) entry["max_" + name] = max;
+}
+
+double rounded(float value) {
+    return std::round(value * 1000.0) / 1000.0;
+}
+
+std::vector<AIProfile> parseProfiles(const nlohmann::json& jsonData, const std::string& source) {
+    std::vector<AIProfile> parsed;
+    if (!jsonData.contains("profiles") || !jsonData["profiles"].is_array()) return parsed;
+
+    for (const auto& entry : jsonData["profiles"]) {
+        AIProfile profile;
+        profile.type = entry.value("type", "");
+        profile.name = entry.value("name", profile.type);
+        profile.rollDecay = entry.value("roll_decay", 0.0f);
+        profile.model = entry.value("model", "");
+        bool hasRules = entry.contains("bank") && entry["bank"].is_array();
+        if (profile.type.empty() || (!hasRules && profile.model.empty())) {
+            std::cerr << "Error: Skipping AI profile '" << profile.type << "' in " << source << " with no type or bank rules.\n";
+            continue;
+        }
+        if (!profile.model.empty()) {
+            auto model = std::make_shared<ValueModel>();
+            if (!model->load(profile.model)) {
+                std::cerr << "Error: Skipping AI profile '" << profile.type << "': cannot read the model " << profile.model << "\n";
+                continue;
+            }
+            profile.valueModel = model;
+        }
+
+        if (entry.contains("hands")) {
+            const auto& hands = entry["hands"];
+            profile.combos = hands.value("combos", "any") == "exact" ? COMBOS_EXACT : COMBOS_ANY;
+            profile.maxChanceDrop = hands.value("max_chance_drop", -1.0f);
+            if (hands.contains("order") && hands["order"].is_array()) {
+                for (const auto& hand : hands["order"]) {
+                    if (hand.is_string()) profile.handOrder.push_back(splitHand(hand.get<std::string>()));
+                }
+            }
+        }
+
+        for (const auto& ruleEntry : entry.value("bank", nlohmann::json::array())) {
+            BankRule rule;
+            readLimit(ruleEntry, "rerolls", rule.minRerolls, rule.maxRerolls);
+            readLimit(ruleEntry, "held", rule.minHeld, rule.maxHeld);
+            readLimit(ruleEntry, "points", rule.minPoints, rule.maxPoints);
+            readLimit(ruleEntry, "lead", rule.minLead, rule.maxLead);
+            rule.risk = ruleEntry.value("risk", -1.0f);
+            rule.safeBelow = ruleEntry.value("safe_below", -1.0f);
+            if ((rule.risk < 0) == (rule.safeBelow < 0)) {
+                std::cerr << "Error: Skipping a bank rule of '" << profile.type << "' that needs one of risk or safe_below.\n";
+                continue;
+            }
+            profile.bankRules.push_back(rule);
+        }
+
+        auto tables = std::make_shared<ProfileTables>();
+        std::string error;
+        if (!tables->compile(profile, error)) {
+            std::cerr << "Error: Skipping AI profile '" << profile.type << "': " << error << "\n";
+            continue;
+        }
+        profile.tables = tables;
+        parsed.push_back(profile);
+    }
+    return parsed;
+}
+
+// The original three personalities, used when assets/ai_profiles.json is missing
+const char* BUILT_IN_PROFILES = R"({
+    "profiles": [
+        {
+            "type": "aggressive",
+            "name": "Aggressive AI",
+            "hands": {"combos": "any"},
+            "bank": [
+                {"min_points": 2000, "risk": 0},
+                {"rerolls": 0, "held": 4, "min_points": 800, "risk": 75},
+                {"rerolls": 0, "held": 5, "min_points": 600, "risk": 60},
+                {"rerolls": 0, "held": 5, "min_points": 301, "risk": 55},
+                {"rerolls": 0, "min_held": 4, "max_points": 300, "risk": 70},
+                {"rerolls": 0, "risk": 65},
+                {"rerolls": 1, "min_held": 4, "min_points": 1000, "risk": 22},
+                {"rerolls": 1, "risk": 35},
+                {"held": 1, "risk": 35},
+                {"held": 2, "risk": 25},
+                {"held": 3, "risk": 15},
+                {"risk": 8}
+            ]
+        },
+        {
+            "type": "cautious",
+            "name": "Cautious AI",
+            "hands": {"combos": "exact"},
+            "bank": [
+                {"min_points": 1500, "risk": 0},
+                {"rerolls": 0, "held": 3, "risk": 88},
+                {"rerolls": 0, "held": 4, "min_points": 500, "risk": 60},
+                {"rerolls": 0, "held": 5, "min_points": 301, "risk": 55},
+                {"rerolls": 0, "min_held": 4, "max_points": 300, "risk": 70},
+                {"rerolls": 0, "min_points": 1001, "risk": 0},
+                {"rerolls": 0, "risk": 55},
+                {"rerolls": 1, "max_points": 499, "risk": 100},
+                {"rerolls": 1, "min_points": 1001, "risk": 15},
+                {"rerolls": 1, "held": 1, "max_points": 500, "risk": 65},
+                {"rerolls": 1, "held": 1, "risk": 58},
+                {"rerolls": 1, "held": 2, "max_points": 599, "risk": 55},
+                {"rerolls": 1, "held": 2, "risk": 50},
+                {"rerolls": 1, "held": 3, "max_points": 799, "risk": 42},
+                {"rerolls": 1, "held": 3, "risk": 33},
+                {"rerolls": 1, "min_held": 4, "risk": 0},
+                {"rerolls": 1, "risk": 35},
+                {"max_points": 1199, "risk": 0},
+                {"held": 1, "risk": 18},
+                {"held": 2, "risk": 12},
+                {"risk": 0}
+            ]
+        },
+        {
+            "type": "adaptive",
+            "name": "Adaptive AI",
+            "hands": {"combos": "exact", "max_chance_drop": 0.35},
+            "roll_decay": 0.03,
+            "bank": [
+                {"max_lead": -1000, "safe_below": 0.3},
+                {"max_lead": -500, "safe_below": 0.4},
+                {"max_lead": 0, "safe_below": 0.5},
+                {"min_lead": 1000, "safe_below": 0.8},
+                {"safe_below": 0.7}
+            ]
+        },
+        {
+            "type": "learned",
+            "name": "Learned AI",
+            "model": "assets/learned_ai.bin"
+        }
+    ]
+})";
+
+std::vector<AIProfile>& loadedProfiles() {
+    static std::vector<AIProfile> profiles = parseProfiles(nlohmann::json::parse(BUILT_IN_PROFILES), "the built-in profiles");
+    return profiles;
+}
+
+}
+
+
+////////////// PROFILE //////////////
+std::vector<AIParam> AIProfile::getTunables() const {
+    std::vector<AIParam> tunables;
+    bool usesChance = false;
+    for (size_t i = 0; i < bankRules.size(); ++i) {
+        const BankRule& rule = bankRules[i];
+        std::string prefix = "bank." + std::to_string(i) + ".";
+        if (rule.risk >= 0) {
+            tunables.push_back({prefix + "risk", rule.risk, 0, 100});
+        } else {
+            tunables.push_back({prefix + "safe_below", rule.safeBelow, 0, 1});
+            usesChance = true;
+        }
+        if (rule.minPoints != INT_MIN) tunables.push_back({prefix + "min_points", float(rule.minPoints), 0, 5000});
+        if (rule.maxPoints != INT_MAX) tunables.push_back({prefix + "max_points", float(rule.maxPoints), 0, 5000});
+        if (rule.minLead != INT_MIN) tunables.push_back({prefix + "min_lead", float(rule.minLead), -5000, 5000});
+        if (rule.maxLead != INT_MAX) tunables.push_back({prefix + "max_lead", float(rule.maxLead), -5000, 5000});
+    }
+    if (usesChance) tunables.push_back({"roll_decay", rollDecay, 0, 0.2f});
+    if (combos == COMBOS_EXACT && maxChanceDrop >= 0) tunables.push_back({"max_chance_drop", maxChanceDrop, 0, 1});
+    return tunables;
+}
+
+void AIProfile::setTunables(const std::vector<float>& values) {
+    size_t next = 0;
+    auto take = [&]() { return next < values.size() ? values[next++] : 0.0f; };
+    bool usesChance = false;
+    for (BankRule& rule : bankRules) {
+        if (rule.risk >= 0) {
+            rule.risk = take();
+        } else {
+            rule.safeBelow = take();
+            usesChance = true;
+        }
+        if (rule.minPoints != INT_MIN) rule.minPoints = std::lround(take());
+        if (rule.maxPoints != INT_MAX) rule.maxPoints = std::lround(take());
+        if (rule.minLead != INT_MIN) rule.minLead = std::lround(take());
+        if (rule.maxLead != INT_MAX) rule.maxLead = std::lround(take());
+    }
+    if (usesChance) rollDecay = take();
+    if (combos == COMBOS_EXACT && maxChanceDrop >= 0) maxChanceDrop = take();
+}
+
+
+////////////// TABLES //////////////
+bool ProfileTables::compile(const AIProfile& profile, std::string& error) {
+    // Bank decisions: every rule's limits split the scores into buckets that all decide alike
+    pointBounds.clear();
+    leadBounds.clear();
+    for (const BankRule& rule : profile.bankRules) {
+        addBounds(pointBounds, rule.minPoints, rule.maxPoints);
+        addBounds(leadBounds, rule.minLead, rule.maxLead);
+    }
+    for (std::vector<int>* bounds : {&pointBounds, &leadBounds}) {
+        std::sort(bounds->begin(), bounds->end());
+        bounds->erase(std::unique(bounds->begin(), bounds->end()), bounds->end());
+    }
+
+    bankTable.assign(STAGES * (MAX_DICE + 1) * (pointBounds.size() + 1) * (leadBounds.size() + 1), 100);
+    for (int stage = 0; stage < STAGES; ++stage) {
+        for (int held = 0; held <= MAX_DICE; ++held) {
+            for (size_t p = 0; p <= pointBounds.size(); ++p) {
+                for (size_t l = 0; l <= leadBounds.size(); ++l) {
+                    int points = bucketValue(pointBounds, p);
+                    int lead = bucketValue(leadBounds, l);
+                    for (const BankRule& rule : profile.bankRules) {
+                        if (stage < rule.minRerolls || stage > rule.maxRerolls || held < rule.minHeld || held > rule.maxHeld ||
+                            points < rule.minPoints || points > rule.maxPoints || lead < rule.minLead || lead > rule.maxLead) {
+                            continue;
+                        }
+                        int cutoff;
+                        if (rule.risk >= 0) {
+                            cutoff = std::min(100L, std::max(0L, std::lround(rule.risk)));
+                        } else {
+                            float chance = safeChance(MAX_DICE - held) - (stage + 1) * profile.rollDecay;
+                            cutoff = chance < rule.safeBelow ? 0 : 100;
+                        }
+                        bankTable[bankIndex(stage, held, p, l)] = cutoff;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // Hands: the choice for every set of dice that can be left to pick from
+    picks = profile.handOrder.empty() ? std::vector<std::vector<std::string>>() : profile.handOrder;
+    if (picks.empty()) {
+        for (const std::string& label : specialLabels) picks.push_back({label});
+        picks.insert(picks.end(), threeButtonCombos.begin(), threeButtonCombos.end());
+        picks.insert(picks.end(), twoButtonCombos.begin(), twoButtonCombos.end());
+        for (const std::string& label : priorityLabels) picks.push_back({label});
+    }
+
+    std::vector<uint64_t> needs(picks.size(), 0);
+    std::vector<int> dice(picks.size(), 0);
+    std::vector<bool> special(picks.size(), false);
+    for (size_t i = 0; i < picks.size(); ++i) {
+        for (const std::string& label : picks[i]) {
+            int id = holdButtonId(label), labelDice, points;
+            if (!holdButtonValue(id, labelDice, points)) {
+                error = "no hold button is labelled '" + label + "'";
+                return false;
+            }
+            needs[i] |= 1ULL << id;
+            dice[i] += labelDice;
+        }
+        special[i] = picks[i].size() == 1 &&
+                     std::find(specialLabels.begin(), specialLabels.end(), picks[i][0]) != specialLabels.end();
+    }
+
+    handTable.assign(DICE_SETS, -1);
+    int counts[7] = {};
+    forEachDiceSet(counts, 1, 0, [&](int remaining) {
+        uint64_t offered = offeredHolds(counts);
+        auto isOffered = [&](size_t i) { return (needs[i] & offered) == needs[i]; };
+        int choice = -1;
+
+        // Specials, and combos that are allowed to leave dice or use them all
+        for (size_t i = 0; i < picks.size() && choice < 0; ++i) {
+            bool combo = picks[i].size() > 1;
+            if (isOffered(i) && (special[i] || (combo && (profile.combos == COMBOS_ANY || dice[i] == remaining)))) {
+                choice = i;
+            }
+        }
+        // Else the combo that leaves the next roll the best chance, if close enough to now
+        if (choice < 0 && profile.combos == COMBOS_EXACT && profile.maxChanceDrop >= 0) {
+            float bestDrop = profile.maxChanceDrop;
+            for (size_t i = 0; i < picks.size(); ++i) {
+                if (picks[i].size() < 2 || !isOffered(i) || dice[i] > remaining) continue;
+                float drop = safeChance(remaining) - safeChance(remaining - dice[i]);
+                if (drop < bestDrop) {
+                    bestDrop = drop;
+                    choice = i;
+                }
+            }
+        }
+        // Else the first single hand offered
+        for (size_t i = 0; i < picks.size() && choice < 0; ++i) {
+            if (picks[i].size() == 1 && isOffered(i)) choice = i;
+        }
+        handTable[diceSetIndex(counts)] = choice;
+    });
+    return true;
+}
+
+int ProfileTables::bankIndex(int stage, int held, int pointBucket, int leadBucket) const {
+    return ((stage * (MAX_DICE + 1) + held) * (pointBounds.size() + 1) + pointBucket) * (leadBounds.size() + 1) + leadBucket;
+}
+
+int ProfileTables::bankCutoff(int rerolls, int held, int points, int lead) const {
+    int stage = std::min(std::max(rerolls, 0), STAGES - 1);
+    held = std::min(std::max(held, 0), MAX_DICE);
+    return bankTable[bankIndex(stage, held, bucket(pointBounds, points), bucket(leadBounds, lead))];
+}
+
+const std::vector<std::string>& ProfileTables::selectHands(const int faceCounts[7]) const {
+    static const std::vector<std::string> nothing;
+    int choice = handTable[diceSetIndex(faceCounts)];
+    return choice < 0 ? nothing : picks[choice];
+}
+
+float ProfileTables::safeChance(int remainingDice) {
+    float totalOutcomes = pow(6, remainingDice);
+    float favorableOutcomes = 0;
+
+    if (remainingDice == 5) {       // 98.6%
+        // 5-of-a-kind, 4-of-a-kind, 3-of-a-kind, Doubles, and At least one "1" or "5"
+        favorableOutcomes += 6;
+        favorableOutcomes += 6 * 5 * combination(5, 4);
+        favorableOutcomes += 6 * combination(5, 3) * 5 * 4;
+        favorableOutcomes += totalOutcomes - pow(4, remainingDice);
+
+        // Remove cases where three 1s or 5s were counted twice
+        favorableOutcomes -= 2 * combination(5, 3) * pow(4, 2);
+        // Remove cases where four 1s or 5s were counted multiple times
+        favorableOutcomes -= 2 * combination(5, 4) * 4;
+        // Remove cases where exactly two dice are 1s or 5s in a three-of-a-kind
+        favorableOutcomes -= 4 * combination(5, 2) * 2;
+        // Add back 5-of-a-kind cases (since they were subtracted too many times)
+        favorableOutcomes += 2;
+
+    } else if (remainingDice == 4) {    // 83.9%
+        // 4-of-a-kind, 3-of-a-kind, and At least one "1" or "5"
+        favorableOutcomes += 6;
+        favorableOutcomes += 6 * combination(4, 3) * 5;
+        favorableOutcomes += totalOutcomes - pow(4, 4);
+
+        // Remove cases where three 1s or 5s were counted twice
+        favorableOutcomes -= 2 * combination(4, 3) * 4;
+        // Remove cases where exactly two dice are 1s or 5s in a three-of-a-kind
+        favorableOutcomes -= 4 * combination(4, 2) * 2;
+        // Add back 4-of-a-kind cases (since they were subtracted too many times)
+        favorableOutcomes += 2;
+
+    } else if (remainingDice == 3) {    // 72.2%
+        // 3-of-a-kind, and At least one "1" or "5"
+        favorableOutcomes += 6;
+        favorableOutcomes += totalOutcomes - pow(4, 3);
+        // Remove cases where all three dice are 1s or 5s
+        favorableOutcomes -= 2;
+
+    } else if (remainingDice == 2) {    // 55.6%
+        favorableOutcomes += totalOutcomes - pow(4, 2);
+
+    } else if (remainingDice == 1) {    // 33.3%
+        favorableOutcomes += 2;
+
+    } else {
+        // Six dice always score, and no dice left means all six are rolled again
+        return 1.0;
+    }
+    return favorableOutcomes / totalOutcomes;
+}
+
+
+////////////// REGISTRY //////////////
+void AIProfiles::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return;
+
+    nlohmann::json jsonData = nlohmann::json::parse(file, nullptr, false);
+    std::vector<AIProfile> parsed;
+    if (!jsonData.is_discarded()) parsed = parseProfiles(jsonData, path);
+    if (parsed.empty()) {
+        std::cerr << "Error: " << path << " has no valid AI profiles, using the built-in ones.\n";
+        return;
+    }
+    loadedProfiles() = parsed;
+}
+
+const std::vector<AIProfile>& AIProfiles::all() {
+    return loadedProfiles();
+}
+
+const AIProfile* AIProfiles::find(const std::string& type) {
+    for (const AIProfile& profile : loadedProfiles()) {
+        if (profile.type == type) return &profile;
+    }
+    return nullptr;
+}
+
+std::string AIProfiles::toJson(const AIProfile& profile, double winRate, int games) {
+    nlohmann::ordered_json entry;
+    entry["type"] = profile.type;
+    entry["name"] = profile.name;
+    if (!profile.model.empty()) entry["model"] = profile.model;
+    if (winRate >= 0) {
+        entry["win_rate"] = std::round(winRate * 10000) / 10000;
+        entry["games"] = games;
+    }
+
+    nlohmann::ordered_json file;
+    file["profiles"] = nlohmann::ordered_json::array();
+    if (!profile.model.empty()) {
+        file["profiles"].push_back(entry);
+        return file.dump(4) + "\n";
+    }
+
+    nlohmann::ordered_json hands;
+    hands["combos"] = profile.combos == COMBOS_EXACT ? "exact" : "any";
+    if (profile.maxChanceDrop >= 0) hands["max_chance_drop"] = rounded(profile.maxChanceDrop);
+    if (!profile.handOrder.empty()) {
+        hands["order"] = nlohmann::ordered_json::array();
+        for (const auto& hand : profile.handOrder) hands["order"].push_back(joinHand(hand));
+    }
+    entry["hands"] = hands;
+    if (profile.rollDecay != 0) entry["roll_decay"] = rounded(profile.rollDecay);
+
+    entry["bank"] = nlohmann::ordered_json::array();
+    for (const BankRule& rule : profile.bankRules) {
+        nlohmann::ordered_json ruleEntry;
+        writeLimit(ruleEntry, "rerolls", rule.minRerolls, rule.maxRerolls, 0, INT_MAX);
+        writeLimit(ruleEntry, "held", rule.minHeld, rule.maxHeld, 0, MAX_DICE);
+        writeLimit(ruleEntry, "points", rule.minPoints, rule.maxPoints, INT_MIN, INT_MAX);
+        writeLimit(ruleEntry, "lead", rule.minLead, rule.maxLead, INT_MIN, INT_MAX);
+        if (rule.risk >= 0) ruleEntry["risk"] = std::lround(rule.risk);
+        else ruleEntry["safe_below"] = rounded(rule.safeBelow);
+        entry["bank"].push_back(ruleEntry);
+    }
+
+    file["profiles"].push_back(entry);
+    return file.dump(4) + "\n";
+}
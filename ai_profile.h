@@ -0,0 +1,107 @@
+#ifndef AI_PROFILE_H
+#define AI_PROFILE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <climits>
+#include <memory>
+#include "value_model.h"
+
+const std::string AI_PROFILES_FILE = "assets/ai_profiles.json";
+
+// One tunable number of an AI personality, with the range the tuner may search
+struct AIParam {
+    std::string name;
+    float value;    // The profile's own value
+    float min;
+    float max;
+};
+
+// One rule of a profile's bank decision, as described in assets/ai_profiles.json.
+// The first rule whose conditions all hold decides; limits are inclusive.
+struct BankRule {
+    int minRerolls = 0, maxRerolls = INT_MAX;   // Rolls this turn after the first
+    int minHeld = 0, maxHeld = 6;               // Dice held so far this turn
+    int minPoints = INT_MIN, maxPoints = INT_MAX; // Soft points
+    int minLead = INT_MIN, maxLead = INT_MAX;   // Own hard points minus the opponent's
+    float risk = -1;        // Banks when a percent roll (1 to 100) is above this: 0 always, 100 never
+    float safeBelow = -1;   // Or banks when the chance the remaining dice score, less rollDecay
+                            // for each roll this turn, is below this
+};
+
+enum ComboMode {
+    COMBOS_ANY,     // Takes the first combo offered
+    COMBOS_EXACT    // Only combos that use every remaining die
+};
+
+class ProfileTables;
+
+// An AI personality: how it picks hands and when it banks
+struct AIProfile {
+    std::string type;   // Saved with games, and what Game::addPlayer is given
+    std::string name;   // Shown in the menu and as the player's name
+    // A learned AI's weights file, which then decides everything instead of the rules
+    std::string model;
+    std::shared_ptr<const ValueModel> valueModel;
+    // Compiled when loaded and shared by every player of the profile as it is
+    std::shared_ptr<const ProfileTables> tables;
+    std::vector<BankRule> bankRules;
+    float rollDecay = 0;
+
+    // Hands to hold in order of preference, each one or more button labels;
+    // empty for the built-in order (specials, combos, then single hands)
+    std::vector<std::vector<std::string>> handOrder;
+    ComboMode combos = COMBOS_ANY;
+    // With COMBOS_EXACT: otherwise the combo that costs the next roll the least
+    // chance of scoring, if under this; below 0 never
+    float maxChanceDrop = -1;
+
+    // Every number the tuner may change, in a fixed order
+    std::vector<AIParam> getTunables() const;
+    void setTunables(const std::vector<float>& values);
+};
+
+// A profile compiled into flat tables, so each decision is a lookup.
+// Bank decisions are indexed by rerolls, dice held, and which of the
+// profile's own point and lead limits the scores fall between; hands by
+// the faces of the dice not yet held.
+class ProfileTables {
+public:
+    // False if the hand order names a label no hold button has
+    bool compile(const AIProfile& profile, std::string& error);
+
+    // The percent roll to beat to bank: 0 always banks, 100 never does
+    int bankCutoff(int rerolls, int held, int points, int lead) const;
+    // Hold buttons to press for the dice not yet held (faceCounts[1] to [6]); empty if nothing scores
+    const std::vector<std::string>& selectHands(const int faceCounts[7]) const;
+
+    // Chance that rolling this many dice scores something (6 or 0 dice: always)
+    static float safeChance(int remainingDice);
+
+private:
+    static const int STAGES = 8;    // Rerolls past the last stage decide like it
+
+    std::vector<int> pointBounds;
+    std::vector<int> leadBounds;
+    std::vector<uint8_t> bankTable;
+
+    std::vector<std::vector<std::string>> picks;
+    std::vector<int16_t> handTable;  // Pick index per set of remaining dice, -1 for none
+
+    int bankIndex(int stage, int held, int pointBucket, int leadBucket) const;
+};
+
+// Every personality that can be played, loaded once at startup
+class AIProfiles {
+public:
+    // Replaces the built-in profiles with the file's; keeps them if it cannot be read
+    static void load(const std::string& path);
+    static const std::vector<AIProfile>& all();
+    static const AIProfile* find(const std::string& type);
+
+    // The file format, for writing out a tuned profile
+    static std::string toJson(const AIProfile& profile, double winRate = -1, int games = 0);
+};
+
+#endif
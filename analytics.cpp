@@ -0,0 +1,234 @@
+#include "analytics.h"
+#include "columnar.h"
+#include "snapshot.h"
+#include "game.h"
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+
+namespace {
+
+const std::string TURNS_FILE = "turns.col";
+const std::string ROLLUP_FILE = "turns.rollup";
+const char ROLLUP_MAGIC[4] = {'Z', 'R', 'L', 'P'};
+const uint16_t ROLLUP_VERSION = 1;
+const uint32_t FLUSH_EVERY_ROWS = 64;
+
+enum TurnColumn { COL_PLAYER_TYPE, COL_DICE_ROLLED, COL_HANDS_TAKEN, COL_POINTS, COL_ZILCH, COL_HAND_MASK };
+
+const std::vector<ColumnSpec> TURN_SCHEMA = {
+    {"player_type", COLUMN_U8},
+    {"dice_rolled", COLUMN_U8},
+    {"hands_taken", COLUMN_U8},
+    {"points", COLUMN_I32},
+    {"zilch", COLUMN_U8},
+    {"hand_mask", COLUMN_U16}
+};
+
+// AI types as passed to Game::addPlayer; the last entry collects anything unknown
+const std::vector<std::string> PLAYER_TYPES = {"", "aggressive", "cautious", "adaptive", "other"};
+const std::vector<std::string> PLAYER_TYPE_NAMES = {"Players", "Aggressive AI", "Cautious AI", "Adaptive AI", "Other AI"};
+
+// Indexed by RollType
+const std::vector<std::string> HAND_NAMES = {"Six of a Kind", "Straight", "Three Pairs", "Three of a Kind", "Four of a Kind",
+                                             "Five of a Kind", "Single 1", "Double 1", "Single 5", "Double 5", "Nothing"};
+
+// The turn in progress
+struct TurnInProgress {
+    int diceRolled = 0;
+    int handsTaken = 0;
+    uint16_t handMask = 0;
+};
+
+bool opened = false;
+ColumnFile turnFile;
+ColumnBlock pending(TURN_SCHEMA);
+TurnInProgress turn;
+std::vector<TurnStats> rollups(PLAYER_TYPES.size());
+
+
+void addTurn(TurnStats& stats, int diceRolled, int handsTaken, int points, bool zilch, uint16_t handMask) {
+    stats.turns++;
+    stats.diceRolled += diceRolled;
+    stats.handsTaken += handsTaken;
+    if (zilch) {
+        stats.zilches++;
+    } else {
+        stats.bankedTurns++;
+        stats.pointsBanked += points;
+    }
+    for (int hand = 0; hand < HAND_KIND_COUNT; ++hand) {
+        if (handMask & (1u << hand)) stats.handTurns[hand]++;
+    }
+}
+
+// Rollup layout: "ZRLP" | u16 version | u64 turn file size it covers | u16 typeCount | TurnStats[typeCount]
+bool loadRollups(uint64_t turnFileBytes) {
+    std::ifstream in(ROLLUP_FILE, std::ios::binary);
+    if (!in.is_open()) return false;
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    size_t expected = sizeof(ROLLUP_MAGIC) + sizeof(uint16_t) + sizeof(uint64_t) + sizeof(uint16_t)
+                    + PLAYER_TYPES.size() * sizeof(TurnStats) + sizeof(uint32_t);
+    if (data.size() != expected || std::memcmp(data.data(), ROLLUP_MAGIC, sizeof(ROLLUP_MAGIC)) != 0) return false;
+
+    uint32_t stored;
+    std::memcpy(&stored, data.data() + data.size() - sizeof(stored), sizeof(stored));
+    if (stored != Snapshot::checksum(data.data(), data.size() - sizeof(stored))) return false;
+
+    size_t pos = sizeof(ROLLUP_MAGIC);
+    uint16_t version, typeCount;
+    uint64_t coveredBytes;
+    std::memcpy(&version, data.data() + pos, sizeof(version)); pos += sizeof(version);
+    std::memcpy(&coveredBytes, data.data() + pos, sizeof(coveredBytes)); pos += sizeof(coveredBytes);
+    std::memcpy(&typeCount, data.data() + pos, sizeof(typeCount)); pos += sizeof(typeCount);
+    if (version != ROLLUP_VERSION || typeCount != PLAYER_TYPES.size() || coveredBytes != turnFileBytes) return false;
+
+    std::memcpy(rollups.data(), data.data() + pos, PLAYER_TYPES.size() * sizeof(TurnStats));
+    return true;
+}
+
+void saveRollups(uint64_t turnFileBytes) {
+    std::vector<uint8_t> data(ROLLUP_MAGIC, ROLLUP_MAGIC + sizeof(ROLLUP_MAGIC));
+    auto put = [&data](const void* p, size_t size) {
+        data.insert(data.end(), static_cast<const uint8_t*>(p), static_cast<const uint8_t*>(p) + size);
+    };
+    uint16_t typeCount = static_cast<uint16_t>(PLAYER_TYPES.size());
+    put(&ROLLUP_VERSION, sizeof(ROLLUP_VERSION));
+    put(&turnFileBytes, sizeof(turnFileBytes));
+    put(&typeCount, sizeof(typeCount));
+    put(rollups.data(), rollups.size() * sizeof(TurnStats));
+    uint32_t sum = Snapshot::checksum(data.data(), data.size());
+    put(&sum, sizeof(sum));
+
+    std::string tempPath = ROLLUP_FILE + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(data.data()), data.size());
+    out.close();
+    if (out) std::rename(tempPath.c_str(), ROLLUP_FILE.c_str());
+}
+
+void endTurn(const GameEvent& event, int points, bool zilch) {
+    std::string aiType = event.playerIndex == 1 ? event.opponentType : "";
+    int type = Analytics::playerTypeIndex(aiType);
+
+    pending.put<uint8_t>(COL_PLAYER_TYPE, type);
+    pending.put<uint8_t>(COL_DICE_ROLLED, turn.diceRolled > 255 ? 255 : turn.diceRolled);
+    pending.put<uint8_t>(COL_HANDS_TAKEN, turn.handsTaken > 255 ? 255 : turn.handsTaken);
+    pending.put<int32_t>(COL_POINTS, points);
+    pending.put<uint8_t>(COL_ZILCH, zilch);
+    pending.put<uint16_t>(COL_HAND_MASK, turn.handMask);
+    pending.endRow();
+
+    addTurn(rollups[type], turn.diceRolled, turn.handsTaken, points, zilch, turn.handMask);
+    turn = TurnInProgress();
+
+    if (pending.getRows() >= FLUSH_EVERY_ROWS) {
+        Analytics::flush();
+    }
+}
+
+}
+
+
+int TurnStats::mostCommonHand() const {
+    int best = -1;
+    for (int hand = 0; hand < HAND_KIND_COUNT; ++hand) {
+        if (handTurns[hand] > 0 && (best < 0 || handTurns[hand] > handTurns[best])) best = hand;
+    }
+    return best;
+}
+
+
+int Analytics::playerTypeIndex(const std::string& aiType) {
+    for (size_t i = 0; i + 1 < PLAYER_TYPES.size(); ++i) {
+        if (PLAYER_TYPES[i] == aiType) return i;
+    }
+    return PLAYER_TYPES.size() - 1;
+}
+
+const std::vector<std::string>& Analytics::getPlayerTypeNames() {
+    return PLAYER_TYPE_NAMES;
+}
+
+std::string Analytics::getHandName(int hand) {
+    return hand >= 0 && hand < HAND_KIND_COUNT ? HAND_NAMES[hand] : "-";
+}
+
+std::vector<TurnStats> Analytics::query(const std::string& path) {
+    std::vector<TurnStats> result(PLAYER_TYPES.size());
+    ColumnFile::scan(path, TURN_SCHEMA, [&result](const ColumnBlockView& block) {
+        const uint8_t* types = block.column<uint8_t>(COL_PLAYER_TYPE);
+        const uint8_t* dice = block.column<uint8_t>(COL_DICE_ROLLED);
+        const uint8_t* hands = block.column<uint8_t>(COL_HANDS_TAKEN);
+        const uint8_t* zilch = block.column<uint8_t>(COL_ZILCH);
+
+        // Points and hand masks are read with memcpy as blocks are not aligned
+        for (uint32_t r = 0; r < block.rows; ++r) {
+            int32_t points;
+            uint16_t mask;
+            std::memcpy(&points, block.columns[COL_POINTS] + r * sizeof(points), sizeof(points));
+            std::memcpy(&mask, block.columns[COL_HAND_MASK] + r * sizeof(mask), sizeof(mask));
+            int type = types[r] < result.size() ? types[r] : result.size() - 1;
+            addTurn(result[type], dice[r], hands[r], points, zilch[r], mask);
+        }
+    });
+    return result;
+}
+
+void Analytics::open() {
+    if (opened) return;
+    opened = true;
+
+    turnFile.open(TURNS_FILE, TURN_SCHEMA);
+    std::error_code error;
+    uint64_t bytes = std::filesystem::file_size(TURNS_FILE, error);
+    if (!loadRollups(bytes)) {
+        rollups = query(TURNS_FILE);
+        saveRollups(bytes);
+    }
+}
+
+void Analytics::onGameEvent(const GameEvent& event) {
+    open();
+
+    switch (event.type) {
+        case EVENT_GAME_START:
+            turn = TurnInProgress();
+            break;
+        case EVENT_ROLL:
+            turn.diceRolled += event.diceCount;
+            break;
+        case EVENT_HOLD: {
+            turn.handsTaken++;
+            RollType hand = rollTypeFromLabel(event.hand);
+            if (hand < HAND_KIND_COUNT) turn.handMask |= 1u << hand;
+            break;
+        }
+        case EVENT_BANK:
+            endTurn(event, event.points, false);
+            break;
+        case EVENT_ZILCH:
+            endTurn(event, event.points, true);
+            break;
+        case EVENT_GAME_END:
+            flush();
+            break;
+        default:
+            break;
+    }
+}
+
+void Analytics::flush() {
+    if (!opened || pending.getRows() == 0) return;
+    turnFile.appendBlock(pending);
+    pending.clear();
+
+    std::error_code error;
+    saveRollups(std::filesystem::file_size(TURNS_FILE, error));
+}
+
+const std::vector<TurnStats>& Analytics::getRollups() {
+    open();
+    return rollups;
+}
@@ -0,0 +1,51 @@
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "events.h"
+
+// Hands tracked per turn, indexed by RollType (SIX_OF_A_KIND to NOTHING)
+const int HAND_KIND_COUNT = 11;
+
+// Totals for every turn played by one kind of player
+struct TurnStats {
+    uint64_t turns = 0;
+    uint64_t zilches = 0;
+    uint64_t bankedTurns = 0;
+    int64_t pointsBanked = 0;
+    uint64_t diceRolled = 0;
+    uint64_t handsTaken = 0;
+    uint64_t handTurns[HAND_KIND_COUNT] = {}; // Turns in which each hand was held
+
+    double averageBank() const { return bankedTurns ? double(pointsBanked) / bankedTurns : 0.0; }
+    double zilchRate() const { return turns ? double(zilches) / turns : 0.0; }
+    double averageDiceRolled() const { return turns ? double(diceRolled) / turns : 0.0; }
+    double averageHands() const { return turns ? double(handsTaken) / turns : 0.0; }
+    double handFrequency(int hand) const { return turns ? double(handTurns[hand]) / turns : 0.0; }
+    int mostCommonHand() const;
+};
+
+// Every finished turn is appended to turns.col (a ColumnFile) with columns
+//   player_type u8 | dice_rolled u8 | hands_taken u8 | points i32 | zilch u8 | hand_mask u16
+// and folded into per player type rollups kept in turns.rollup, so the awards
+// screen never has to scan the turn history.
+class Analytics {
+public:
+    static void open();
+    static void onGameEvent(const GameEvent& event);
+    static void flush();
+
+    // Full scan of a turn file, one entry per player type
+    static std::vector<TurnStats> query(const std::string& path);
+
+    static const std::vector<TurnStats>& getRollups();
+
+    // Index into the rollups for an AI type ("" for human players)
+    static int playerTypeIndex(const std::string& aiType);
+    static const std::vector<std::string>& getPlayerTypeNames();
+    static std::string getHandName(int hand);
+};
+
+#endif
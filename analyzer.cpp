@@ -0,0 +1,187 @@
+// Decision regret analyzer: rates every roll in a decisions file, the games.col
+// the game keeps or the exporter's AI-vs-AI decisions.col, against the best
+// play from the same dice. Regret is the expected turn points a hold or bank
+// gave up, or on a last turn the chance of winning; a policy that plays better
+// gives up less per decision.
+// Usage: analyzer [--in file] [--game N] [--worst N] [--threads N]
+// With --game, or for games.col the last game in it, every decision of that game is listed.
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include "ai_profile.h"
+#include "decisions.h"
+#include "regret.h"
+#include "rules.h"
+
+struct AnalyzerOptions {
+    std::string in = PLAYED_GAMES_FILE;
+    bool listGame = false;
+    int32_t game = 0;
+    int worst = 5;
+    int threads = 0;             // 0 for one per core
+};
+
+// Totals for every decision of one policy
+struct PolicyRegret {
+    uint64_t decisions = 0;
+    uint64_t best = 0;
+    double regret = 0;           // Expected points
+    uint64_t lastTurnDecisions = 0;
+    double chanceLost = 0;       // Chance of winning, on last turns
+    uint64_t seats = 0;          // Games played by the policy, per seat
+    uint64_t wins = 0;
+};
+
+const char* ACTION_NAMES[] = {"roll", "bank", "zilch", "free roll"};
+
+std::string holdText(uint64_t mask) {
+    const std::vector<std::string>& labels = holdButtonLabels();
+    std::string text;
+    for (size_t id = 0; id < labels.size(); ++id) {
+        if (!(mask & (1ULL << id))) continue;
+        if (!text.empty()) text += " + ";
+        text += labels[id];
+    }
+    return text.empty() ? "nothing" : text;
+}
+
+std::string diceText(const DecisionRow& row) {
+    std::string text;
+    for (int face = 1; face <= 6; ++face) text += std::string(row.faces[face], '0' + face);
+    return text;
+}
+
+std::string policyName(int policy) {
+    std::vector<std::string> names = decisionPolicyNames();
+    return policy < static_cast<int>(names.size()) ? names[policy] : "policy " + std::to_string(policy);
+}
+
+void printDecision(const DecisionRow& row, const DecisionRating& rating) {
+    std::ostringstream line;
+    line << std::setw(4) << row.turn + 1 << std::setw(5) << int(row.roll) << "  seat " << int(row.seat) + 1
+         << "  " << std::setw(6) << row.turnPoints << "  " << std::setw(6) << diceText(row) << "  "
+         << holdText(row.held) << ", " << ACTION_NAMES[row.action];
+    if (rating.rated) {
+        line << std::fixed << std::setprecision(1) << "  regret ";
+        if (rating.lastTurn) line << rating.regret * 100 << "% win chance";
+        else line << rating.regret;
+        if (!rating.isBest()) {
+            line << " (best: " << holdText(rating.bestHold) << ", " << (rating.bestBanks ? "bank" : "roll") << ")";
+        }
+    }
+    std::cout << line.str() << "\n";
+}
+
+bool parseOptions(int argc, char* argv[], AnalyzerOptions& options) {
+    if ((argc - 1) % 2 != 0) return false;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--in") options.in = value;
+        else if (flag == "--game") {
+            options.listGame = true;
+            options.game = std::atoi(value);
+        }
+        else if (flag == "--worst") options.worst = std::atoi(value);
+        else if (flag == "--threads") options.threads = std::atoi(value);
+        else return false;
+    }
+    if (options.worst < 0) return false;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    AIProfiles::load(AI_PROFILES_FILE);
+    AnalyzerOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: analyzer [--in file] [--game N] [--worst N] [--threads N]" << std::endl;
+        return 1;
+    }
+
+    std::vector<DecisionRow> rows;
+    if (!DecisionRecorder::readRows(options.in, rows)) {
+        std::cerr << "Could not read " << options.in << std::endl;
+        return 1;
+    }
+    if (rows.empty()) {
+        std::cout << "No decisions in " << options.in << std::endl;
+        return 0;
+    }
+    if (!options.listGame && options.in == PLAYED_GAMES_FILE) {
+        options.listGame = true;
+        options.game = rows.back().game;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const TurnSolver& solver = TurnSolver::get();
+    std::vector<DecisionRating> ratings = rateDecisions(rows, options.threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::map<int, PolicyRegret> policies;
+    std::vector<size_t> rated;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const DecisionRow& row = rows[i];
+        PolicyRegret& totals = policies[row.policy];
+        // A seat's first roll stands for its game
+        if (row.turn == 0 && row.roll == 1) {
+            totals.seats++;
+            if (row.won == 1) totals.wins++;
+        }
+        if (!ratings[i].rated) continue;
+        totals.decisions++;
+        if (ratings[i].isBest()) totals.best++;
+        if (ratings[i].lastTurn) {
+            totals.lastTurnDecisions++;
+            totals.chanceLost += ratings[i].regret;
+        } else {
+            totals.regret += ratings[i].regret;
+        }
+        if (!options.listGame || row.game == options.game) rated.push_back(i);
+    }
+
+    if (options.listGame) {
+        std::cout << "Game " << options.game << "\n turn roll  seat   turn pts  dice  held, then\n";
+        for (size_t i = 0; i < rows.size(); ++i) {
+            if (rows[i].game == options.game) printDecision(rows[i], ratings[i]);
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << std::left << std::setw(14) << "policy" << std::right << std::setw(12) << "decisions"
+              << std::setw(8) << "best" << std::setw(12) << "points/dec" << std::setw(13) << "points/game"
+              << std::setw(15) << "last turn win" << std::setw(8) << "won" << "\n" << std::fixed;
+    for (const auto& entry : policies) {
+        const PolicyRegret& totals = entry.second;
+        if (totals.decisions == 0) continue;
+        uint64_t pointDecisions = totals.decisions - totals.lastTurnDecisions;
+        std::cout << std::left << std::setw(14) << policyName(entry.first) << std::right
+                  << std::setw(12) << totals.decisions
+                  << std::setw(7) << std::setprecision(1) << 100.0 * totals.best / totals.decisions << "%"
+                  << std::setw(12) << std::setprecision(2) << totals.regret / std::max<uint64_t>(pointDecisions, 1)
+                  << std::setw(13) << std::setprecision(1) << totals.regret / std::max<uint64_t>(totals.seats, 1)
+                  << std::setw(13) << std::setprecision(2) << -100.0 * totals.chanceLost / std::max<uint64_t>(totals.lastTurnDecisions, 1) << "%"
+                  << std::setw(7) << std::setprecision(1) << 100.0 * totals.wins / std::max<uint64_t>(totals.seats, 1) << "%\n";
+    }
+
+    // Costliest first
+    std::sort(rated.begin(), rated.end(), [&](size_t a, size_t b) { return ratings[a].regret > ratings[b].regret; });
+    if (options.worst > 0 && !rated.empty()) {
+        std::cout << "\nWorst decisions" << (options.listGame ? "" : " (game, policy)") << "\n";
+        for (size_t i = 0; i < rated.size() && static_cast<int>(i) < options.worst; ++i) {
+            const DecisionRow& row = rows[rated[i]];
+            if (!options.listGame) std::cout << row.game << ", " << policyName(row.policy) << ":";
+            printDecision(row, ratings[rated[i]]);
+        }
+    }
+
+    std::cout << "\nRated " << rows.size() << " rolls in " << std::setprecision(3) << seconds * 1000
+              << " ms, " << std::setprecision(1) << solver.getSolveSeconds() * 1000
+              << " ms of it solving every turn" << std::endl;
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include "animation.h"
+#include <cmath>
+
+namespace {
+
+const float PI = 3.14159265f;
+
+// Longer gaps (a breakpoint, a dragged window) are not played back as one jump
+const float MAX_FRAME_SECONDS = 0.25f;
+
+double animationClock = 0;
+float lastDelta = 0;
+float speed = 1.0f;
+bool enabled = true;
+
+}
+
+
+void Animation::update(float realSeconds) {
+    if (realSeconds < 0) realSeconds = 0;
+    if (realSeconds > MAX_FRAME_SECONDS) realSeconds = MAX_FRAME_SECONDS;
+    lastDelta = realSeconds * speed;
+    animationClock += lastDelta;
+}
+
+double Animation::now() {
+    return animationClock;
+}
+
+float Animation::delta() {
+    return lastDelta;
+}
+
+void Animation::setSpeed(float newSpeed) {
+    if (newSpeed > 0) speed = newSpeed;
+}
+
+float Animation::getSpeed() {
+    return speed;
+}
+
+void Animation::setEnabled(bool isOn) {
+    enabled = isOn;
+}
+
+bool Animation::isEnabled() {
+    return enabled;
+}
+
+float Animation::duration(float seconds) {
+    return enabled ? seconds : 0;
+}
+
+float Animation::ease(Easing easing, float t) {
+    if (t <= 0) return 0;
+    if (t >= 1) return 1;
+    switch (easing) {
+        case EASE_OUT_CUBIC: {
+            float inverse = 1 - t;
+            return 1 - inverse * inverse * inverse;
+        }
+        case EASE_IN_OUT_SINE:
+            return 0.5f - 0.5f * std::cos(PI * t);
+        case EASE_LINEAR:
+        default:
+            return t;
+    }
+}
+
+
+void Tween::start(float fromValue, float toValue, float seconds, Easing curve) {
+    startTime = Animation::now();
+    length = Animation::duration(seconds);
+    from = fromValue;
+    to = toValue;
+    easing = curve;
+}
+
+float Tween::progress() const {
+    if (length <= 0) return 1;
+    float t = static_cast<float>((Animation::now() - startTime) / length);
+    return t < 1 ? t : 1;
+}
+
+float Tween::elapsed() const {
+    return static_cast<float>(Animation::now() - startTime);
+}
+
+float Tween::value() const {
+    return from + (to - from) * Animation::ease(easing, progress());
+}
+
+bool Tween::isRunning() const {
+    return progress() < 1;
+}
+
+
+void Timeline::add(float pause, std::function<void()> step) {
+    if (steps.empty()) frontReadyAt = Animation::now() + Animation::duration(pause);
+    steps.push_back({pause, std::move(step)});
+}
+
+void Timeline::update() {
+    while (!steps.empty() && Animation::now() >= frontReadyAt) {
+        std::function<void()> run = std::move(steps.front().run);
+        steps.pop_front();
+        run();
+        // The next pause counts from now, including steps the one just run added
+        if (!steps.empty()) frontReadyAt = Animation::now() + Animation::duration(steps.front().pause);
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <functional>
+#include <deque>
+
+enum Easing {
+    EASE_LINEAR,
+    EASE_OUT_CUBIC,     // Fast start, gentle landing
+    EASE_IN_OUT_SINE
+};
+
+// The animation clock. The main loop feeds it real frame time once per
+// frame; everything animated reads this clock instead of sleeping, so it
+// runs at the same pace at any frame rate. Speed scales the clock for fast
+// play, and disabling it makes every tween and pause finish immediately.
+class Animation {
+public:
+    static void update(float realSeconds);
+
+    // Scaled seconds since start, and in the last update
+    static double now();
+    static float delta();
+
+    static void setSpeed(float speed);
+    static float getSpeed();
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    // Length of something meant to take seconds, 0 when animations are off
+    static float duration(float seconds);
+
+    static float ease(Easing easing, float t);
+};
+
+// A value moving from one number to another over a duration.
+// It only remembers when it started, so nothing has to advance it.
+struct Tween {
+    double startTime = 0;
+    float length = 0;
+    float from = 0;
+    float to = 0;
+    Easing easing = EASE_OUT_CUBIC;
+
+    void start(float fromValue, float toValue, float seconds, Easing curve = EASE_OUT_CUBIC);
+    float progress() const;     // 0 to 1
+    float elapsed() const;      // Seconds on the animation clock
+    float value() const;
+    bool isRunning() const;
+};
+
+// Steps run one after another, each after a pause measured from the step
+// before it. Steps may add more steps while they run.
+class Timeline {
+public:
+    void add(float pause, std::function<void()> step);
+    // Runs every step that is due
+    void update();
+    bool isEmpty() const { return steps.empty(); }
+    void clear() { steps.clear(); }
+
+private:
+    struct Step {
+        float pause;
+        std::function<void()> run;
+    };
+    std::deque<Step> steps;
+    double frontReadyAt = 0;
+};
+
+#endif
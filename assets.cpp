@@ -0,0 +1,323 @@
+#include "assets.h"
+#include "pack.h"
+#include "render_thread.h"
+#include "batch.h"
+#include <SDL_image.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+namespace {
+
+enum AssetJobKind { JOB_TEXTURE, JOB_FONT, JOB_SPRITE };
+
+struct AssetJob {
+    AssetJobKind kind;
+    int id;             // TextureId, FontId or SpriteId
+    std::string path;
+    int fontSize;
+};
+
+// Menu assets come first so the menu can be shown while the rest loads
+const std::vector<AssetJob> JOBS = {
+    {JOB_TEXTURE, TEXTURE_BACKGROUND, "assets/textures/Wooden-Background.jpg", 0},
+    {JOB_FONT, FONT_MAIN, "assets/fonts/Rye-Regular.ttf", 24},
+    {JOB_FONT, FONT_TITLE, "assets/fonts/TiltPrism.ttf", 120},
+    {JOB_SPRITE, SPRITE_DIE_1, "assets/textures/1-face.png", 0},
+    {JOB_SPRITE, SPRITE_DIE_2, "assets/textures/2-face.png", 0},
+    {JOB_SPRITE, SPRITE_DIE_3, "assets/textures/3-face.png", 0},
+    {JOB_SPRITE, SPRITE_DIE_4, "assets/textures/4-face.png", 0},
+    {JOB_SPRITE, SPRITE_DIE_5, "assets/textures/5-face.png", 0},
+    {JOB_SPRITE, SPRITE_DIE_6, "assets/textures/6-face.png", 0},
+    {JOB_SPRITE, SPRITE_MEDAL_UNLOCKED, "assets/textures/medal_unlocked.png", 0},
+    {JOB_SPRITE, SPRITE_MEDAL_LOCKED, "assets/textures/medal_locked.png", 0},
+    {JOB_SPRITE, SPRITE_MUTE, "assets/textures/mute.png", 0},
+    {JOB_SPRITE, SPRITE_UNMUTE, "assets/textures/unmute.png", 0},
+    {JOB_FONT, FONT_SMALL, "assets/fonts/Rye-Regular.ttf", 15},
+    {JOB_FONT, FONT_WINNER, "assets/fonts/TiltPrism.ttf", 80}
+};
+const int MAX_WORKERS = 4;
+
+// Widest atlas every renderer we target can take; sprites are placed on shelves within it
+const int ATLAS_WIDTH = 2048;
+const int ATLAS_PADDING = 1;    // Keeps neighbours from bleeding in when scaled
+
+// A decoded image waiting to be uploaded by update()
+struct DecodedImage {
+    int id;
+    SDL_Surface* surface;
+};
+
+const std::string ASSET_FOLDER = "assets/";
+
+// Pre-decoded assets mapped from assets.pak; loose files are used for anything not in it
+AssetPack pack;
+std::vector<std::thread> workers;
+std::atomic<size_t> nextJob{0};
+std::atomic<bool> stopping{false};
+
+std::mutex decodedMutex;
+std::vector<DecodedImage> decoded;
+
+// FreeType faces must not be created from two threads at once
+std::mutex fontOpenMutex;
+
+// Written by workers (fonts) or update() on the render thread (textures),
+// read by the game thread. Done is set once loading finished, even if it failed.
+std::atomic<SDL_Texture*> textures[TEXTURE_COUNT] = {};
+std::atomic<bool> textureDone[TEXTURE_COUNT] = {};
+std::atomic<TTF_Font*> fonts[FONT_COUNT] = {};
+std::atomic<bool> fontDone[FONT_COUNT] = {};
+std::atomic<int> pendingJobs{0};
+
+// Filled by the sprite jobs; the rects are published with the atlas surface
+SDL_Surface* spriteSurfaces[SPRITE_COUNT] = {};
+SDL_Rect spriteRects[SPRITE_COUNT] = {};
+std::atomic<int> spritesRemaining{0};
+
+std::chrono::steady_clock::time_point startTime;
+bool firstFrameLogged = false;
+bool fullyLoadedLogged = false;
+
+long long millisecondsSinceStart() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+// Looks a file up in the pack, rejecting entries whose data does not match their checksum
+const PackEntry* findInPack(const std::string& path, PackEntryKind kind) {
+    if (!pack.isOpen()) return nullptr;
+    const PackEntry* entry = pack.find(path.substr(ASSET_FOLDER.size()));
+    if (!entry || entry->kind != kind) return nullptr;
+    if (!pack.verify(*entry)) {
+        std::cerr << "Damaged pack entry: " << entry->name << ", using the loose file" << std::endl;
+        return nullptr;
+    }
+    return entry;
+}
+
+TTF_Font* openFont(const AssetJob& job) {
+    std::lock_guard<std::mutex> lock(fontOpenMutex);
+    if (const PackEntry* entry = findInPack(job.path, PACK_FONT)) {
+        // The font reads from the mapping for as long as it is open
+        SDL_RWops* rw = SDL_RWFromConstMem(pack.data(*entry), entry->size);
+        return TTF_OpenFontRW(rw, 1, job.fontSize);
+    }
+    return TTF_OpenFont(job.path.c_str(), job.fontSize);
+}
+
+SDL_Surface* loadImage(const std::string& path) {
+    if (const PackEntry* entry = findInPack(path, PACK_TEXTURE)) {
+        // No decoding; the surface just points at the pixels in the mapping
+        return SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint8_t*>(pack.data(*entry)), entry->width, entry->height,
+                                                  32, entry->pitch, entry->pixelFormat);
+    }
+    return IMG_Load(path.c_str());
+}
+
+// Shelf packing: tallest sprites first, left to right, a new shelf when a row is full
+SDL_Surface* buildAtlas() {
+    std::vector<int> order;
+    for (int i = 0; i < SPRITE_COUNT; ++i) {
+        if (spriteSurfaces[i]) order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), [](int a, int b) { return spriteSurfaces[a]->h > spriteSurfaces[b]->h; });
+
+    int x = 0, y = 0, shelfHeight = 0;
+    for (int sprite : order) {
+        SDL_Surface* surface = spriteSurfaces[sprite];
+        if (x + surface->w > ATLAS_WIDTH) {
+            x = 0;
+            y += shelfHeight + ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+        spriteRects[sprite] = {x, y, surface->w, surface->h};
+        x += surface->w + ATLAS_PADDING;
+        if (surface->h > shelfHeight) shelfHeight = surface->h;
+    }
+
+    SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, y + shelfHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+    for (int sprite : order) {
+        if (atlas) {
+            // Copy alpha as is rather than blending onto the empty atlas
+            SDL_SetSurfaceBlendMode(spriteSurfaces[sprite], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(spriteSurfaces[sprite], nullptr, atlas, &spriteRects[sprite]);
+        }
+        SDL_FreeSurface(spriteSurfaces[sprite]);
+        spriteSurfaces[sprite] = nullptr;
+    }
+    if (!atlas) {
+        std::cerr << "Failed to build the sprite atlas SDL_Error: " << SDL_GetError() << std::endl;
+    }
+    return atlas;
+}
+
+void runJobs() {
+    while (!stopping) {
+        size_t index = nextJob.fetch_add(1);
+        if (index >= JOBS.size()) return;
+        const AssetJob& job = JOBS[index];
+
+        if (job.kind == JOB_FONT) {
+            TTF_Font* font = openFont(job);
+            if (!font) {
+                std::cerr << "Failed to load font: " << job.path << " SDL_ttf Error: " << TTF_GetError() << std::endl;
+            }
+            fonts[job.id] = font;
+            fontDone[job.id] = true;
+            pendingJobs--;
+        } else {
+            SDL_Surface* surface = loadImage(job.path);
+            if (!surface) {
+                std::cerr << "Failed to load image: " << job.path << " SDL_image Error: " << IMG_GetError() << std::endl;
+            }
+
+            if (job.kind == JOB_SPRITE) {
+                spriteSurfaces[job.id] = surface;
+                if (--spritesRemaining > 0) continue;
+                surface = buildAtlas();
+            }
+            std::lock_guard<std::mutex> lock(decodedMutex);
+            decoded.push_back({job.kind == JOB_SPRITE ? TEXTURE_ATLAS : job.id, surface});
+        }
+    }
+}
+
+}
+
+
+void Assets::startLoading() {
+    // Everything from a previous startLoading/shutdown round is forgotten
+    startTime = std::chrono::steady_clock::now();
+    stopping = false;
+    nextJob = 0;
+    for (auto& done : textureDone) done = false;
+    for (auto& done : fontDone) done = false;
+    firstFrameLogged = false;
+    fullyLoadedLogged = false;
+    // One upload for the atlas rather than one per sprite
+    pendingJobs = 1;
+    spritesRemaining = 0;
+    for (const AssetJob& job : JOBS) {
+        if (job.kind == JOB_SPRITE) spritesRemaining++;
+        else pendingJobs++;
+    }
+    if (!pack.open(ASSET_PACK_FILE)) {
+        std::cout << "No usable " << ASSET_PACK_FILE << ", loading assets from " << ASSET_FOLDER << std::endl;
+    }
+
+    // Decoders are set up here so the workers never initialise them concurrently
+    IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG);
+
+    int workerCount = std::thread::hardware_concurrency();
+    if (workerCount < 1) workerCount = 1;
+    if (workerCount > MAX_WORKERS) workerCount = MAX_WORKERS;
+    for (int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(runJobs);
+    }
+}
+
+// Textures can only be created on the thread that owns the renderer
+void Assets::update(SDL_Renderer* renderer) {
+    std::vector<DecodedImage> ready;
+    {
+        std::lock_guard<std::mutex> lock(decodedMutex);
+        ready.swap(decoded);
+    }
+    for (const DecodedImage& image : ready) {
+        if (image.surface) {
+            SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, image.surface);
+            RenderThread::countTextureUpload();
+            if (texture) RenderBatch::recordTextureSize(texture, image.surface->w, image.surface->h);
+            textures[image.id] = texture;
+            SDL_FreeSurface(image.surface);
+        }
+        textureDone[image.id] = true;
+        pendingJobs--;
+    }
+
+    // Workers have nothing left to do once every job is done
+    if (pendingJobs == 0 && !workers.empty()) {
+        for (auto& worker : workers) worker.join();
+        workers.clear();
+    }
+}
+
+bool Assets::isMenuReady() {
+    return textureDone[TEXTURE_BACKGROUND] && fontDone[FONT_MAIN] && fontDone[FONT_TITLE];
+}
+
+bool Assets::isFullyLoaded() {
+    return pendingJobs == 0;
+}
+
+SDL_Texture* Assets::getTexture(TextureId id) {
+    return textures[id];
+}
+
+Sprite Assets::getSprite(SpriteId id) {
+    // The rects were written before the atlas texture was published
+    SDL_Texture* atlas = textures[TEXTURE_ATLAS];
+    return {atlas, spriteRects[id]};
+}
+
+Sprite Assets::getDieSprite(int value) {
+    if (value < 1 || value > 6) return {nullptr, {0, 0, 0, 0}};
+    return getSprite(static_cast<SpriteId>(SPRITE_DIE_1 + value - 1));
+}
+
+TTF_Font* Assets::getFont(FontId id) {
+    return fonts[id];
+}
+
+void Assets::framePresented() {
+    if (!firstFrameLogged && isMenuReady()) {
+        firstFrameLogged = true;
+        std::cout << "Startup: first frame after " << millisecondsSinceStart() << " ms" << std::endl;
+    }
+    if (!fullyLoadedLogged && isFullyLoaded()) {
+        fullyLoadedLogged = true;
+        std::cout << "Startup: all assets loaded after " << millisecondsSinceStart() << " ms" << std::endl;
+    }
+}
+
+void Assets::releaseTextures() {
+    for (auto& texture : textures) {
+        SDL_Texture* created = texture.exchange(nullptr);
+        if (created) {
+            RenderBatch::forgetTextureSize(created);
+            SDL_DestroyTexture(created);
+        }
+    }
+}
+
+void Assets::shutdown() {
+    stopping = true;
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+    workers.clear();
+
+    // Decoded after the render thread stopped uploading
+    for (const DecodedImage& image : decoded) {
+        if (image.surface) SDL_FreeSurface(image.surface);
+    }
+    decoded.clear();
+
+    // Sprites decoded before loading was stopped, if the atlas was never built
+    for (auto& surface : spriteSurfaces) {
+        if (surface) SDL_FreeSurface(surface);
+        surface = nullptr;
+    }
+
+    for (auto& font : fonts) {
+        TTF_Font* open = font.exchange(nullptr);
+        if (open) TTF_CloseFont(open);
+    }
+    pack.close(); // Only once the fonts reading from it are closed
+    IMG_Quit();
+}
@@ -0,0 +1,66 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+enum TextureId {
+    TEXTURE_BACKGROUND,
+    TEXTURE_ATLAS,      // All the sprites below
+    TEXTURE_COUNT
+};
+
+// Small images packed into the atlas texture, so drawing them never switches textures
+enum SpriteId {
+    SPRITE_DIE_1, SPRITE_DIE_2, SPRITE_DIE_3, SPRITE_DIE_4, SPRITE_DIE_5, SPRITE_DIE_6,
+    SPRITE_MEDAL_UNLOCKED, SPRITE_MEDAL_LOCKED,
+    SPRITE_MUTE, SPRITE_UNMUTE,
+    SPRITE_COUNT
+};
+
+// Where a sprite is; texture is nullptr until the atlas has loaded
+struct Sprite {
+    SDL_Texture* texture;
+    SDL_Rect rect;
+};
+
+enum FontId {
+    FONT_MAIN,      // Rye 24, used for almost all text
+    FONT_SMALL,     // Rye 15, exponents in the tutorial
+    FONT_TITLE,     // TiltPrism 120, the menu title
+    FONT_WINNER,    // TiltPrism 80, the end of game banner
+    FONT_COUNT
+};
+
+// Loads every texture and font once at startup.
+// Images are decoded and fonts opened on worker threads; decoded images are
+// turned into textures by update() on the render thread as they complete.
+// Textures and fonts are published atomically, so the getters are safe to
+// call from the game thread while loading goes on.
+// The sprites are decoded in parallel and the last one done builds the atlas.
+// Anything not loaded yet (or that failed to load) is returned as nullptr.
+class Assets {
+public:
+    static void startLoading();
+    // Render thread only
+    static void update(SDL_Renderer* renderer);
+
+    // The background, main font and title font
+    static bool isMenuReady();
+    static bool isFullyLoaded();
+
+    static SDL_Texture* getTexture(TextureId id);
+    static Sprite getSprite(SpriteId id);
+    static Sprite getDieSprite(int value);
+    static TTF_Font* getFont(FontId id);
+
+    // Call after each SDL_RenderPresent; logs time to first frame and to fully loaded
+    static void framePresented();
+
+    // Render thread only, before it destroys the renderer
+    static void releaseTextures();
+    // After the render thread has stopped
+    static void shutdown();
+};
+
+#endif
@@ -0,0 +1,145 @@
+#include "audio.h"
+#include "pack.h"
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+
+namespace {
+
+const char* SOUND_FILES[SOUND_COUNT] = {
+    "audio/dice-rolling-sound.wav",
+    "audio/banking.wav"
+};
+
+const std::string AUDIO_FOLDER = "assets/";
+
+// 256 sample frames at 44.1kHz is a buffer of under 6ms
+const int AUDIO_FREQUENCY = MIX_DEFAULT_FREQUENCY;
+const int AUDIO_BUFFER_FRAMES = 256;
+// Enough that a roll straight after a bank never cuts the bank off
+const int MIXER_CHANNELS = 8;
+
+bool isOpen = false;
+std::atomic<bool> muted{false};
+
+// What the device actually opened with, which every effect is converted to
+int deviceFrequency = 0;
+Uint16 deviceFormat = 0;
+int deviceChannels = 0;
+
+// The chunks point into samples, which stay put until close()
+std::vector<Uint8> samples[SOUND_COUNT];
+Mix_Chunk* chunks[SOUND_COUNT] = {};
+
+// Converts PCM in any format to the device's, into the effect's buffer
+bool convert(SoundId id, const Uint8* data, Uint32 length, Uint16 format, Uint8 channels, int frequency) {
+    SDL_AudioCVT cvt;
+    int needed = SDL_BuildAudioCVT(&cvt, format, channels, frequency, deviceFormat, deviceChannels, deviceFrequency);
+    if (needed < 0) return false;
+
+    samples[id].assign(data, data + length);
+    if (needed == 0) return true;
+
+    samples[id].resize(static_cast<size_t>(length) * cvt.len_mult);
+    cvt.buf = samples[id].data();
+    cvt.len = length;
+    if (SDL_ConvertAudio(&cvt) < 0) return false;
+    samples[id].resize(cvt.len_cvt);
+    samples[id].shrink_to_fit();
+    return true;
+}
+
+// From the pack when it has the effect, as it is already decoded there; else the loose .wav
+bool loadSound(AssetPack& pack, SoundId id) {
+    const PackEntry* entry = pack.isOpen() ? pack.find(SOUND_FILES[id]) : nullptr;
+    if (entry && entry->kind == PACK_AUDIO && pack.verify(*entry)) {
+        return convert(id, pack.data(*entry), entry->size, entry->audioFormat, entry->channels, entry->frequency);
+    }
+
+    std::string path = AUDIO_FOLDER + SOUND_FILES[id];
+    SDL_AudioSpec spec;
+    Uint8* buffer = nullptr;
+    Uint32 length = 0;
+    if (!SDL_LoadWAV(path.c_str(), &spec, &buffer, &length)) return false;
+    bool converted = convert(id, buffer, length, spec.format, spec.channels, spec.freq);
+    SDL_FreeWAV(buffer);
+    return converted;
+}
+
+}
+
+
+bool Audio::open() {
+    if (isOpen) return true;
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0 ||
+        Mix_OpenAudio(AUDIO_FREQUENCY, MIX_DEFAULT_FORMAT, MIX_DEFAULT_CHANNELS, AUDIO_BUFFER_FRAMES) < 0) {
+        std::cerr << "No audio, playing silent. SDL_mixer Error: " << Mix_GetError() << std::endl;
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+    Mix_QuerySpec(&deviceFrequency, &deviceFormat, &deviceChannels);
+    Mix_AllocateChannels(MIXER_CHANNELS);
+
+    // Only needed while loading; the converted samples are our own
+    AssetPack pack;
+    pack.open(ASSET_PACK_FILE);
+    for (int id = 0; id < SOUND_COUNT; ++id) {
+        SoundId sound = static_cast<SoundId>(id);
+        if (!loadSound(pack, sound)) {
+            std::cerr << "Failed to load sound: " << SOUND_FILES[id] << " SDL_Error: " << SDL_GetError() << std::endl;
+            samples[id].clear();
+            continue;
+        }
+        chunks[id] = Mix_QuickLoad_RAW(samples[id].data(), samples[id].size());
+    }
+
+    isOpen = true;
+    return true;
+}
+
+void Audio::close() {
+    if (!isOpen) return;
+    Mix_HaltChannel(-1);
+    for (int id = 0; id < SOUND_COUNT; ++id) {
+        if (chunks[id]) Mix_FreeChunk(chunks[id]);   // Leaves the samples alone, they were never the mixer's
+        chunks[id] = nullptr;
+        samples[id].clear();
+        samples[id].shrink_to_fit();
+    }
+    Mix_CloseAudio();
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    isOpen = false;
+}
+
+void Audio::play(SoundId id) {
+    if (!isOpen || muted || !chunks[id]) return;
+    Mix_PlayChannel(-1, chunks[id], 0);
+}
+
+void Audio::setMuted(bool mute) {
+    muted = mute;
+    if (mute && isOpen) Mix_HaltChannel(-1);
+}
+
+bool Audio::isMuted() {
+    return muted;
+}
+
+void Audio::onGameEvent(const GameEvent& event) {
+    switch (event.type) {
+        case EVENT_ROLL:
+            play(SOUND_ROLL);
+            break;
+        case EVENT_BANK:
+            play(SOUND_BANK);
+            break;
+        case EVENT_ZILCH:
+            // No effect ships for a zilch; the roll that caused it is still sounding
+            break;
+        default:
+            break;
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include "events.h"
+
+enum SoundId {
+    SOUND_ROLL,     // Dice hitting the table
+    SOUND_BANK,     // Points banked
+    SOUND_COUNT
+};
+
+// Sound effects, played by SDL_mixer on its own audio thread.
+// open() decodes every effect and converts it to the device format up front,
+// so play() only hands a ready buffer to a free mixer channel: no decoding,
+// no allocation, and nothing for the render thread to do. The device runs with
+// a small buffer so a sound starts within a few milliseconds of its event.
+// Without an audio device the game just runs silent.
+class Audio {
+public:
+    static bool open();
+    static void close();
+
+    static void play(SoundId id);
+
+    static void setMuted(bool mute);
+    static bool isMuted();
+
+    // Listener for Game::addEventListener
+    static void onGameEvent(const GameEvent& event);
+};
+
+#endif
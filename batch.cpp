@@ -0,0 +1,251 @@
+#include "batch.h"
+#include "render_thread.h"
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <iostream>
+
+namespace {
+
+// How many batches back a quad may move to join one with its texture
+const int LOOKBACK = 8;
+
+// Printable ASCII is baked into each font's glyph atlas
+const int FIRST_GLYPH = 32;
+const int LAST_GLYPH = 126;
+const int GLYPH_ATLAS_WIDTH = 1024;
+const int GLYPH_PADDING = 1;
+
+struct Glyph {
+    SDL_Rect source = {0, 0, 0, 0};   // Empty for glyphs with nothing to draw, like the space
+    int offsetX = 0;
+    int advance = 0;
+};
+
+struct GlyphAtlas {
+    SDL_Texture* texture = nullptr;
+    int width = 0;
+    int height = 0;
+    Glyph glyphs[LAST_GLYPH + 1];
+};
+
+std::unordered_map<TTF_Font*, GlyphAtlas> glyphAtlases;
+
+// Sizes of the textures the render thread created, so the game thread never queries them
+std::mutex textureSizesMutex;
+std::unordered_map<SDL_Texture*, SDL_Point> textureSizes;
+
+
+bool overlaps(const DrawBatch& batch, const SDL_Rect& rect) {
+    for (const SDL_Rect& other : batch.bounds) {
+        if (SDL_HasIntersection(&other, &rect)) return true;
+    }
+    return false;
+}
+
+DrawBatch& newBatch(RenderFrame& frame) {
+    if (frame.usedBatches == frame.batches.size()) frame.batches.emplace_back();
+    return frame.batches[frame.usedBatches++];
+}
+
+DrawBatch& batchFor(SDL_Texture* texture, const SDL_Rect& bounds) {
+    RenderFrame& frame = RenderThread::recordingFrame();
+    std::vector<DrawBatch>& batches = frame.batches;
+    int used = static_cast<int>(frame.usedBatches);
+    int target = -1;
+    for (int i = used - 1; i >= 0 && i >= used - LOOKBACK; --i) {
+        if (batches[i].texture == texture && !batches[i].surface) {
+            target = i;
+            break;
+        }
+        // Joining an earlier batch would draw this under something it overlaps
+        if (overlaps(batches[i], bounds)) break;
+    }
+
+    if (target < 0) {
+        newBatch(frame).texture = texture;
+        target = used;
+    }
+    batches[target].bounds.push_back(bounds);
+    return batches[target];
+}
+
+void addQuad(DrawBatch& batch, const SDL_Rect& rect, float u0, float v0, float u1, float v1, SDL_Color color) {
+    int first = batch.vertices.size();
+    float x0 = rect.x, y0 = rect.y, x1 = rect.x + rect.w, y1 = rect.y + rect.h;
+    batch.vertices.push_back({{x0, y0}, color, {u0, v0}});
+    batch.vertices.push_back({{x1, y0}, color, {u1, v0}});
+    batch.vertices.push_back({{x1, y1}, color, {u1, v1}});
+    batch.vertices.push_back({{x0, y1}, color, {u0, v1}});
+    for (int index : {0, 1, 2, 0, 2, 3}) {
+        batch.indices.push_back(first + index);
+    }
+}
+
+// Renders every printable glyph once, white, so the vertex colour can tint it
+GlyphAtlas* glyphAtlasFor(TTF_Font* font) {
+    auto found = glyphAtlases.find(font);
+    if (found != glyphAtlases.end()) return &found->second;
+
+    GlyphAtlas& atlas = glyphAtlases[font];
+    SDL_Surface* surfaces[LAST_GLYPH + 1] = {};
+    int x = 0, y = 0, shelfHeight = 0;
+    for (int ch = FIRST_GLYPH; ch <= LAST_GLYPH; ++ch) {
+        int minX, maxX, minY, maxY, advance;
+        if (TTF_GlyphMetrics(font, ch, &minX, &maxX, &minY, &maxY, &advance) != 0) continue;
+        atlas.glyphs[ch].advance = advance;
+        atlas.glyphs[ch].offsetX = minX < 0 ? minX : 0;
+
+        SDL_Surface* rendered = TTF_RenderGlyph_Solid(font, ch, {255, 255, 255, 255});
+        if (!rendered) continue;
+        surfaces[ch] = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(rendered);
+        if (!surfaces[ch]) continue;
+
+        if (x + surfaces[ch]->w > GLYPH_ATLAS_WIDTH) {
+            x = 0;
+            y += shelfHeight + GLYPH_PADDING;
+            shelfHeight = 0;
+        }
+        atlas.glyphs[ch].source = {x, y, surfaces[ch]->w, surfaces[ch]->h};
+        x += surfaces[ch]->w + GLYPH_PADDING;
+        if (surfaces[ch]->h > shelfHeight) shelfHeight = surfaces[ch]->h;
+    }
+
+    SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat(0, GLYPH_ATLAS_WIDTH, y + shelfHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+    for (int ch = FIRST_GLYPH; ch <= LAST_GLYPH; ++ch) {
+        if (!surfaces[ch]) continue;
+        if (sheet) {
+            // The colour key became alpha in the conversion; copy it rather than blend
+            SDL_SetColorKey(surfaces[ch], SDL_FALSE, 0);
+            SDL_SetSurfaceBlendMode(surfaces[ch], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(surfaces[ch], nullptr, sheet, &atlas.glyphs[ch].source);
+        }
+        SDL_FreeSurface(surfaces[ch]);
+    }
+    if (sheet) {
+        // Once per font, so waiting for the render thread here is not worth avoiding
+        RenderThread::invoke([&](SDL_Renderer* renderer) {
+            atlas.texture = SDL_CreateTextureFromSurface(renderer, sheet);
+            RenderThread::countTextureUpload();
+            atlas.width = sheet->w;
+            atlas.height = sheet->h;
+            if (atlas.texture) SDL_SetTextureBlendMode(atlas.texture, SDL_BLENDMODE_BLEND);
+        });
+        SDL_FreeSurface(sheet);
+    }
+    if (!atlas.texture) {
+        std::cerr << "Failed to build a glyph atlas SDL_Error: " << SDL_GetError() << std::endl;
+    }
+    return &atlas;
+}
+
+bool isPrintableAscii(const std::string& text) {
+    for (unsigned char ch : text) {
+        if (ch < FIRST_GLYPH || ch > LAST_GLYPH) return false;
+    }
+    return true;
+}
+
+}
+
+
+void RenderBatch::recordTextureSize(SDL_Texture* texture, int width, int height) {
+    std::lock_guard<std::mutex> lock(textureSizesMutex);
+    textureSizes[texture] = {width, height};
+}
+
+void RenderBatch::forgetTextureSize(SDL_Texture* texture) {
+    std::lock_guard<std::mutex> lock(textureSizesMutex);
+    textureSizes.erase(texture);
+}
+
+void RenderBatch::releaseTextures() {
+    for (auto& entry : glyphAtlases) {
+        if (entry.second.texture) SDL_DestroyTexture(entry.second.texture);
+    }
+    glyphAtlases.clear();
+}
+
+void RenderBatch::fillRect(const SDL_Rect& rect, SDL_Color color) {
+    addQuad(batchFor(nullptr, rect), rect, 0, 0, 0, 0, color);
+}
+
+void RenderBatch::drawRect(const SDL_Rect& rect, SDL_Color color, int thickness) {
+    if (thickness * 2 >= rect.w || thickness * 2 >= rect.h) {
+        fillRect(rect, color);
+        return;
+    }
+    DrawBatch& batch = batchFor(nullptr, rect);
+    addQuad(batch, {rect.x, rect.y, rect.w, thickness}, 0, 0, 0, 0, color);
+    addQuad(batch, {rect.x, rect.y + rect.h - thickness, rect.w, thickness}, 0, 0, 0, 0, color);
+    addQuad(batch, {rect.x, rect.y + thickness, thickness, rect.h - 2 * thickness}, 0, 0, 0, 0, color);
+    addQuad(batch, {rect.x + rect.w - thickness, rect.y + thickness, thickness, rect.h - 2 * thickness}, 0, 0, 0, 0, color);
+}
+
+void RenderBatch::drawTexture(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect& destination) {
+    if (!texture) return;
+    int width = 0, height = 0;
+    {
+        std::lock_guard<std::mutex> lock(textureSizesMutex);
+        auto found = textureSizes.find(texture);
+        if (found != textureSizes.end()) {
+            width = found->second.x;
+            height = found->second.y;
+        }
+    }
+    if (width == 0 || height == 0) return;
+
+    SDL_Rect full = {0, 0, width, height};
+    const SDL_Rect& from = source ? *source : full;
+    addQuad(batchFor(texture, destination), destination,
+            float(from.x) / width, float(from.y) / height,
+            float(from.x + from.w) / width, float(from.y + from.h) / height, {255, 255, 255, 255});
+}
+
+void RenderBatch::drawText(TTF_Font* font, const std::string& text, SDL_Color color, int x, int y) {
+    if (!font || text.empty()) return;
+    color.a = 255; // Text was always drawn opaque; callers often leave alpha out
+    GlyphAtlas* atlas = isPrintableAscii(text) ? glyphAtlasFor(font) : nullptr;
+
+    if (!atlas || !atlas->texture) {
+        // Rendered here and uploaded by the render thread just for this frame
+        SDL_Surface* surface = TTF_RenderText_Solid(font, text.c_str(), color);
+        if (!surface) return;
+        SDL_Rect destination = {x, y, surface->w, surface->h};
+        DrawBatch& batch = newBatch(RenderThread::recordingFrame());
+        batch.surface = surface;
+        batch.bounds.push_back(destination);
+        addQuad(batch, destination, 0, 0, 1, 1, {255, 255, 255, 255});
+        return;
+    }
+
+    int width = atlas->width, height = atlas->height;
+    SDL_Point size = textSize(font, text);
+    DrawBatch& batch = batchFor(atlas->texture, {x, y, size.x, size.y});
+
+    int penX = x;
+    unsigned char previous = 0;
+    for (unsigned char ch : text) {
+        if (previous) penX += TTF_GetFontKerningSizeGlyphs(font, previous, ch);
+        const Glyph& glyph = atlas->glyphs[ch];
+        if (glyph.source.w > 0) {
+            SDL_Rect destination = {penX + glyph.offsetX, y, glyph.source.w, glyph.source.h};
+            addQuad(batch, destination,
+                    float(glyph.source.x) / width, float(glyph.source.y) / height,
+                    float(glyph.source.x + glyph.source.w) / width, float(glyph.source.y + glyph.source.h) / height, color);
+        }
+        penX += glyph.advance;
+        previous = ch;
+    }
+}
+
+SDL_Point RenderBatch::textSize(TTF_Font* font, const std::string& text) {
+    SDL_Point size = {0, 0};
+    if (font) TTF_SizeText(font, text.c_str(), &size.x, &size.y);
+    return size;
+}
+
+void RenderBatch::submitFrame() {
+    RenderThread::submit();
+}
@@ -0,0 +1,38 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+
+// Collects a frame's rects, outlines, textured quads and text and draws them
+// with as few SDL_RenderGeometry calls as possible. A quad joins the latest
+// batch using the same texture unless something drawn since then overlaps
+// it, so the result looks the same as drawing everything in order.
+// Text is drawn from a glyph atlas kept per font, so all text in one font
+// is a single batch whatever its colour.
+// Everything is recorded into the render thread's current frame; nothing
+// here touches the renderer, so it is all called from the game thread.
+class RenderBatch {
+public:
+
+    static void fillRect(const SDL_Rect& rect, SDL_Color color);
+    // Same pixels as SDL_RenderDrawRect, thickness pixels inwards
+    static void drawRect(const SDL_Rect& rect, SDL_Color color, int thickness = 1);
+    static void drawTexture(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect& destination);
+    static void drawText(TTF_Font* font, const std::string& text, SDL_Color color, int x, int y);
+    static SDL_Point textSize(TTF_Font* font, const std::string& text);
+
+    // Ends the frame and hands it to the render thread to draw and present
+    static void submitFrame();
+
+    // Render thread only, as a texture drawTexture may get is created and before
+    // it is published; drawTexture reads the size from here, never from SDL
+    static void recordTextureSize(SDL_Texture* texture, int width, int height);
+    static void forgetTextureSize(SDL_Texture* texture);
+
+    // Destroys the glyph atlases; called by the render thread as it stops
+    static void releaseTextures();
+};
+
+#endif
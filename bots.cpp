@@ -0,0 +1,264 @@
+// Load for the game host: many connections, each playing games one after
+// another with a simple greedy policy, against the host's AI, against itself,
+// or paired up so two connections share each game. Prints the round trip from
+// sending a request to its reply, then the host's own numbers.
+// Usage: bots [--connect address] [--connections N] [--games N] [--points N] [--versus ai|self|paired] [--profile N]
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include "turn_state.h"
+#include "net.h"
+#include "host_protocol.h"
+
+// Banks once the turn is worth this much
+const int BANK_AT = 400;
+
+using Clock = std::chrono::steady_clock;
+
+struct BotOptions {
+    std::string connect = DEFAULT_HOST_ADDRESS;
+    int connections = 8;
+    int games = 100;             // Per connection
+    int points = 10000;
+    std::string versus = "ai";
+    int profile = 0;             // AIProfiles::all() index the host plays
+};
+
+// Games the first of a pair has made, for the second to join; 0 once it stops
+struct Pairing {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<uint32_t> games;
+
+    void give(uint32_t game) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            games.push_back(game);
+        }
+        ready.notify_one();
+    }
+
+    uint32_t take() {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this] { return !games.empty(); });
+        uint32_t game = games.front();
+        games.pop_front();
+        return game;
+    }
+};
+
+struct BotResult {
+    int played = 0;
+    int won = 0;
+    int errors = 0;
+    std::vector<float> roundTrips;   // Milliseconds
+};
+
+TurnAction choose(const TurnState& turn) {
+    TurnAction legal[TurnState::MAX_ACTIONS];
+    int count = turn.legalActions(legal);
+    bool canBank = false;
+    for (int i = 0; i < count; ++i) {
+        if (legal[i].type == TurnAction::ZILCH) return legal[i];
+        canBank |= legal[i].type == TurnAction::BANK;
+    }
+    if (turn.phase == TurnState::FIRST_ROLL) return {TurnAction::ROLL, 0};
+    if (turn.pressed == 0) {
+        for (int i = 0; i < count; ++i) {
+            if (legal[i].type == TurnAction::PRESS) return legal[i];
+        }
+    }
+    if (canBank && turn.softPoints >= BANK_AT) return {TurnAction::BANK, 0};
+    return {TurnAction::ROLL, 0};
+}
+
+class Bot {
+public:
+    Bot(int index, const BotOptions& options, Pairing& pairing, BotResult& result)
+        : index(index), options(options), pairing(pairing), result(result) {}
+
+    void run() {
+        std::string error;
+        fd = Net::connect(options.connect, error);
+        if (fd < 0) {
+            std::cerr << "Bot " << index << " could not connect: " << error << std::endl;
+            result.errors++;
+            return;
+        }
+        for (int i = 0; i < options.games; ++i) {
+            if (!play()) break;
+        }
+        if (options.versus == "paired" && !joins()) pairing.give(0);
+        Net::close(fd);
+    }
+
+private:
+    bool joins() const { return options.versus == "paired" && index % 2 == 1; }
+
+    // False once the connection is no use for another game
+    bool play() {
+        uint32_t game = 0;
+        if (joins()) {
+            game = pairing.take();
+            if (game == 0) return false;
+            send(HOST_JOIN, game, {});
+        } else {
+            NewGameRequest request;
+            request.target = options.points;
+            request.seats[1] = options.versus == "ai" ? SEAT_AI + options.profile
+                             : options.versus == "self" ? SEAT_CLIENT : SEAT_OPEN;
+            send(HOST_NEW_GAME, 0, encodeNewGame(request));
+        }
+
+        bool shared = false;
+        bool acted = false;
+        uint32_t actedAt = 0;    // The game's moves when this bot last sent one
+        Frame frame;
+        while (Net::readFrame(fd, inbox, frame)) {
+            HostView view;
+            bool isState = frame.type == HOST_STATE && decodeHostView(frame.body, view);
+            // A partner's move, or joining, sends a state that may be from before this bot's own move
+            bool stale = isState && acted && view.moves <= actedAt;
+            if (waiting && !stale) {
+                float milliseconds = std::chrono::duration<float, std::milli>(Clock::now() - sentAt).count();
+                result.roundTrips.push_back(milliseconds);
+                waiting = false;
+            }
+            if (frame.type == HOST_ERROR) {
+                int code = frame.body.empty() ? 0 : frame.body[0];
+                if (code != ERROR_OPPONENT_LEFT) std::cerr << "Bot " << index << " got error " << code << std::endl;
+                result.errors++;
+                return code == ERROR_OPPONENT_LEFT;
+            }
+            if (!isState || stale) continue;
+            game = frame.game;
+            if (options.versus == "paired" && !joins() && !shared) {
+                pairing.give(game);
+                shared = true;
+            }
+            if (view.gameOver) {
+                result.played++;
+                if (view.winner < 2 && (view.yourSeats & (1 << view.winner))) result.won++;
+                return true;
+            }
+            if (view.yourSeats & (1 << view.currentSeat)) {
+                acted = true;
+                actedAt = view.moves;
+                send(HOST_ACTION, game, encodeHostAction(choose(view.turn)));
+            }
+        }
+        std::cerr << "Bot " << index << " lost the host" << std::endl;
+        result.errors++;
+        return false;
+    }
+
+    void send(uint8_t type, uint32_t game, std::vector<uint8_t> body) {
+        Frame frame;
+        frame.type = type;
+        frame.game = game;
+        frame.body = std::move(body);
+        sentAt = Clock::now();
+        waiting = true;
+        Net::sendFrame(fd, frame);
+    }
+
+    int index;
+    const BotOptions& options;
+    Pairing& pairing;
+    BotResult& result;
+    int fd = -1;
+    std::vector<uint8_t> inbox;
+    Clock::time_point sentAt;
+    bool waiting = false;        // For the reply to what was sent last
+};
+
+bool parseOptions(int argc, char* argv[], BotOptions& options) {
+    if ((argc - 1) % 2 != 0) return false;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--connect") options.connect = value;
+        else if (flag == "--connections") options.connections = std::atoi(value);
+        else if (flag == "--games") options.games = std::atoi(value);
+        else if (flag == "--points") options.points = std::atoi(value);
+        else if (flag == "--versus") options.versus = value;
+        else if (flag == "--profile") options.profile = std::atoi(value);
+        else return false;
+    }
+    if (options.versus != "ai" && options.versus != "self" && options.versus != "paired") return false;
+    if (options.versus == "paired" && options.connections % 2 != 0) return false;
+    return options.connections > 0 && options.games > 0 && options.points > 0 && options.profile >= 0;
+}
+
+bool fetchStats(const std::string& address, HostStats& stats) {
+    std::string error;
+    int fd = Net::connect(address, error);
+    if (fd < 0) return false;
+    Frame request;
+    request.type = HOST_GET_STATS;
+    std::vector<uint8_t> inbox;
+    Frame reply;
+    bool ok = Net::sendFrame(fd, request) && Net::readFrame(fd, inbox, reply) && reply.type == HOST_STATS &&
+              decodeHostStats(reply.body, stats);
+    Net::close(fd);
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    BotOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: bots [--connect address] [--connections N] [--games N] [--points N] [--versus ai|self|paired] [--profile N]" << std::endl;
+        std::cerr << "Paired bots need an even number of connections" << std::endl;
+        return 1;
+    }
+
+    std::vector<Pairing> pairings(options.connections / 2 + 1);
+    std::vector<BotResult> results(options.connections);
+    std::vector<std::thread> threads;
+    auto start = Clock::now();
+    for (int i = 0; i < options.connections; ++i) {
+        threads.emplace_back([&, i]() { Bot(i, options, pairings[i / 2], results[i]).run(); });
+    }
+    for (std::thread& t : threads) t.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    BotResult total;
+    for (BotResult& result : results) {
+        total.played += result.played;
+        total.won += result.won;
+        total.errors += result.errors;
+        total.roundTrips.insert(total.roundTrips.end(), result.roundTrips.begin(), result.roundTrips.end());
+    }
+    // A paired game is played by two connections but counted by both
+    int games = options.versus == "paired" ? total.played / 2 : total.played;
+    std::cout << "Played " << games << " games over " << options.connections << " connections in " << std::fixed
+              << std::setprecision(1) << seconds << " s (" << std::setprecision(0) << games / seconds
+              << " games/s), " << total.errors << " errors" << std::endl;
+    if (options.versus == "ai" && total.played > 0) {
+        std::cout << "Bots won " << std::setprecision(1) << 100.0 * total.won / total.played << "% against the host" << std::endl;
+    }
+    if (!total.roundTrips.empty()) {
+        std::vector<float>& trips = total.roundTrips;
+        std::sort(trips.begin(), trips.end());
+        std::cout << "Round trips: " << trips.size() << ", p50 " << std::setprecision(3) << trips[trips.size() / 2]
+                  << " ms, p99 " << trips[std::min(trips.size() - 1, trips.size() * 99 / 100)] << " ms" << std::endl;
+    }
+
+    HostStats stats;
+    if (fetchStats(options.connect, stats)) {
+        std::cout << "Host: " << stats.gamesHosted << " games hosted, " << stats.gamesActive << " active, "
+                  << stats.decisions << " decisions (" << std::setprecision(0) << stats.decisionsPerSecond
+                  << "/s), requests p50 " << std::setprecision(3) << stats.p50Milliseconds << " ms, p99 "
+                  << stats.p99Milliseconds << " ms" << std::endl;
+    }
+    return total.errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+#include "columnar.h"
+#include "snapshot.h"
+#include <filesystem>
+
+namespace {
+
+const char MAGIC[4] = {'Z', 'C', 'O', 'L'};
+
+std::vector<uint8_t> encodeHeader(const std::vector<ColumnSpec>& schema) {
+    std::vector<uint8_t> header(MAGIC, MAGIC + sizeof(MAGIC));
+    uint16_t version = ColumnFile::VERSION;
+    uint16_t count = static_cast<uint16_t>(schema.size());
+    header.insert(header.end(), reinterpret_cast<uint8_t*>(&version), reinterpret_cast<uint8_t*>(&version) + sizeof(version));
+    header.insert(header.end(), reinterpret_cast<uint8_t*>(&count), reinterpret_cast<uint8_t*>(&count) + sizeof(count));
+    for (const auto& column : schema) {
+        header.push_back(column.type);
+        header.push_back(static_cast<uint8_t>(column.name.size()));
+        header.insert(header.end(), column.name.begin(), column.name.end());
+    }
+    return header;
+}
+
+}
+
+size_t columnWidth(ColumnType type) {
+    switch (type) {
+        case COLUMN_U8: return 1;
+        case COLUMN_U16: return 2;
+        case COLUMN_I32: return 4;
+        case COLUMN_F32: return 4;
+    }
+    return 0;
+}
+
+
+ColumnBlock::ColumnBlock(const std::vector<ColumnSpec>& schema) : schema(schema), columns(schema.size()) {}
+
+void ColumnBlock::clear() {
+    for (auto& column : columns) column.clear();
+    rows = 0;
+}
+
+
+bool ColumnFile::scan(const std::string& path, const std::vector<ColumnSpec>& schema,
+                      const std::function<void(const ColumnBlockView&)>& visit, uint64_t* validBytes) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    std::vector<uint8_t> header = encodeHeader(schema);
+    if (data.size() < header.size() || std::memcmp(data.data(), header.data(), header.size()) != 0) {
+        return false;
+    }
+
+    size_t rowWidth = 0;
+    for (const auto& column : schema) rowWidth += columnWidth(column.type);
+
+    size_t pos = header.size();
+    ColumnBlockView view;
+    view.columns.resize(schema.size());
+    while (pos + 2 * sizeof(uint32_t) <= data.size()) {
+        uint32_t rows, stored;
+        std::memcpy(&rows, data.data() + pos, sizeof(rows));
+        std::memcpy(&stored, data.data() + pos + sizeof(rows), sizeof(stored));
+        size_t bodySize = static_cast<size_t>(rows) * rowWidth;
+        const uint8_t* body = data.data() + pos + 2 * sizeof(uint32_t);
+        if (pos + 2 * sizeof(uint32_t) + bodySize > data.size()) break;
+        if (stored != Snapshot::checksum(body, bodySize)) break;
+
+        view.rows = rows;
+        const uint8_t* columnStart = body;
+        for (size_t c = 0; c < schema.size(); ++c) {
+            view.columns[c] = columnStart;
+            columnStart += rows * columnWidth(schema[c].type);
+        }
+        visit(view);
+        pos += 2 * sizeof(uint32_t) + bodySize;
+    }
+
+    if (validBytes) *validBytes = pos;
+    return true;
+}
+
+bool ColumnFile::open(const std::string& path, const std::vector<ColumnSpec>& newSchema) {
+    close();
+    schema = newSchema;
+
+    uint64_t validBytes = 0;
+    if (scan(path, schema, [](const ColumnBlockView&) {}, &validBytes)) {
+        // Drop a torn last block before appending
+        std::error_code error;
+        if (std::filesystem::file_size(path, error) != validBytes) {
+            std::filesystem::resize_file(path, validBytes, error);
+        }
+        file.open(path, std::ios::binary | std::ios::app);
+    } else {
+        std::vector<uint8_t> header = encodeHeader(schema);
+        file.open(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(header.data()), header.size());
+        file.flush();
+    }
+    return file.is_open();
+}
+
+void ColumnFile::close() {
+    if (file.is_open()) file.close();
+}
+
+bool ColumnFile::appendBlock(const ColumnBlock& block) {
+    if (block.getRows() == 0) return true;
+
+    // Assemble the block first so it goes out in a single write
+    std::vector<uint8_t> out(2 * sizeof(uint32_t));
+    for (size_t c = 0; c < schema.size(); ++c) {
+        const std::vector<uint8_t>& column = block.getColumn(c);
+        out.insert(out.end(), column.begin(), column.end());
+    }
+    uint32_t rows = block.getRows();
+    uint32_t sum = Snapshot::checksum(out.data() + 2 * sizeof(uint32_t), out.size() - 2 * sizeof(uint32_t));
+    std::memcpy(out.data(), &rows, sizeof(rows));
+    std::memcpy(out.data() + sizeof(rows), &sum, sizeof(sum));
+
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (!file.is_open()) return false;
+    file.write(reinterpret_cast<const char*>(out.data()), out.size());
+    file.flush();
+    return file.good();
+}
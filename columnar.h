@@ -0,0 +1,86 @@
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <functional>
+
+enum ColumnType : uint8_t {
+    COLUMN_U8 = 1,
+    COLUMN_U16 = 2,
+    COLUMN_I32 = 3,
+    COLUMN_F32 = 4
+};
+
+struct ColumnSpec {
+    std::string name;
+    ColumnType type;
+};
+
+size_t columnWidth(ColumnType type);
+
+// Rows buffered column by column in memory until they are written as one block
+class ColumnBlock {
+public:
+    ColumnBlock(const std::vector<ColumnSpec>& schema);
+
+    template <typename T>
+    void put(int column, T value) {
+        std::vector<uint8_t>& data = columns[column];
+        size_t offset = data.size();
+        data.resize(offset + sizeof(T));
+        std::memcpy(data.data() + offset, &value, sizeof(T));
+    }
+    void endRow() { rows++; }
+    void clear();
+
+    uint32_t getRows() const { return rows; }
+    const std::vector<ColumnSpec>& getSchema() const { return schema; }
+    const std::vector<uint8_t>& getColumn(int column) const { return columns[column]; }
+
+private:
+    std::vector<ColumnSpec> schema;
+    std::vector<std::vector<uint8_t>> columns;
+    uint32_t rows = 0;
+};
+
+// Read-only view of one block while scanning a file
+struct ColumnBlockView {
+    uint32_t rows;
+    std::vector<const uint8_t*> columns;
+
+    template <typename T>
+    const T* column(int index) const { return reinterpret_cast<const T*>(columns[index]); }
+};
+
+// Append-only columnar file.
+// Layout:
+//   header: "ZCOL" | u16 version | u16 columnCount | (u8 type, u8 nameLength, name)[columnCount]
+//   blocks: u32 rows | u32 checksum | column 0 values | column 1 values | ...
+// A block cut short by a crash fails its checksum and ends the scan.
+class ColumnFile {
+public:
+    static const uint16_t VERSION = 1;
+
+    // Creates the file, or reopens it for appending if the schema matches
+    bool open(const std::string& path, const std::vector<ColumnSpec>& schema);
+    void close();
+
+    // Safe to call from several threads at once
+    bool appendBlock(const ColumnBlock& block);
+
+    // Calls visit for every complete block. Returns false if the file is missing or has another schema.
+    static bool scan(const std::string& path, const std::vector<ColumnSpec>& schema,
+                     const std::function<void(const ColumnBlockView&)>& visit, uint64_t* validBytes = nullptr);
+
+private:
+    std::ofstream file;
+    std::vector<ColumnSpec> schema;
+    std::mutex writeMutex;
+};
+
+#endif
@@ -0,0 +1,93 @@
+#include "decision_cache.h"
+#include <atomic>
+#include <thread>
+#include <functional>
+
+namespace {
+
+const size_t SLOTS = size_t(1) << DecisionCache::SLOT_BITS;
+const uint64_t FILLED = 1ULL << 63;     // Set in every stored answer, so an empty slot never matches
+const int STRIPES = 16;                 // Counters, so threads rarely count on the same cache line
+
+struct Slot {
+    std::atomic<uint64_t> check{0};     // hash ^ data
+    std::atomic<uint64_t> data{0};
+};
+
+struct alignas(64) Counters {
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+};
+
+Slot slots[SLOTS];
+Counters counters[STRIPES];
+
+Counters& threadCounters() {
+    static thread_local Counters& mine = counters[std::hash<std::thread::id>()(std::this_thread::get_id()) % STRIPES];
+    return mine;
+}
+
+// splitmix64's finalizer
+uint64_t mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+}
+
+
+uint64_t DecisionKey::hash() const {
+    uint64_t dice = kind;
+    for (int face = 0; face <= 6; ++face) dice = dice << 4 | faces[face];
+    uint64_t scores = static_cast<uint32_t>(turnPoints) | uint64_t(static_cast<uint32_t>(ownScore)) << 32;
+    uint64_t context = static_cast<uint32_t>(opponentScore) | uint64_t(static_cast<uint32_t>(target)) << 32;
+
+    uint64_t hash = mix(policy);
+    hash = mix(hash ^ (dice << 16 | zilches << 8 | opponentZilches));
+    hash = mix(hash ^ scores);
+    return mix(hash ^ context);
+}
+
+bool DecisionCache::lookup(const DecisionKey& key, uint64_t& answer) {
+    uint64_t hash = key.hash();
+    const Slot& slot = slots[hash & (SLOTS - 1)];
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    Counters& mine = threadCounters();
+    if (!(data & FILLED) || (check ^ data) != hash) {
+        mine.misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    mine.hits.fetch_add(1, std::memory_order_relaxed);
+    answer = data & ~FILLED;
+    return true;
+}
+
+void DecisionCache::store(const DecisionKey& key, uint64_t answer) {
+    uint64_t hash = key.hash();
+    uint64_t data = answer | FILLED;
+    Slot& slot = slots[hash & (SLOTS - 1)];
+    slot.check.store(hash ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+DecisionCacheStats DecisionCache::getStats() {
+    DecisionCacheStats stats;
+    for (const Counters& stripe : counters) {
+        stats.hits += stripe.hits.load(std::memory_order_relaxed);
+        stats.misses += stripe.misses.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void DecisionCache::clear() {
+    for (Slot& slot : slots) {
+        slot.check.store(0, std::memory_order_relaxed);
+        slot.data.store(0, std::memory_order_relaxed);
+    }
+    for (Counters& stripe : counters) {
+        stripe.hits.store(0, std::memory_order_relaxed);
+        stripe.misses.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef DECISION_CACHE_H
+#define DECISION_CACHE_H
+
+#include <cstdint>
+
+// Everything one AI decision depends on. Scores are kept exact rather than
+// bucketed: every score is a multiple of 50 anyway, and an exact key means a
+// cached answer is always the one the AI would have worked out.
+struct DecisionKey {
+    enum Kind : uint8_t { HOLD = 1, BANK = 2 };
+
+    uint64_t policy = 0;        // Whose decision, e.g. ValueModel::getId()
+    Kind kind = HOLD;
+    uint8_t faces[7] = {};      // HOLD: unheld dice showing each face. BANK: faces[0] is the dice the next roll uses
+    int turnPoints = 0;
+    int ownScore = 0;
+    int opponentScore = 0;
+    int target = 0;
+    uint8_t zilches = 0;
+    uint8_t opponentZilches = 0;
+
+    uint64_t hash() const;
+};
+
+struct DecisionCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    double hitRate() const { return hits + misses ? static_cast<double>(hits) / (hits + misses) : 0; }
+};
+
+// Transposition table shared by every AI player on every thread: a fixed number
+// of slots, each answer overwriting whatever was in its slot before.
+// Nothing is locked. A slot is two words written one after the other, the key
+// folded into the first, so a lookup that races a store sees a key that does not
+// match and counts as a miss. Keys are 64-bit hashes; two situations sharing one
+// is as unlikely as it gets.
+class DecisionCache {
+public:
+    static const int SLOT_BITS = 16;    // 1 MB
+
+    // An answer is up to 63 bits, e.g. a hold mask
+    static bool lookup(const DecisionKey& key, uint64_t& answer);
+    static void store(const DecisionKey& key, uint64_t answer);
+
+    // Summed over all threads
+    static DecisionCacheStats getStats();
+    static void clear();
+};
+
+#endif
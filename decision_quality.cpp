@@ -0,0 +1,107 @@
+#include "decision_quality.h"
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <mutex>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+const std::string QUALITY_FILE = "decision_quality.json";
+// Held while a game is added; the file itself is replaced by rename, so it cannot carry the lock
+const std::string QUALITY_LOCK = "decision_quality.json.lock";
+
+// What getPlayers last read, and the modification time it was read at
+std::mutex cacheMutex;
+std::vector<PlayerQuality> cache;
+timespec cachedTime = {-1, 0};
+
+void sortByRated(std::vector<PlayerQuality>& players) {
+    std::stable_sort(players.begin(), players.end(),
+                     [](const PlayerQuality& a, const PlayerQuality& b) { return a.rated > b.rated; });
+}
+
+std::vector<PlayerQuality> readPlayers() {
+    std::vector<PlayerQuality> players;
+    std::ifstream file(QUALITY_FILE);
+    if (!file.is_open()) return players;
+    nlohmann::json jsonData = nlohmann::json::parse(file, nullptr, false);
+    if (jsonData.is_discarded() || !jsonData.contains("players") || !jsonData["players"].is_object()) return players;
+
+    for (const auto& entry : jsonData["players"].items()) {
+        const nlohmann::json& totals = entry.value();
+        if (!totals.is_object()) continue;
+        PlayerQuality player;
+        player.name = entry.key();
+        player.rated = totals.value("rated", 0);
+        player.best = totals.value("best", 0);
+        player.pointsGivenUp = totals.value("pointsGivenUp", 0);
+        players.push_back(player);
+    }
+    sortByRated(players);
+    return players;
+}
+
+bool writePlayers(const std::vector<PlayerQuality>& players) {
+    nlohmann::ordered_json jsonData;
+    jsonData["players"] = nlohmann::ordered_json::object();
+    for (const PlayerQuality& player : players) {
+        nlohmann::ordered_json& totals = jsonData["players"][player.name];
+        totals["rated"] = player.rated;
+        totals["best"] = player.best;
+        totals["pointsGivenUp"] = player.pointsGivenUp;
+    }
+
+    // Per process, as several instances may write at once
+    std::string tempPath = QUALITY_FILE + ".tmp." + std::to_string(getpid());
+    std::ofstream file(tempPath);
+    file << jsonData.dump(4);
+    file.close();
+    return file && std::rename(tempPath.c_str(), QUALITY_FILE.c_str()) == 0;
+}
+
+}
+
+
+void DecisionQuality::add(const PlayerQuality& game) {
+    int lock = open(QUALITY_LOCK.c_str(), O_RDWR | O_CREAT, 0644);
+    if (lock < 0 || flock(lock, LOCK_EX) != 0) {
+        std::cerr << "Error: Could not lock " << QUALITY_LOCK << ", another instance may overwrite this game.\n";
+    }
+
+    std::vector<PlayerQuality> players = readPlayers();
+    auto it = std::find_if(players.begin(), players.end(),
+                           [&game](const PlayerQuality& player) { return player.name == game.name; });
+    if (it == players.end()) {
+        players.push_back({game.name});
+        it = players.end() - 1;
+    }
+    it->rated += game.rated;
+    it->best += game.best;
+    it->pointsGivenUp += game.pointsGivenUp;
+
+    // The ones who have played least make way
+    sortByRated(players);
+    if (players.size() > MAX_PLAYERS) players.resize(MAX_PLAYERS);
+    if (!writePlayers(players)) std::cerr << "Error: Could not write " << QUALITY_FILE << ".\n";
+
+    if (lock >= 0) close(lock);     // Releases the lock too
+}
+
+std::vector<PlayerQuality> DecisionQuality::getPlayers() {
+    struct stat info;
+    timespec modified = {-1, 0};
+    if (stat(QUALITY_FILE.c_str(), &info) == 0) modified = info.st_mtim;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (modified.tv_sec != cachedTime.tv_sec || modified.tv_nsec != cachedTime.tv_nsec) {
+        cache = readPlayers();
+        cachedTime = modified;
+    }
+    return cache;
+}
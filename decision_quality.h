@@ -0,0 +1,30 @@
+#ifndef DECISION_QUALITY_H
+#define DECISION_QUALITY_H
+
+#include <string>
+#include <vector>
+
+// How close one person's holds and banks came to the best ones (see regret.h)
+struct PlayerQuality {
+    std::string name;
+    int rated = 0;
+    int best = 0;
+    int pointsGivenUp = 0;
+};
+
+// Decision Quality totals by player name, in decision_quality.json rather than
+// the shared statistics segment, whose slots are fixed: any number of names
+// fit, and only the MAX_PLAYERS with the most rated decisions are kept.
+// Updates are read, changed and written back under a lock file, so instances
+// adding games at once do not lose each other's.
+class DecisionQuality {
+public:
+    static const size_t MAX_PLAYERS = 100;
+
+    // Adds one game's decisions to the player's totals
+    static void add(const PlayerQuality& game);
+    // Every player kept, most rated decisions first; read again only when the file changes
+    static std::vector<PlayerQuality> getPlayers();
+};
+
+#endif
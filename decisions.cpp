@@ -0,0 +1,168 @@
+#include "decisions.h"
+#include "game.h"
+#include "players.h"
+#include "ai_profile.h"
+#include "rules.h"
+
+const std::vector<ColumnSpec> DECISION_SCHEMA = {
+    {"game", COLUMN_I32},
+    {"seat", COLUMN_U8},
+    {"policy", COLUMN_U8},          // Index into decisionPolicyNames()
+    {"target", COLUMN_I32},
+    {"turn", COLUMN_U16},           // The roller's own turns, from 0
+    {"roll", COLUMN_U8},            // Within the turn, from 1
+    {"own_score", COLUMN_I32},
+    {"opponent_score", COLUMN_I32},
+    {"zilches", COLUMN_U8},
+    {"turn_points", COLUMN_I32},    // Before this roll
+    {"dice", COLUMN_U8},            // Dice rolled
+    {"face_1", COLUMN_U8},          // How many of the rolled dice show each face
+    {"face_2", COLUMN_U8},
+    {"face_3", COLUMN_U8},
+    {"face_4", COLUMN_U8},
+    {"face_5", COLUMN_U8},
+    {"face_6", COLUMN_U8},
+    {"legal", COLUMN_I32},          // Hold mask of the buttons offered, 0 for a zilch
+    {"held", COLUMN_I32},           // Hold mask of the buttons pressed
+    {"held_points", COLUMN_I32},
+    {"action", COLUMN_U8},          // A DecisionAction
+    {"turn_result", COLUMN_I32},    // Points banked, or 0 or -500 for a zilch
+    {"won", COLUMN_U8}              // 0 lost, 1 won, 2 tied
+};
+
+std::vector<std::string> decisionPolicyNames() {
+    std::vector<std::string> names = {"human"};
+    for (const AIProfile& profile : AIProfiles::all()) names.push_back(profile.type);
+    return names;
+}
+
+DecisionRecorder::DecisionRecorder(Game& game) : game(game) {}
+
+void DecisionRecorder::onGameEvent(const GameEvent& event) {
+    int seat = event.playerIndex;
+    Player& self = *game.getPlayers()[seat];
+    switch (event.type) {
+        case EVENT_GAME_START:
+            rows.clear();
+            turnStart = 0;
+            turns[0] = turns[1] = 0;
+            open = false;
+            break;
+        case EVENT_ROLL: {
+            close(ACTION_ROLL, self.getSoftPoints());
+
+            DecisionRow row = {};
+            row.game = gameId;
+            row.target = event.winningPoints;
+            row.seat = seat;
+            row.policy = HUMAN_POLICY;
+            if (self.isAIPlayer()) {
+                const AIProfile* profile = AIProfiles::find(self.getAIType());
+                if (profile) row.policy = profile - AIProfiles::all().data() + 1;
+            }
+            row.turn = turns[seat];
+            row.roll = rows.size() > turnStart ? rows.back().roll + 1 : 1;
+            row.ownScore = self.getHardPoints();
+            row.opponentScore = game.getPlayers()[1 - seat]->getHardPoints();
+            row.zilches = self.getZilches();
+            row.turnPoints = self.getSoftPoints();
+            row.dice = event.diceCount;
+            for (const Dice& die : game.getDice()) {
+                if (!die.held) row.faces[die.value]++;
+            }
+            rows.push_back(row);
+            open = true;
+            break;
+        }
+        case EVENT_BANK:
+            close(ACTION_BANK, event.points);
+            endTurn(seat, event.points);
+            break;
+        case EVENT_ZILCH:
+            close(ACTION_ZILCH, 0);
+            endTurn(seat, event.points);
+            break;
+        case EVENT_GAME_END:
+            for (DecisionRow& row : rows) {
+                int own = event.scores[row.seat], opponent = event.scores[1 - row.seat];
+                row.won = own > opponent ? 1 : (own == opponent ? 2 : 0);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// The buttons of the roll are still up until the next roll replaces them or the turn ends
+void DecisionRecorder::close(DecisionAction action, int softPoints) {
+    if (!open) return;
+    open = false;
+    DecisionRow& row = rows.back();
+    row.action = action;
+    for (Button& btn : game.getHoldButtons()) {
+        int id = holdButtonId(btn.getLabel());
+        if (id < 0) continue;       // ZILCH
+        row.legal |= 1 << id;
+        if (btn.getSelected()) row.held |= 1 << id;
+    }
+    row.heldPoints = action == ACTION_ZILCH ? 0 : softPoints - row.turnPoints;
+    // Holding every die rolled brings all six back
+    if (action == ACTION_ROLL && holdMaskValue(row.held).dice == row.dice) row.action = ACTION_FREE_ROLL;
+}
+
+void DecisionRecorder::endTurn(int seat, int result) {
+    for (size_t i = turnStart; i < rows.size(); ++i) rows[i].turnResult = result;
+    turnStart = rows.size();
+    turns[seat]++;
+}
+
+void DecisionRecorder::appendRows(const std::vector<DecisionRow>& rows, ColumnBlock& block) {
+    for (const DecisionRow& row : rows) {
+        block.put<int32_t>(COL_GAME, row.game);
+        block.put<uint8_t>(COL_SEAT, row.seat);
+        block.put<uint8_t>(COL_POLICY, row.policy);
+        block.put<int32_t>(COL_TARGET, row.target);
+        block.put<uint16_t>(COL_TURN, row.turn);
+        block.put<uint8_t>(COL_ROLL, row.roll);
+        block.put<int32_t>(COL_OWN_SCORE, row.ownScore);
+        block.put<int32_t>(COL_OPPONENT_SCORE, row.opponentScore);
+        block.put<uint8_t>(COL_ZILCHES, row.zilches);
+        block.put<int32_t>(COL_TURN_POINTS, row.turnPoints);
+        block.put<uint8_t>(COL_DICE, row.dice);
+        for (int face = 1; face <= 6; ++face) block.put<uint8_t>(COL_FACE_1 + face - 1, row.faces[face]);
+        block.put<int32_t>(COL_LEGAL, row.legal);
+        block.put<int32_t>(COL_HELD, row.held);
+        block.put<int32_t>(COL_HELD_POINTS, row.heldPoints);
+        block.put<uint8_t>(COL_ACTION, row.action);
+        block.put<int32_t>(COL_TURN_RESULT, row.turnResult);
+        block.put<uint8_t>(COL_WON, row.won);
+        block.endRow();
+    }
+}
+
+bool DecisionRecorder::readRows(const std::string& path, std::vector<DecisionRow>& rows) {
+    return ColumnFile::scan(path, DECISION_SCHEMA, [&rows](const ColumnBlockView& block) {
+        for (uint32_t r = 0; r < block.rows; ++r) {
+            DecisionRow row = {};
+            row.game = block.column<int32_t>(COL_GAME)[r];
+            row.seat = block.column<uint8_t>(COL_SEAT)[r];
+            row.policy = block.column<uint8_t>(COL_POLICY)[r];
+            row.target = block.column<int32_t>(COL_TARGET)[r];
+            row.turn = block.column<uint16_t>(COL_TURN)[r];
+            row.roll = block.column<uint8_t>(COL_ROLL)[r];
+            row.ownScore = block.column<int32_t>(COL_OWN_SCORE)[r];
+            row.opponentScore = block.column<int32_t>(COL_OPPONENT_SCORE)[r];
+            row.zilches = block.column<uint8_t>(COL_ZILCHES)[r];
+            row.turnPoints = block.column<int32_t>(COL_TURN_POINTS)[r];
+            row.dice = block.column<uint8_t>(COL_DICE)[r];
+            for (int face = 1; face <= 6; ++face) row.faces[face] = block.column<uint8_t>(COL_FACE_1 + face - 1)[r];
+            row.legal = block.column<int32_t>(COL_LEGAL)[r];
+            row.held = block.column<int32_t>(COL_HELD)[r];
+            row.heldPoints = block.column<int32_t>(COL_HELD_POINTS)[r];
+            row.action = block.column<uint8_t>(COL_ACTION)[r];
+            row.turnResult = block.column<int32_t>(COL_TURN_RESULT)[r];
+            row.won = block.column<uint8_t>(COL_WON)[r];
+            rows.push_back(row);
+        }
+    });
+}
@@ -0,0 +1,73 @@
+#ifndef DECISIONS_H
+#define DECISIONS_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "events.h"
+#include "columnar.h"
+
+class Game;
+
+// Finished games of the main game, one row per roll, for the regret analyzer
+const std::string PLAYED_GAMES_FILE = "games.col";
+
+enum DecisionColumn {
+    COL_GAME, COL_SEAT, COL_POLICY, COL_TARGET, COL_TURN, COL_ROLL,
+    COL_OWN_SCORE, COL_OPPONENT_SCORE, COL_ZILCHES, COL_TURN_POINTS, COL_DICE,
+    COL_FACE_1, COL_FACE_2, COL_FACE_3, COL_FACE_4, COL_FACE_5, COL_FACE_6,
+    COL_LEGAL, COL_HELD, COL_HELD_POINTS, COL_ACTION, COL_TURN_RESULT, COL_WON
+};
+
+extern const std::vector<ColumnSpec> DECISION_SCHEMA;
+
+enum DecisionAction : uint8_t {
+    ACTION_ROLL = 0,        // Rolled the dice left
+    ACTION_BANK = 1,
+    ACTION_ZILCH = 2,       // Nothing scored
+    ACTION_FREE_ROLL = 3    // Every die held, so all six were rolled again
+};
+
+// Policy 0 is a person; policy i + 1 is AIProfiles::all()[i]
+const int HUMAN_POLICY = 0;
+std::vector<std::string> decisionPolicyNames();
+
+// One roll and what the player did with it
+struct DecisionRow {
+    int32_t game, target;
+    uint8_t seat, policy, roll, zilches, dice, action, won;
+    uint8_t faces[7];               // faces[1] to [6]: how many of the rolled dice show each face
+    uint16_t turn;
+    int32_t ownScore, opponentScore, turnPoints, legal, held, heldPoints, turnResult;
+};
+
+// Follows a game through its events and writes down every roll. A row is closed
+// when the player rolls again, banks or zilches, reading the offered and pressed
+// hold buttons at that moment, so a hand taken back before rolling is not counted.
+class DecisionRecorder {
+public:
+    explicit DecisionRecorder(Game& game);
+
+    void onGameEvent(const GameEvent& event);
+    void setGameId(int32_t id) { gameId = id; }
+
+    // The rows of the game in progress, or of the last one until the next starts
+    const std::vector<DecisionRow>& getRows() const { return rows; }
+
+    static void appendRows(const std::vector<DecisionRow>& rows, ColumnBlock& block);
+    // Every row of a decisions file; false if it is missing or has another schema
+    static bool readRows(const std::string& path, std::vector<DecisionRow>& rows);
+
+private:
+    void close(DecisionAction action, int softPoints);   // softPoints after the holds
+    void endTurn(int seat, int result);
+
+    Game& game;
+    int32_t gameId = 0;
+    std::vector<DecisionRow> rows;
+    size_t turnStart = 0;       // First row of the turn in progress
+    int turns[2] = {0, 0};
+    bool open = false;
+};
+
+#endif
@@ -0,0 +1,115 @@
+#include "dirty_rects.h"
+
+namespace {
+
+const uint64_t EMPTY_TILE = 0xcbf29ce484222325ULL;
+
+// Past this share of the window one rectangle for all of it is cheaper than many
+const float FULL_REDRAW_FRACTION = 0.6f;
+
+uint64_t mix(uint64_t tile, uint64_t quad) {
+    return (tile ^ quad) * 0x100000001b3ULL;
+}
+
+}
+
+
+void DirtyRects::resize(int newWidth, int newHeight) {
+    width = newWidth;
+    height = newHeight;
+    columns = (width + TILE_SIZE - 1) / TILE_SIZE;
+    rows = (height + TILE_SIZE - 1) / TILE_SIZE;
+    previous.assign(columns * rows, EMPTY_TILE);
+    current.assign(columns * rows, EMPTY_TILE);
+    everything = true;
+}
+
+void DirtyRects::beginFrame() {
+    current.assign(columns * rows, EMPTY_TILE);
+}
+
+void DirtyRects::addQuad(const SDL_Rect& bounds, uint64_t hash) {
+    if (bounds.w <= 0 || bounds.h <= 0) return;
+    int firstColumn = bounds.x / TILE_SIZE;
+    int lastColumn = (bounds.x + bounds.w - 1) / TILE_SIZE;
+    int firstRow = bounds.y / TILE_SIZE;
+    int lastRow = (bounds.y + bounds.h - 1) / TILE_SIZE;
+    if (firstColumn < 0) firstColumn = 0;
+    if (firstRow < 0) firstRow = 0;
+    if (lastColumn >= columns) lastColumn = columns - 1;
+    if (lastRow >= rows) lastRow = rows - 1;
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            uint64_t& tile = current[row * columns + column];
+            tile = mix(tile, hash);
+        }
+    }
+}
+
+const std::vector<SDL_Rect>& DirtyRects::endFrame() {
+    rects.clear();
+    int dirtyTiles = 0;
+    for (size_t i = 0; i < current.size(); ++i) {
+        if (current[i] != previous[i]) dirtyTiles++;
+    }
+
+    if (everything || dirtyTiles > FULL_REDRAW_FRACTION * columns * rows) {
+        if (dirtyTiles > 0 || everything) rects.push_back({0, 0, width, height});
+    } else if (dirtyTiles > 0) {
+        // Runs of changed tiles along each row, grown downwards while the row below has the same run
+        size_t openFrom = 0;
+        for (int row = 0; row < rows; ++row) {
+            size_t rowStart = rects.size();
+            int column = 0;
+            while (column < columns) {
+                if (current[row * columns + column] == previous[row * columns + column]) {
+                    column++;
+                    continue;
+                }
+                int start = column;
+                while (column < columns && current[row * columns + column] != previous[row * columns + column]) column++;
+
+                SDL_Rect run = {start * TILE_SIZE, row * TILE_SIZE, (column - start) * TILE_SIZE, TILE_SIZE};
+                bool merged = false;
+                for (size_t i = openFrom; i < rowStart; ++i) {
+                    SDL_Rect& above = rects[i];
+                    if (above.x == run.x && above.w == run.w && above.y + above.h == run.y) {
+                        above.h += TILE_SIZE;
+                        merged = true;
+                        break;
+                    }
+                }
+                if (!merged) rects.push_back(run);
+            }
+            // Only rectangles reaching this row can be grown by the next one
+            size_t firstOpen = rects.size();
+            for (size_t i = openFrom; i < rects.size(); ++i) {
+                if (rects[i].y + rects[i].h == (row + 1) * TILE_SIZE) {
+                    firstOpen = i;
+                    break;
+                }
+            }
+            openFrom = firstOpen;
+        }
+
+        // The last row and column of tiles may hang over the window
+        for (SDL_Rect& rect : rects) {
+            if (rect.x + rect.w > width) rect.w = width - rect.x;
+            if (rect.y + rect.h > height) rect.h = height - rect.y;
+        }
+    }
+
+    everything = false;
+    previous.swap(current);
+    return rects;
+}
+
+float DirtyRects::getDirtyFraction() const {
+    if (width <= 0 || height <= 0) return 0;
+    long long area = 0;
+    for (const SDL_Rect& rect : rects) {
+        area += static_cast<long long>(rect.w) * rect.h;
+    }
+    return static_cast<float>(area) / (static_cast<float>(width) * height);
+}
@@ -0,0 +1,39 @@
+#ifndef DIRTY_RECTS_H
+#define DIRTY_RECTS_H
+
+#include <SDL.h>
+#include <cstdint>
+#include <vector>
+
+// Finds the parts of the window that differ from the last frame.
+// The window is cut into tiles and every quad drawn mixes a hash of itself
+// into the tiles it covers, in drawing order; a tile whose hash changed must
+// be redrawn. Changed tiles are merged into as few rectangles as is cheap.
+class DirtyRects {
+public:
+    static const int TILE_SIZE = 40;
+
+    void resize(int width, int height);
+    // The next frame is redrawn in full (first frame, window exposed)
+    void invalidate() { everything = true; }
+
+    void beginFrame();
+    void addQuad(const SDL_Rect& bounds, uint64_t hash);
+    // The rectangles to redraw and present; empty if nothing changed
+    const std::vector<SDL_Rect>& endFrame();
+
+    // Share of the window in the last endFrame()'s rectangles, 0 to 1
+    float getDirtyFraction() const;
+
+private:
+    int width = 0;
+    int height = 0;
+    int columns = 0;
+    int rows = 0;
+    bool everything = true;
+    std::vector<uint64_t> previous;
+    std::vector<uint64_t> current;
+    std::vector<SDL_Rect> rects;
+};
+
+#endif
@@ -0,0 +1,106 @@
+// Two processes playing one game in lockstep over a local socket, with no
+// window: start one with --host and the other with --join on the same address.
+// Each plays its own seat with random moves from a generator of its own, so
+// only the moves sent keep the two games the same; any difference shows up as
+// a hash that does not match.
+// Usage: duel (--host address | --join address) [--points N] [--name name]
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <random>
+#include <cstdlib>
+#include <algorithm>
+#include "game.h"
+#include "animation.h"
+#include "turn_state.h"
+#include "lockstep.h"
+
+// Waiting longer than this for the other player's move means they are gone
+const int MOVE_TIMEOUT_MILLISECONDS = 10000;
+
+struct DuelOptions {
+    bool hosting = false;
+    std::string address;
+    int points = 10000;
+    std::string name;
+};
+
+bool parseOptions(int argc, char* argv[], DuelOptions& options) {
+    if ((argc - 1) % 2 != 0) return false;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--host" || flag == "--join") {
+            options.hosting = flag == "--host";
+            options.address = value;
+        } else if (flag == "--points") options.points = std::atoi(value);
+        else if (flag == "--name") options.name = value;
+        else return false;
+    }
+    if (options.name.empty()) options.name = options.hosting ? "Host" : "Guest";
+    return !options.address.empty() && options.points > 0;
+}
+
+int main(int argc, char* argv[]) {
+    DuelOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: duel (--host address | --join address) [--points N] [--name name]" << std::endl;
+        return 1;
+    }
+    // Every move lands at once, with no dice tumble
+    Animation::setEnabled(false);
+
+    Game game;
+    Lockstep lockstep;
+    std::string error;
+    if (options.hosting) std::cout << "Waiting for the other player on " << options.address << std::endl;
+    bool started = options.hosting ? lockstep.host(options.address, game, options.name, options.points, error)
+                                   : lockstep.join(options.address, game, options.name, error);
+    // Nothing else to do here until the other player is there
+    while (started && lockstep.getStatus() == Lockstep::CONNECTING) {
+        started = lockstep.pollStart(error, MOVE_TIMEOUT_MILLISECONDS);
+    }
+    if (!started) {
+        std::cerr << "Could not start: " << error << std::endl;
+        return 1;
+    }
+
+    std::mt19937 moves{std::random_device{}()};
+    TurnAction legal[TurnState::MAX_ACTIONS];
+    TurnAction action;
+    int played = 0;
+    while (lockstep.isPlaying() && !game.checkGameEnd()) {
+        if (lockstep.isLocalTurn()) {
+            int count = TurnState::fromGame(game, 0).legalActions(legal);
+            action = legal[std::uniform_int_distribution<int>(0, count - 1)(moves)];
+            playAction(game, action);
+            lockstep.played(action);
+            played++;
+        } else if (lockstep.takeRemote(action, MOVE_TIMEOUT_MILLISECONDS)) {
+            playAction(game, action);
+        } else if (!lockstep.isLocalTurn()) {
+            break;      // Nothing came
+        }
+    }
+    // The hash after the other player's winning move
+    if (lockstep.isPlaying() && game.checkGameEnd()) lockstep.takeRemote(action, 100);
+
+    std::vector<std::unique_ptr<Player>>& players = game.getPlayers();
+    if (lockstep.getStatus() == Lockstep::DESYNCED) {
+        std::cerr << "Out of sync with the other player after " << lockstep.getMoves() << " moves" << std::endl;
+        return 1;
+    }
+    if (!game.checkGameEnd()) {
+        std::cerr << "The other player left after " << lockstep.getMoves() << " moves" << std::endl;
+        return 1;
+    }
+    std::cout << players[0]->getName() << " " << players[0]->getHardPoints() << ", " << players[1]->getName() << " "
+              << players[1]->getHardPoints() << " after " << lockstep.getMoves() << " moves: " << game.getWinningPlayerName()
+              << std::endl;
+    std::cout << "Sent " << lockstep.getBytesSent() << " bytes for " << played << " moves, " << std::fixed
+              << std::setprecision(1) << static_cast<double>(lockstep.getBytesSent()) / std::max(played, 1)
+              << " a move with the hashes; " << lockstep.getHashesMatched() << " hashes from the other side matched"
+              << std::endl;
+    std::cout << "Final state hash " << std::hex << Lockstep::stateHash(game) << std::endl;
+    return 0;
+}
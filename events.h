@@ -0,0 +1,33 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <string>
+#include <functional>
+
+enum GameEventType {
+    EVENT_GAME_START,
+    EVENT_ROLL,
+    EVENT_HOLD,
+    EVENT_BANK,
+    EVENT_ZILCH,
+    EVENT_GAME_END,
+    EVENT_GAME_RESUME,      // Loaded from a snapshot part way through
+    EVENT_TYPE_COUNT
+};
+
+// Something that happened in a game, sent to every listener added with Game::addEventListener
+struct GameEvent {
+    GameEventType type;
+    int playerIndex;          // Player the event belongs to
+    bool isAI;                // Whether that player is an AI
+    std::string hand;         // EVENT_HOLD: label of the hand held
+    int points;               // Points held, banked, or lost to a zilch penalty
+    int diceCount;            // Dice rolled (EVENT_ROLL) or held (EVENT_HOLD)
+    int scores[2];            // Hard points of players 0 and 1 after the event
+    int winningPoints;
+    std::string opponentType; // AI type of player 1, empty in 2 player games
+};
+
+using GameEventListener = std::function<void(const GameEvent&)>;
+
+#endif
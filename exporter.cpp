@@ -0,0 +1,136 @@
+// Training data exporter: plays headless games between every pair of AI
+// profiles across every core and writes one row per roll to a columnar file:
+// the position, the holds Game::getPossibleHolds offered, what the AI held and
+// did next, and how the turn and the game ended. A JSON file next to it names
+// the policies and the hold mask bits.
+// Usage: exporter [--games N] [--threads N] [--points N] [--seed N] [--out file]
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+#include "game.h"
+#include "players.h"
+#include "animation.h"
+#include "ai_profile.h"
+#include "columnar.h"
+#include "decisions.h"
+#include "rules.h"
+#include "decision_cache.h"
+#include "match_runner.h"
+
+// Rows each thread gathers before writing them out as one block
+const uint32_t BLOCK_ROWS = 1 << 16;
+
+struct ExporterOptions {
+    int games = 100000;
+    int threads = 0;             // 0 for one per core
+    int points = 10000;
+    uint64_t seed = 0;
+    std::string out = "decisions.col";
+};
+
+// Every ordered pair of policies, each seat first in turn, on dice of their own
+void playGame(const ExporterOptions& options, int gameNumber, ColumnBlock& block) {
+    const std::vector<AIProfile>& policies = AIProfiles::all();
+    int policyOf[2] = {static_cast<int>(gameNumber % policies.size()),
+                       static_cast<int>((gameNumber / policies.size()) % policies.size())};
+
+    const AIProfile* seats[2] = {&policies[policyOf[0]], &policies[policyOf[1]]};
+    // Seeds a step apart would start the same dice stream one roll later, so each game's is mixed
+    DiceRng seeder(options.seed + gameNumber);
+    uint64_t seed = (static_cast<uint64_t>(seeder.next()) << 32) | seeder.next();
+
+    Game game;
+    MatchRunner::setUp(game, seats, options.points, seed);
+    DecisionRecorder recorder(game);
+    recorder.setGameId(gameNumber);
+    game.addEventListener([&recorder](const GameEvent& event) { recorder.onGameEvent(event); });
+    if (!MatchRunner::play(game)) return;
+    DecisionRecorder::appendRows(recorder.getRows(), block);
+}
+
+// What the numbers in the file stand for
+bool writeLegend(const std::string& path) {
+    nlohmann::ordered_json legend;
+    legend["policies"] = decisionPolicyNames();
+    legend["hold_labels"] = holdButtonLabels();
+    legend["actions"] = {"roll", "bank", "zilch", "free_roll"};
+
+    std::ofstream out(path);
+    out << legend.dump(4) << "\n";
+    return static_cast<bool>(out);
+}
+
+bool parseOptions(int argc, char* argv[], ExporterOptions& options) {
+    if ((argc - 1) % 2 != 0) return false;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--games") options.games = std::atoi(value);
+        else if (flag == "--threads") options.threads = std::atoi(value);
+        else if (flag == "--points") options.points = std::atoi(value);
+        else if (flag == "--seed") options.seed = std::strtoull(value, nullptr, 10);
+        else if (flag == "--out") options.out = value;
+        else return false;
+    }
+    if (options.games <= 0 || options.points <= 0) return false;
+    if (options.threads <= 0) options.threads = std::max(1u, std::thread::hardware_concurrency());
+    if (options.seed == 0) options.seed = static_cast<uint64_t>(std::time(nullptr));
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    AIProfiles::load(AI_PROFILES_FILE);
+    ExporterOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: exporter [--games N] [--threads N] [--points N] [--seed N] [--out file]" << std::endl;
+        return 1;
+    }
+    // No pauses between the AI's moves and no dice tumble: each update plays the next move
+    Animation::setEnabled(false);
+
+    std::remove(options.out.c_str());
+    ColumnFile file;
+    if (!file.open(options.out, DECISION_SCHEMA) || !writeLegend(options.out + ".json")) {
+        std::cerr << "Could not write " << options.out << std::endl;
+        return 1;
+    }
+
+    std::atomic<uint64_t> rowsWritten{0};
+    std::atomic<bool> failed{false};
+    std::vector<ColumnBlock> blocks(options.threads, ColumnBlock(DECISION_SCHEMA));
+    auto flush = [&](ColumnBlock& block) {
+        rowsWritten += block.getRows();
+        if (!file.appendBlock(block)) failed = true;
+        block.clear();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    MatchRunner::runParallel(options.games, options.threads, [&](size_t game, int worker) {
+        playGame(options, static_cast<int>(game), blocks[worker]);
+        if (blocks[worker].getRows() >= BLOCK_ROWS) flush(blocks[worker]);
+    });
+    for (ColumnBlock& block : blocks) flush(block);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    file.close();
+
+    if (failed) {
+        std::cerr << "Could not write " << options.out << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << rowsWritten << " rows from " << options.games << " games to " << options.out
+              << " in " << std::fixed << std::setprecision(1) << seconds << "s ("
+              << std::setprecision(0) << rowsWritten / seconds << " rows/s on " << options.threads
+              << " threads)" << std::endl;
+    DecisionCacheStats cache = DecisionCache::getStats();
+    std::cout << "Learned AI decisions: " << std::setprecision(1) << cache.hitRate() * 100 << "% of "
+              << cache.hits + cache.misses << " found in the decision cache" << std::endl;
+    return 0;
+}
@@ -1,6 +1,30 @@
 #include "game.h"
 #include "players.h"
 #include "achievements.h"
+#include "snapshot.h"
+#include "assets.h"
+#include "batch.h"
+#include "animation.h"
+#include <cmath>
+
+namespace {
+
+// How long the dice tumble after a roll, and how often their faces change while they do
+const float DICE_TUMBLE_SECONDS = 0.5f;
+const float DICE_FACE_SECONDS = 0.05f;
+const int DICE_TUMBLE_HEIGHT = 12;
+
+// How long soft points take to count up to a new total
+const float SOFT_COUNT_SECONDS = 0.4f;
+
+// Held dice pulse between these highlight thicknesses this many times a second
+const int HELD_PULSE_MIN = 2;
+const int HELD_PULSE_MAX = 4;
+const float HELD_PULSE_RATE = 1.5f;
+
+const float PI = 3.14159265f;
+
+}
 
 // Button struct functions
 bool Button::getSelected() {return hasBeenSelected;}
@@ -14,34 +38,33 @@ bool Button::isClicked(int x, int y)  {
 
 void Button::render(SDL_Renderer* renderer, TTF_Font* font)  {
     // Draw button
-    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-    SDL_RenderFillRect(renderer, &rect);
+    RenderBatch::fillRect(rect, color);
 
     // If selected, draw yellow outline
     if (hasBeenSelected) {
-        SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255); // Yellow
-        SDL_RenderDrawRect(renderer, &rect);
         int thickness = 3;  // Thickness in pixels
-        for (int t = 0; t < thickness; ++t) {
-            SDL_Rect r = {
-                rect.x + t,
-                rect.y + t,
-                rect.w - 2 * t,
-                rect.h - 2 * t
-            };
-            SDL_RenderDrawRect(renderer, &r);
-        }
+        RenderBatch::drawRect(rect, {255, 255, 0, 255}, thickness);
     }
 
     // Render button text
-    SDL_Surface* textSurface = TTF_RenderText_Solid(font, label.c_str(), {255, 255, 255});
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-    SDL_FreeSurface(textSurface);
-    SDL_Rect textRect = {rect.x + 10, rect.y + 10, textSurface->w, textSurface->h};
-    SDL_RenderCopy(renderer, textTexture, nullptr, &textRect);
-    SDL_DestroyTexture(textTexture);
+    RenderBatch::drawText(font, label, {255, 255, 255, 255}, rect.x + 10, rect.y + 10);
+}
+
+
+DiceRng::DiceRng(uint64_t seed) : state(seed) {}
+
+// splitmix64, only needs a single 64-bit word of state
+uint32_t DiceRng::next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return static_cast<uint32_t>((z ^ (z >> 31)) >> 32);
 }
 
+int DiceRng::rollFace() { return next() % 6 + 1; }
+
+int DiceRng::percent() { return next() % 100 + 1; }
+
 
 Dice::Dice(int v, bool h, SDL_Rect r) : value(v), held(h), rect(r) {}
 
@@ -50,9 +73,9 @@ bool Dice::operator==(int v) const {
 }
 
 // Roll the die (set a random value between 1 and 6)
-void Dice::roll() {
+void Dice::roll(DiceRng& rng) {
     if (!held) {
-        value = rand() % 6 + 1;
+        value = rng.rollFace();
     }
 }
 
@@ -85,13 +108,29 @@ bool isStraight(const std::vector<Dice>& dice) {
 
 
 
+RollType rollTypeFromLabel(const std::string& label) {
+    if (label == "Straight") return STRAIGHT;
+    if (label == "Three Pairs") return THREE_PAIRS;
+    if (label == "Nothing") return NOTHING;
+    if (label == "Single 1") return SINGLE_1;
+    if (label == "Double 1") return DOUBLE_1;
+    if (label == "Single 5") return SINGLE_5;
+    if (label == "Double 5") return DOUBLE_5;
+    if (label.rfind("Six ", 0) == 0) return SIX_OF_A_KIND;
+    if (label.rfind("Five ", 0) == 0) return FIVE_OF_A_KIND;
+    if (label.rfind("Four ", 0) == 0) return FOUR_OF_A_KIND;
+    if (label.rfind("Three ", 0) == 0) return THREE_OF_A_KIND;
+    return ZILCH;
+}
+
+
 void Game::toggleHold(int dieIndex) {
     if (dieIndex >= 0 && dieIndex < NUM_DICE) {
         die[dieIndex].held = !die[dieIndex].held;  // Toggle the hold state for the die
     }
 }
 
-void Game::rollDice(SDL_Renderer* renderer, TTF_Font* font, SDL_Texture* bgTexture, SDL_Rect bgRect) {
+void Game::rollDice() {
     //Deactivate lock buttons 
     lockOtherButtons = false;
     reverseLockOtherButtons = false;
@@ -120,90 +159,67 @@ void Game::rollDice(SDL_Renderer* renderer, TTF_Font* font, SDL_Texture* bgTextu
         }
     }
 
-    // Retrieving current player for render purposes
-    std::unique_ptr<Player>& currentPlayer = players[currentPlayerIndex];
-    SDL_Delay(50);
-    int animationFrames = 10;  // Number of frames for the rolling effect
-    for (int frame = 0; frame < animationFrames; ++frame) {
-        for (int i = 0; i < NUM_DICE; ++i) {
-            if (!die[i].held) {
-                die[i].value = (rand() % 6) + 1;  // Random temp value for animation
-            }
-        }
-        SDL_RenderClear(renderer);
-        SDL_RenderCopy(renderer, bgTexture, nullptr, &bgRect); //render background
-        displaySoftScore(renderer, font); // Render the score for soft points
-        displayHardScore(renderer, font); // Render the score for hard points
-
-        // DISPLAY HISTORY
-        
-        displayHistory(renderer, font, currentPlayer);
-
-
-        displayDice(renderer);
-        SDL_Delay(50);  // Short delay to create a rolling effect
-        SDL_RenderPresent(renderer);
-        //SDL_Delay(50);  // Short delay to create a rolling effect
-    }
-
-
-
-
     if(allHeld) {
         // If all dice are held, reset (roll) all dice
         for (int i = 0; i < NUM_DICE; ++i) {
             previousHeldDice.clear();
             die[i].held = false;
-            die[i].roll();  // Roll all dice again
+            die[i].roll(rng);  // Roll all dice again
         }
     } else {
         // If not all dice are held, roll only the unheld dice
         for (int i = 0; i < NUM_DICE; ++i) {
             if (!die[i].held) {  // Only roll dice that are NOT held
-                die[i].roll();   // Call the roll method of Dice to generate a random number between 1 and 6
+                die[i].roll(rng);   // Call the roll method of Dice to generate a random number between 1 and 6
             }
         }
     }
+
+    int diceRolled = 0;
+    for (int i = 0; i < NUM_DICE; ++i) {
+        if (!die[i].held) diceRolled++;
+    }
+    emitEvent(EVENT_ROLL, 0, diceRolled);
+
+    // The result is decided; the dice only look like they are still rolling
+    diceTumble.start(0, 1, DICE_TUMBLE_SECONDS, EASE_LINEAR);
 }
 
 
 void Game::displayDice(SDL_Renderer* renderer) {
     int x = 100;
-    for (int i = 0; i < NUM_DICE; ++i) {
-        // Select the correct dice face image
-        std::string imagePath = "assets/textures/" + std::to_string(die[i].value) + "-face.png";
-        SDL_Surface* diceSurface = IMG_Load(imagePath.c_str());
+    // Tumbling dice show a new made-up face every few hundredths of a second and bounce as they settle
+    bool tumbling = isRolling();
+    int faceStep = static_cast<int>(diceTumble.elapsed() / DICE_FACE_SECONDS);
+    float settle = diceTumble.progress();
+    int lift = static_cast<int>(DICE_TUMBLE_HEIGHT * std::fabs(std::sin(settle * PI * 3)) * (1 - settle));
+
+    // Held dice pulse so they stand out from the ones about to be rolled
+    float pulse = 0.5f + 0.5f * std::sin(static_cast<float>(Animation::now()) * HELD_PULSE_RATE * 2 * PI);
+    if (!Animation::isEnabled()) pulse = 0;
 
-        if (!diceSurface) {
-            std::cerr << "Failed to load image: " << imagePath << " SDL_image Error: " << IMG_GetError() << std::endl;
-            continue;  // Skip rendering this die if the image fails to load
+    for (int i = 0; i < NUM_DICE; ++i) {
+        int value = die[i].value;
+        int y = 200;
+        if (tumbling && !die[i].held) {
+            value = (faceStep * 7 + i * 3 + value) % 6 + 1;  // Cosmetic only
+            y -= lift;
         }
 
-        SDL_Texture* diceTexture = SDL_CreateTextureFromSurface(renderer, diceSurface);
-        SDL_FreeSurface(diceSurface);  // Free surface after creating texture
+        // Select the correct dice face image (nothing is drawn until it has loaded)
+        Sprite face = Assets::getDieSprite(value);
 
         // Resize the image to 50x50 pixels
-        SDL_Rect diceRect = {x, 200, 75, 75};
+        SDL_Rect diceRect = {x, y, 75, 75};
 
-        SDL_RenderCopy(renderer, diceTexture, nullptr, &diceRect);
-
-        SDL_DestroyTexture(diceTexture);  // Destroy texture after rendering
+        RenderBatch::drawTexture(face.texture, &face.rect, diceRect);
 
         // Highlight held dice
         if (die[i].held) {
-            SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);  // Yellow border
-            SDL_Rect highlightRect = {x-2, 198, 79, 79};
-        
-            int thickness = 2;  // Thickness in pixels
-            for (int t = 0; t < thickness; ++t) {
-                SDL_Rect r = {
-                    highlightRect.x + t,
-                    highlightRect.y + t,
-                    highlightRect.w - 2 * t,
-                    highlightRect.h - 2 * t
-                };
-                SDL_RenderDrawRect(renderer, &r);
-            }
+            int thickness = HELD_PULSE_MIN + static_cast<int>(std::lround(pulse * (HELD_PULSE_MAX - HELD_PULSE_MIN)));
+            SDL_Rect highlightRect = {x - thickness, 200 - thickness, 75 + 2 * thickness, 75 + 2 * thickness};
+            Uint8 green = static_cast<Uint8>(200 + 55 * pulse);
+            RenderBatch::drawRect(highlightRect, {255, green, 0, 255}, thickness);  // Yellow border
         }
 
         x += 90;  // Offset for the next die
@@ -223,11 +239,27 @@ void Game::addHoldButton(const std::string& text, int x, int y, std::function<vo
 
     holdButtons.push_back(newButton);
 
-    Button& btnRef = holdButtons.back();
-
-    // Now assign the onClick using the button reference
-    btnRef.onClick = [&btnRef, action]() {
-        action(btnRef);
+    // Looked up by index when clicked; a reference would dangle once a later button makes the vector grow
+    size_t index = holdButtons.size() - 1;
+    holdButtons[index].onClick = [this, index, action, text]() {
+        int playerIndex = currentPlayerIndex;
+        int softBefore = players[playerIndex]->getSoftPoints();
+        int heldBefore = 0;
+        for (const auto& d : die) heldBefore += d.held;
+
+        // The action may end the turn and clear the buttons, this closure included
+        Game* game = this;
+        std::string label = text;
+        std::function<void(Button&)> act = action;
+        act(game->holdButtons[index]);
+
+        // Only taking a hand counts as a hold, not releasing it (ZILCH reports itself)
+        int gained = game->players[playerIndex]->getSoftPoints() - softBefore;
+        if (playerIndex == game->currentPlayerIndex && gained > 0) {
+            int heldAfter = 0;
+            for (const auto& d : game->die) heldAfter += d.held;
+            game->emitEvent(EVENT_HOLD, gained, heldAfter - heldBefore, label);
+        }
     };
 }
 
@@ -632,29 +664,7 @@ void Game::getPossibleHolds() {
 
     if (holdButtons.empty()) {
         addHoldButton("ZILCH", startX, startY, [this](Button& btn) {
-            // Increment Zilch
-            players[getCurrentPlayer()]->addZilch();
-            
-
-            // Zilch Pentalty
-            if(players[getCurrentPlayer()]->getZilches() == 3){
-                players[getCurrentPlayer()]->resetZilches();
-
-                players[getCurrentPlayer()]->addToHistory(-500, false);
-                players[getCurrentPlayer()]->addHardPoints(-500);
-            }else{
-                players[getCurrentPlayer()]->addToHistory(0, true);
-            }
-
-            
-            // Reset Soft Points
-            players[getCurrentPlayer()]->resetSoftPoints();
-
-            // Reset Players First Roll
-            players[getCurrentPlayer()]->resetFirstRoll();
-
-            // Next turn starts
-            nextTurn();
+            zilchCurrentPlayer();
         });
     }
 }
@@ -662,7 +672,7 @@ void Game::getPossibleHolds() {
 
 
 ////////////// PLAYERS //////////////
-Game::Game() : currentPlayerIndex(0) {
+Game::Game() : currentPlayerIndex(0), rng(static_cast<uint64_t>(std::time(nullptr))) {
     std::srand(std::time(nullptr));  // Initialize random seed
     die.resize(NUM_DICE);            // Initialize vector for 6 dice
 }
@@ -670,21 +680,52 @@ Game::Game() : currentPlayerIndex(0) {
 
 void Game::addPlayer(std::string name, bool isAI, const std::string& aiType){
     if (isAI) {
-        if (aiType == "aggressive") {
-            players.push_back(std::make_unique<AggressiveAI>(name)); // Store AIPlayer as Aggressive Player*
-        } else if (aiType == "cautious") {
-            players.push_back(std::make_unique<CautiousAI>(name)); // Store AIPlayer as Cautious Player*
-        } else if (aiType == "adaptive") {
-            players.push_back(std::make_unique<AdaptiveAI>(name)); // Store AIPlayer as Adaptive Player*
+        const AIProfile* profile = AIProfiles::find(aiType);
+        if (!profile) {
+            std::cerr << "Error: No AI profile '" << aiType << "', playing " << AIProfiles::all()[0].type << " instead.\n";
+            profile = &AIProfiles::all()[0];
         }
+        addPlayer(name, *profile);
     } else {
         players.push_back(std::make_unique<Player>(name));
     }
 }
 
+void Game::addPlayer(std::string name, const AIProfile& profile){
+    if (profile.valueModel) {
+        players.push_back(std::make_unique<LearnedAI>(name, profile));
+    } else {
+        players.push_back(std::make_unique<ProfileAI>(name, profile));
+    }
+}
+
 void Game::setFirstTurn(){
     gameOver = false; // Safety net to make sure that the game doesn't end immediately
     players[0]->setTurn(true); // Player 1 goes first
+    emitEvent(EVENT_GAME_START);
+    saveSnapshot();
+}
+
+
+////////////// EVENTS //////////////
+void Game::emitEvent(GameEventType type, int points, int diceCount, const std::string& hand){
+    if (eventListeners.empty() || players.size() < 2) return;
+
+    GameEvent event;
+    event.type = type;
+    event.playerIndex = currentPlayerIndex;
+    event.isAI = players[currentPlayerIndex]->isAIPlayer();
+    event.hand = hand;
+    event.points = points;
+    event.diceCount = diceCount;
+    event.scores[0] = players[0]->getHardPoints();
+    event.scores[1] = players[1]->getHardPoints();
+    event.winningPoints = winningPoints;
+    event.opponentType = players[1]->getAIType();
+
+    for (auto& listener : eventListeners) {
+        listener(event);
+    }
 }
 
 
@@ -701,10 +742,15 @@ void Game::nextTurn() {
 
     //CHECK if the game has ended
     if(players[currentPlayerIndex]->getHardPoints() >= winningPoints){
-        gameOver = true;
+        if(!gameOver){
+            gameOver = true;
+            emitEvent(EVENT_GAME_END);
+        }
     }else{
         gameOver = false;
     }
+
+    saveSnapshot();
 }
 
 
@@ -725,25 +771,27 @@ int Game::manyOfAKindPoints(int diceNumber, int numberOfDice) {
 void Game::displaySoftScore(SDL_Renderer* renderer, TTF_Font* font) {
     std::unique_ptr<Player>& currentPlayer = players[currentPlayerIndex];
 
+    // Count up to gains; drops (banking, a zilch, the next turn) show at once
+    int softPoints = currentPlayer->getSoftPoints();
+    if (softPoints != softPointsTarget) {
+        float from = softPoints > softPointsTarget ? softPointsShown.value() : softPoints;
+        softPointsShown.start(from, softPoints, SOFT_COUNT_SECONDS);
+        softPointsTarget = softPoints;
+    }
+
     // Display the soft points of the current player
-    std::string scoreText = "Soft Points: " + std::to_string(currentPlayer->getSoftPoints());
-    SDL_Surface* scoreSurface = TTF_RenderText_Solid(font, scoreText.c_str(), {255, 255, 255});
-    SDL_Texture* scoreTexture = SDL_CreateTextureFromSurface(renderer, scoreSurface);
-    SDL_Rect scoreRect = {200, 75, scoreSurface->w, scoreSurface->h};
-    SDL_RenderCopy(renderer, scoreTexture, nullptr, &scoreRect);
-    SDL_FreeSurface(scoreSurface);
-    SDL_DestroyTexture(scoreTexture);
+    std::string scoreText = "Soft Points: " + std::to_string(std::lround(softPointsShown.value()));
+    RenderBatch::drawText(font, scoreText, {255, 255, 255, 255}, 200, 75);
 }
 
 void Game::displayHardScore(SDL_Renderer* renderer, TTF_Font* font) {
     if (players.size() < 2) return; // Ensure at least two players exist
 
     // Define text color
-    SDL_Color textColor = {255, 255, 255}; // White color
+    SDL_Color textColor = {255, 255, 255, 255}; // White color
 
-    // Get window width to align player 2 to the right
-    int windowWidth;
-    SDL_GetRendererOutputSize(renderer, &windowWidth, nullptr);
+    // The window is kept at its initial size, so align player 2 against that
+    int windowWidth = SCREEN_WIDTH;
 
     // Define spacing
     int padding = 20;
@@ -751,43 +799,20 @@ void Game::displayHardScore(SDL_Renderer* renderer, TTF_Font* font) {
 
     // Display Player 1 (players[0]) - Top-left corner
     std::string player1Name = players[0]->getName();
-    SDL_Surface* surface1Name = TTF_RenderText_Solid(font, player1Name.c_str(), textColor);
-    SDL_Texture* texture1Name = SDL_CreateTextureFromSurface(renderer, surface1Name);
-    SDL_Rect rect1Name = {padding, padding, surface1Name->w, surface1Name->h};
-    SDL_RenderCopy(renderer, texture1Name, nullptr, &rect1Name);
-    SDL_FreeSurface(surface1Name);
-    SDL_DestroyTexture(texture1Name);
+    SDL_Point name1Size = RenderBatch::textSize(font, player1Name);
+    RenderBatch::drawText(font, player1Name, textColor, padding, padding);
 
     std::string player1Score = "Score: " + std::to_string(players[0]->getHardPoints());
-    SDL_Surface* surface1Score = TTF_RenderText_Solid(font, player1Score.c_str(), textColor);
-    SDL_Texture* texture1Score = SDL_CreateTextureFromSurface(renderer, surface1Score);
-    SDL_Rect rect1Score = {padding, rect1Name.y + rect1Name.h + lineSpacing, surface1Score->w, surface1Score->h};
-    SDL_RenderCopy(renderer, texture1Score, nullptr, &rect1Score);
-    SDL_FreeSurface(surface1Score);
-    SDL_DestroyTexture(texture1Score);
+    RenderBatch::drawText(font, player1Score, textColor, padding, padding + name1Size.y + lineSpacing);
 
     // Display Player 2 (players[1]) - Top-right corner
     std::string player2Name = players[1]->getName();
-    SDL_Surface* surface2Name = TTF_RenderText_Solid(font, player2Name.c_str(), textColor);
-    SDL_Texture* texture2Name = SDL_CreateTextureFromSurface(renderer, surface2Name);
-
-    // Store width before freeing surface
-    int player2NameWidth = surface2Name->w;
-
-    SDL_Rect rect2Name = {(windowWidth - player2NameWidth - padding) - 300, padding, surface2Name->w, surface2Name->h};
-    SDL_RenderCopy(renderer, texture2Name, nullptr, &rect2Name);
-    SDL_FreeSurface(surface2Name);
-    SDL_DestroyTexture(texture2Name);
+    SDL_Point name2Size = RenderBatch::textSize(font, player2Name);
+    int player2X = (windowWidth - name2Size.x - padding) - 300;
+    RenderBatch::drawText(font, player2Name, textColor, player2X, padding);
 
     std::string player2Score = "Score: " + std::to_string(players[1]->getHardPoints());
-    SDL_Surface* surface2Score = TTF_RenderText_Solid(font, player2Score.c_str(), textColor);
-    SDL_Texture* texture2Score = SDL_CreateTextureFromSurface(renderer, surface2Score);
-
-    // Use stored width instead of accessing freed memory
-    SDL_Rect rect2Score = {(windowWidth - player2NameWidth - padding) - 300, rect2Name.y + rect2Name.h + lineSpacing, surface2Score->w, surface2Score->h};
-    SDL_RenderCopy(renderer, texture2Score, nullptr, &rect2Score);
-    SDL_FreeSurface(surface2Score);
-    SDL_DestroyTexture(texture2Score);
+    RenderBatch::drawText(font, player2Score, textColor, player2X, padding + name2Size.y + lineSpacing);
 }
 
 void Game::bankCurrentPlayerScore(){
@@ -802,6 +827,8 @@ void Game::bankCurrentPlayerScore(){
         //ADD TO HISTORY
         players[getCurrentPlayer()]->addToHistory(softPoints, false);
 
+        emitEvent(EVENT_BANK, softPoints);
+
         //Reset player's softPoints for the next turn
         players[getCurrentPlayer()]->resetSoftPoints();
 
@@ -817,56 +844,51 @@ void Game::bankCurrentPlayerScore(){
 
 }
 
+void Game::zilchCurrentPlayer(){
+    // Increment Zilch
+    players[getCurrentPlayer()]->addZilch();
 
+    // Zilch Pentalty
+    int penalty = 0;
+    if(players[getCurrentPlayer()]->getZilches() == 3){
+        players[getCurrentPlayer()]->resetZilches();
 
+        players[getCurrentPlayer()]->addToHistory(-500, false);
+        players[getCurrentPlayer()]->addHardPoints(-500);
+        penalty = -500;
+    }else{
+        players[getCurrentPlayer()]->addToHistory(0, true);
+    }
 
+    emitEvent(EVENT_ZILCH, penalty);
 
-////////////// Winning //////////////
-std::string Game::getWinningPlayerName(Achievements& achievements, int statisticsUpdated) {
+    // Reset Soft Points
+    players[getCurrentPlayer()]->resetSoftPoints();
 
-    int P1score = players[0]->getHardPoints();
-    int P2score = players[1]->getHardPoints();
+    // Reset Players First Roll
+    players[getCurrentPlayer()]->resetFirstRoll();
 
-    //Call checkAchievements
-    achievements.checkAchievements(players[0], players[1], winningPoints);
+    // Next turn starts
+    nextTurn();
+}
 
 
-    if (P1score > P2score) {
-        if (players[1]->isAIPlayer() && players[1]->getName() == "Aggressive AI" && statisticsUpdated == 0) {
-            achievements.updateStatistics("Total Wins against AI");
-            achievements.updateStatistics("Wins against Aggressive AI");
-        } else if (players[1]->isAIPlayer() && players[1]->getName() == "Cautious AI" && statisticsUpdated == 0) {
-            achievements.updateStatistics("Total Wins against AI");
-            achievements.updateStatistics("Wins against Cautious AI");
-        } else if (players[1]->isAIPlayer() && players[1]->getName() == "Adaptive AI" && statisticsUpdated == 0) {
-            achievements.updateStatistics("Total Wins against AI");
-            achievements.updateStatistics("Wins against Adaptive AI");
-        }
 
 
-        if (players[1]->isAIPlayer() && statisticsUpdated == 0){
-            achievements.updateStatistics("Total number of Games against AI");
-        }
-    
-        //Update file
-        achievements.saveProgress();
-        return players[0]->getName() + " wins!";
 
+////////////// Winning //////////////
+// Statistics and achievements are handled by listeners of EVENT_GAME_END,
+// so this is safe to call every frame of the game over screen
+std::string Game::getWinningPlayerName() {
+
+    int P1score = players[0]->getHardPoints();
+    int P2score = players[1]->getHardPoints();
+
+    if (P1score > P2score) {
+        return players[0]->getName() + " wins!";
     } else if (P2score > P1score) {
-        if (players[1]->isAIPlayer() && statisticsUpdated == 0){
-            achievements.updateStatistics("Total number of Games against AI");
-        }
-    
-        //Update file
-        achievements.saveProgress();
         return players[1]->getName() + " wins!";
     } else {
-        if (players[1]->isAIPlayer() && statisticsUpdated == 0){
-            achievements.updateStatistics("Total number of Games against AI");
-        }
-    
-        //Update file
-        achievements.saveProgress();
         return "It's a tie!";
     }
 }
@@ -882,11 +904,14 @@ void Game::restartGame(){
     players[1]->clearHistory();
 
     gameOver = false;
+    emitEvent(EVENT_GAME_START);
+    saveSnapshot();
 }
 
 void Game::clearGame(){
     // Clear players
     players.clear();
+    diceTumble = Tween();
     holdButtons.clear();
     previousHeldDice.clear();
     currentPlayerIndex = 0;
@@ -897,6 +922,19 @@ void Game::clearGame(){
     for (int i = 0; i < NUM_DICE; ++i) {
         die[i].held = false;
     }
+
+    // Leaving to the main menu ends the game, so there is nothing to resume
+    if (autoSnapshot) {
+        Snapshot::remove(SNAPSHOT_FILE);
+    }
+}
+
+void Game::saveSnapshot(){
+    if (autoSnapshot && !gameOver) {
+        Snapshot::save(*this, SNAPSHOT_FILE);
+    } else if (autoSnapshot) {
+        Snapshot::remove(SNAPSHOT_FILE);
+    }
 }
 
 bool Game::checkGameEnd(){
@@ -925,28 +963,20 @@ void Game::displayHistory(SDL_Renderer* renderer, TTF_Font* font, std::unique_pt
     // Render the player's name box above the history
     std::string playerName = currentPlayer->getName();
     SDL_Color boxColor = {0, 0, 255, 255}; // Blue color for the box
-    SDL_SetRenderDrawColor(renderer, boxColor.r, boxColor.g, boxColor.b, boxColor.a);
     SDL_Rect nameBox = {x, y - boxHeight - 10, boxWidth, boxHeight}; // Position the box above the history
-    SDL_RenderFillRect(renderer, &nameBox);
+    RenderBatch::fillRect(nameBox, boxColor);
 
     // Set text color for player name (white)
-    SDL_Color textColor = {255, 255, 255};  
-    SDL_Surface* surface = TTF_RenderText_Solid(font, playerName.c_str(), textColor);
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_Color textColor = {255, 255, 255, 255};
 
     // Calculate center of the box to render the text
-    SDL_Rect textRect = {x + (boxWidth - surface->w) / 2, y - boxHeight, surface->w, surface->h};
-    SDL_RenderCopy(renderer, texture, nullptr, &textRect);
-
-    // Free resources
-    SDL_FreeSurface(surface);
-    SDL_DestroyTexture(texture);
+    SDL_Point nameSize = RenderBatch::textSize(font, playerName);
+    RenderBatch::drawText(font, playerName, textColor, x + (boxWidth - nameSize.x) / 2, y - boxHeight);
 
     // Render the history box outline (the white box surrounding the history entries)
     int historyBoxWidth = boxWidth;
     SDL_Rect historyBox = {x, y - 5, historyBoxWidth, 370};  // Add padding around the box
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255); // White color for outline
-    SDL_RenderDrawRect(renderer, &historyBox);
+    RenderBatch::drawRect(historyBox, {255, 255, 255, 255}); // White color for outline
 
     // Get the number of history entries
     int historySize = history.size();
@@ -957,14 +987,7 @@ void Game::displayHistory(SDL_Renderer* renderer, TTF_Font* font, std::unique_pt
         const auto& entry = history[i];
         std::string text = entry.second ? "Zilch" : std::to_string(entry.first) + " pts";
         
-        SDL_Surface* historySurface = TTF_RenderText_Solid(font, text.c_str(), {255, 255, 255});
-        SDL_Texture* historyTexture = SDL_CreateTextureFromSurface(renderer, historySurface);
-        
-        SDL_Rect historyRect = {x + 30, y, historySurface->w, historySurface->h};
-        SDL_RenderCopy(renderer, historyTexture, nullptr, &historyRect);
-        
-        SDL_FreeSurface(historySurface);
-        SDL_DestroyTexture(historyTexture);
+        RenderBatch::drawText(font, text, {255, 255, 255, 255}, x + 30, y);
         
         y += 30;  // Spacing between history entries
     }
@@ -3,6 +3,7 @@
 
 
 #include <cstdlib>
+#include <cstdint>
 #include <ctime>
 #include <vector>
 #include <SDL.h>
@@ -21,6 +22,12 @@
 // For Achievements
 #include "achievements.h"
 
+// For Game Events
+#include "events.h"
+
+// For Animations
+#include "animation.h"
+
 //  Constants
 const int SCREEN_WIDTH = 1000;
 const int SCREEN_HEIGHT = 800;
@@ -45,6 +52,17 @@ class Button {
         void render(SDL_Renderer* renderer, TTF_Font* font);
 };
 
+// Small seedable generator for the dice and AI risk rolls.
+// Its whole state is one integer so it can be saved with the game.
+struct DiceRng {
+    uint64_t state;
+
+    DiceRng(uint64_t seed = 0x9E3779B97F4A7C15ULL);
+    uint32_t next();
+    int rollFace();   // 1 to 6
+    int percent();    // 1 to 100
+};
+
 class Dice {
     public:
         int value;
@@ -53,7 +71,7 @@ class Dice {
 
         Dice(int v = 1, bool h = false, SDL_Rect r = {0, 0, 100, 100});
         bool operator==(int v) const;
-        void roll();
+        void roll(DiceRng& rng);
 };
 
 enum RollType {
@@ -66,25 +84,33 @@ enum RollType {
 
 bool isStraight(const std::vector<Dice>& dice);
 
+// Which hand a hold button label stands for (NOTHING for the "Nothing" hand, ZILCH if unknown)
+RollType rollTypeFromLabel(const std::string& label);
+
 // Game class to manage dice rolling and display
 class Game {
     public:
         Game();
-        void rollDice(SDL_Renderer* renderer, TTF_Font* font, SDL_Texture* bgTexture, SDL_Rect bgRect);
+        // Rolls straight away; the dice then tumble on screen for a moment
+        void rollDice();
+        bool isRolling() const {return diceTumble.isRunning();}
         void toggleHold(int dieIndex);
         void displayDice(SDL_Renderer* renderer);
         void addHoldButton(const std::string& text, int x, int y, std::function<void(Button&)> action);
         void getPossibleHolds();
         std::vector<Button>& getHoldButtons() { return holdButtons; }
         std::vector<Dice>& getDice() {return die;}
+        const std::vector<int>& getPreviousHeldDice() const {return previousHeldDice;}
         bool getButtonLock(){return lockOtherButtons;}
         bool getReverseButtonLock(){return reverseLockOtherButtons;}
     
         // For Players
         void nextTurn();
 
-        // aiType: "aggressive" or "cautious" (only used if isAI is true)
+        // aiType: an AI profile's type from assets/ai_profiles.json (only used if isAI is true)
         void addPlayer(std::string name, bool isAI = false, const std::string& aiType = "");
+        // An AI playing profile, which need not be one of AIProfiles::all()
+        void addPlayer(std::string name, const AIProfile& profile);
         void setFirstTurn();
         int getCurrentPlayer(){ return currentPlayerIndex;}
         bool getCurrentPlayerIsAI(){return players[getCurrentPlayer()]->isAIPlayer();}
@@ -94,6 +120,7 @@ class Game {
         void displayHardScore(SDL_Renderer* renderer, TTF_Font* font);
         int manyOfAKindPoints(int diceNumber, int numberOfDice);
         void bankCurrentPlayerScore();
+        void zilchCurrentPlayer();
         std::vector<std::unique_ptr<Player>>& getPlayers(){return players;}
     
     
@@ -101,10 +128,18 @@ class Game {
         void setWinConditionPoints(int WinningNumber){winningPoints = WinningNumber;}  //Created for custom games
         int getWinConditionPoints(){ return winningPoints;} 
         bool checkGameEnd();
-        std::string getWinningPlayerName(Achievements& achievements, int statisticsUpdated);
+        std::string getWinningPlayerName();
         void restartGame();
         void clearGame();
 
+        // For Game Events (roll, hold, bank, zilch, start and end of a game)
+        void addEventListener(GameEventListener listener){eventListeners.push_back(listener);}
+        void emitEvent(GameEventType type, int points = 0, int diceCount = 0, const std::string& hand = "");
+
+        // For Snapshots (saved on every turn boundary when enabled)
+        void setAutoSnapshot(bool enabled){autoSnapshot = enabled;}
+        DiceRng& getRng(){return rng;}
+
         // For Displaying History
         void displayHistory(SDL_Renderer* renderer, TTF_Font* font, std::unique_ptr<Player>& currentPlayer);
 
@@ -127,6 +162,20 @@ class Game {
 
         // For Achievement instances
         Achievements achievements;  // Add an Achievements instance
+
+        // For Game Events
+        std::vector<GameEventListener> eventListeners;
+
+        // For Animations
+        Tween diceTumble;
+        Tween softPointsShown;
+        int softPointsTarget = 0;
+
+        // For Snapshots
+        DiceRng rng;
+        bool autoSnapshot = false;
+        void saveSnapshot();
+        friend class Snapshot;
     };
 
 
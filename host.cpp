@@ -0,0 +1,565 @@
+// Game host: one headless process serving many games at once to people's
+// clients and bots, over a Unix socket or loopback TCP (host_protocol.h has
+// the messages). An IO thread reads every connection; each game belongs to one
+// worker of the pool, which plays it on a Game of its own, AI seats included,
+// and answers without ever waiting on a slow client. Every few seconds it prints the games hosted, decisions per
+// second and how long requests took from arriving to being answered.
+// Usage: host [--listen address] [--threads N] [--max-games N] [--report seconds] [--seconds N]
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <algorithm>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "game.h"
+#include "players.h"
+#include "animation.h"
+#include "ai_profile.h"
+#include "turn_state.h"
+#include "net.h"
+#include "host_protocol.h"
+
+// A hosted AI's turn takes a few dozen updates; this only stops one that never ends
+const int MAX_AI_UPDATES = 100000;
+// Request times each worker keeps for the percentiles
+const size_t LATENCY_SAMPLES = 4096;
+const int POLL_MILLISECONDS = 100;
+// Replies only pile up past this for a client that has stopped reading
+const size_t MAX_OUTBOX = 1 << 20;
+
+using Clock = std::chrono::steady_clock;
+
+struct HostOptions {
+    std::string listen = DEFAULT_HOST_ADDRESS;
+    int threads = 0;             // 0 for one per core
+    int maxGames = 1000;
+    int report = 5;              // Seconds between lines
+    int seconds = 0;             // Stop after this long, 0 to run until interrupted
+};
+
+// One client. Replies come from whichever worker plays the game and go into a
+// locked outbox: what the socket takes goes at once, without waiting, and the
+// IO thread sends the rest when poll says it can. The descriptor is closed once
+// no game holds the connection any more.
+struct Connection {
+    int fd;
+    int wakeFd;                  // Tells the IO thread the outbox needs flushing
+    std::mutex outboxMutex;
+    std::vector<uint8_t> outbox;
+
+    Connection(int fd, int wakeFd) : fd(fd), wakeFd(wakeFd) {}
+    ~Connection() { Net::close(fd); }
+
+    // A client that has gone is noticed by the IO thread
+    void send(uint8_t type, uint32_t game, std::vector<uint8_t> body) {
+        Frame frame;
+        frame.type = type;
+        frame.game = game;
+        frame.body = std::move(body);
+        std::lock_guard<std::mutex> lock(outboxMutex);
+        bool flushing = !outbox.empty();
+        Net::putFrame(outbox, frame);
+        if (outbox.size() > MAX_OUTBOX) {
+            outbox.clear();
+            Net::shutdown(fd);
+            return;
+        }
+        if (flushing) return;       // Already up to the IO thread
+        Net::sendSome(fd, outbox);
+        if (!outbox.empty()) {
+            // A full pipe means the IO thread is woken already
+            uint8_t wake = 0;
+            ssize_t written = write(wakeFd, &wake, 1);
+            (void)written;
+        }
+    }
+
+    bool hasOutbox() {
+        std::lock_guard<std::mutex> lock(outboxMutex);
+        return !outbox.empty();
+    }
+
+    // On the IO thread, once the socket takes more
+    void flush() {
+        std::lock_guard<std::mutex> lock(outboxMutex);
+        Net::sendSome(fd, outbox);
+    }
+};
+using ConnectionPtr = std::shared_ptr<Connection>;
+
+struct HostedGame {
+    Game game;
+    uint8_t seats[2] = {};
+    ConnectionPtr clients[2];    // For client and open seats, once taken
+    uint32_t moves = 0;
+
+    bool isHostAI(int seat) const { return seats[seat] >= SEAT_AI; }
+};
+
+struct Job {
+    ConnectionPtr from;
+    Frame frame;
+    Clock::time_point arrived;
+    bool hangUp = false;         // from has disconnected
+};
+
+std::atomic<uint32_t> gamesHosted{0};
+std::atomic<uint32_t> gamesActive{0};
+std::atomic<uint32_t> connectionCount{0};
+std::atomic<float> decisionRate{0};
+volatile std::sig_atomic_t interrupted = 0;
+
+void onInterrupt(int) { interrupted = 1; }
+
+void sendError(const ConnectionPtr& to, uint32_t game, HostError error) {
+    to->send(HOST_ERROR, game, {error});
+}
+
+// Owns its games outright: only its own thread ever touches them, so a game
+// needs no lock, and requests for one game are answered in order
+class Worker {
+public:
+    void start() { thread = std::thread(&Worker::run, this); }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        if (thread.joinable()) thread.join();
+    }
+
+    void post(Job job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+        }
+        wake.notify_one();
+    }
+
+    uint64_t getDecisions() const { return decisions.load(std::memory_order_relaxed); }
+
+    void copyLatencies(std::vector<float>& out) {
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        out.insert(out.end(), latencies.begin(), latencies.end());
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+            Job job = std::move(jobs.front());
+            jobs.pop_front();
+            lock.unlock();
+
+            handle(job);
+            if (!job.hangUp) {
+                float milliseconds = std::chrono::duration<float, std::milli>(Clock::now() - job.arrived).count();
+                std::lock_guard<std::mutex> latencyLock(latencyMutex);
+                if (latencies.size() < LATENCY_SAMPLES) latencies.push_back(milliseconds);
+                else latencies[nextLatency] = milliseconds;
+                nextLatency = (nextLatency + 1) % LATENCY_SAMPLES;
+            }
+            lock.lock();
+        }
+    }
+
+    void handle(Job& job) {
+        if (job.hangUp) {
+            hangUp(job.from);
+            return;
+        }
+        if (job.frame.type == HOST_NEW_GAME) {
+            newGame(job);
+            return;
+        }
+
+        uint32_t id = job.frame.game;
+        auto it = games.find(id);
+        if (it == games.end()) {
+            sendError(job.from, id, ERROR_NO_SUCH_GAME);
+            return;
+        }
+        HostedGame& hosted = *it->second;
+        if (job.frame.type == HOST_JOIN) join(job, hosted);
+        else act(job, hosted);
+        finishIfOver(id);
+    }
+
+    void newGame(Job& job) {
+        uint32_t id = job.frame.game;
+        NewGameRequest request;
+        const std::vector<AIProfile>& profiles = AIProfiles::all();
+        bool valid = decodeNewGame(job.frame.body, request);
+        for (uint8_t seat : request.seats) {
+            if (seat >= SEAT_AI + profiles.size()) valid = false;
+        }
+        if (!valid) {
+            sendError(job.from, id, ERROR_BAD_REQUEST);
+            return;
+        }
+
+        auto hosted = std::make_unique<HostedGame>();
+        Game& game = hosted->game;
+        for (int seat = 0; seat < 2; ++seat) {
+            hosted->seats[seat] = request.seats[seat];
+            if (hosted->isHostAI(seat)) {
+                const AIProfile& profile = profiles[request.seats[seat] - SEAT_AI];
+                game.addPlayer(profile.name, true, profile.type);
+            } else {
+                game.addPlayer("Player " + std::to_string(seat + 1));
+                if (request.seats[seat] == SEAT_CLIENT) hosted->clients[seat] = job.from;
+            }
+        }
+        // Mixed as the exporter does, so nearby seeds do not share a dice stream
+        uint64_t seed = request.seed ? request.seed : Clock::now().time_since_epoch().count() + id;
+        DiceRng seeder(seed);
+        game.getRng() = DiceRng((static_cast<uint64_t>(seeder.next()) << 32) | seeder.next());
+        game.setWinConditionPoints(request.target);
+        game.addEventListener([this](const GameEvent& event) {
+            if (event.type == EVENT_ROLL || event.type == EVENT_HOLD || event.type == EVENT_BANK ||
+                event.type == EVENT_ZILCH) {
+                decisions.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        game.setFirstTurn();
+
+        gamesHosted++;
+        gamesActive++;
+        HostedGame& added = *hosted;
+        games.emplace(id, std::move(hosted));
+        playHostedTurns(added);
+        sendState(added, id);
+        finishIfOver(id);
+    }
+
+    void join(Job& job, HostedGame& hosted) {
+        for (int seat = 0; seat < 2; ++seat) {
+            if (hosted.seats[seat] == SEAT_OPEN && !hosted.clients[seat]) {
+                hosted.clients[seat] = job.from;
+                sendState(hosted, job.frame.game);
+                return;
+            }
+        }
+        sendError(job.from, job.frame.game, ERROR_SEAT_TAKEN);
+    }
+
+    // Checked against the same moves TurnState allows; letting go of a selected button is fine too
+    void act(Job& job, HostedGame& hosted) {
+        uint32_t id = job.frame.game;
+        Game& game = hosted.game;
+        int seat = game.getCurrentPlayer();
+        if (hosted.isHostAI(seat) || hosted.clients[seat] != job.from) {
+            sendError(job.from, id, ERROR_NOT_YOUR_TURN);
+            return;
+        }
+        TurnAction action;
+        if (!decodeHostAction(job.frame.body, action)) {
+            sendError(job.from, id, ERROR_BAD_REQUEST);
+            return;
+        }
+
+        TurnState turn = TurnState::fromGame(game, 0);
+        TurnAction legal[TurnState::MAX_ACTIONS];
+        int count = turn.legalActions(legal);
+        bool allowed = action.type == TurnAction::PRESS && action.button < 32 && (turn.pressed & (1u << action.button));
+        for (int i = 0; i < count && !allowed; ++i) {
+            allowed = legal[i].type == action.type && (action.type != TurnAction::PRESS || legal[i].button == action.button);
+        }
+        if (!allowed) {
+            sendError(job.from, id, ERROR_ILLEGAL_ACTION);
+            return;
+        }
+
+        playAction(game, action);
+        hosted.moves++;
+        playHostedTurns(hosted);
+        sendState(hosted, id);
+    }
+
+    static void playHostedTurns(HostedGame& hosted) {
+        Game& game = hosted.game;
+        for (int updates = 0; updates < MAX_AI_UPDATES; ++updates) {
+            if (game.checkGameEnd() || !hosted.isHostAI(game.getCurrentPlayer())) return;
+            game.getPlayers()[game.getCurrentPlayer()]->update(game);
+        }
+    }
+
+    static void sendState(HostedGame& hosted, uint32_t id) {
+        Game& game = hosted.game;
+        HostView view;
+        view.gameOver = game.checkGameEnd();
+        view.currentSeat = game.getCurrentPlayer();
+        view.target = game.getWinConditionPoints();
+        view.moves = hosted.moves;
+        for (int seat = 0; seat < 2; ++seat) view.scores[seat] = game.getPlayers()[seat]->getHardPoints();
+        if (view.gameOver) view.winner = view.scores[0] == view.scores[1] ? 2 : view.scores[1] > view.scores[0];
+        view.turn = TurnState::fromGame(game, 0);   // Never the game's dice stream
+
+        for (int seat = 0; seat < 2; ++seat) {
+            const ConnectionPtr& client = hosted.clients[seat];
+            if (!client || (seat == 1 && client == hosted.clients[0])) continue;
+            view.yourSeats = 0;
+            for (int other = 0; other < 2; ++other) {
+                if (hosted.clients[other] == client) view.yourSeats |= 1 << other;
+            }
+            client->send(HOST_STATE, id, encodeHostView(view));
+        }
+    }
+
+    void finishIfOver(uint32_t id) {
+        auto it = games.find(id);
+        if (it == games.end() || !it->second->game.checkGameEnd()) return;
+        games.erase(it);
+        gamesActive--;
+    }
+
+    void hangUp(const ConnectionPtr& gone) {
+        for (auto it = games.begin(); it != games.end();) {
+            HostedGame& hosted = *it->second;
+            if (hosted.clients[0] != gone && hosted.clients[1] != gone) {
+                ++it;
+                continue;
+            }
+            for (const ConnectionPtr& client : hosted.clients) {
+                if (client && client != gone) sendError(client, it->first, ERROR_OPPONENT_LEFT);
+            }
+            it = games.erase(it);
+            gamesActive--;
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> jobs;
+    bool stopping = false;
+    std::thread thread;
+
+    std::unordered_map<uint32_t, std::unique_ptr<HostedGame>> games;
+    std::atomic<uint64_t> decisions{0};
+
+    std::mutex latencyMutex;
+    std::vector<float> latencies;
+    size_t nextLatency = 0;
+};
+
+HostStats collectStats(std::vector<std::unique_ptr<Worker>>& workers) {
+    HostStats stats;
+    stats.gamesHosted = gamesHosted;
+    stats.gamesActive = gamesActive;
+    stats.connections = connectionCount;
+    stats.decisionsPerSecond = decisionRate;
+    std::vector<float> latencies;
+    for (auto& worker : workers) {
+        stats.decisions += worker->getDecisions();
+        worker->copyLatencies(latencies);
+    }
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        stats.p50Milliseconds = latencies[latencies.size() / 2];
+        stats.p99Milliseconds = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+    }
+    return stats;
+}
+
+// Reads every client and hands each request to the worker owning its game
+class Acceptor {
+public:
+    Acceptor(int listener, const HostOptions& options, std::vector<std::unique_ptr<Worker>>& workers)
+        : listener(listener), options(options), workers(workers) {
+        if (pipe2(wakePipe, O_NONBLOCK | O_CLOEXEC) != 0) wakePipe[0] = wakePipe[1] = -1;
+    }
+
+    ~Acceptor() {
+        ::close(wakePipe[0]);
+        ::close(wakePipe[1]);
+    }
+
+    void run(const std::atomic<bool>& running) {
+        std::vector<pollfd> fds;
+        while (running) {
+            fds.clear();
+            fds.push_back({listener, POLLIN, 0});
+            fds.push_back({wakePipe[0], POLLIN, 0});
+            for (const auto& entry : clients) {
+                short events = POLLIN | (entry.second.connection->hasOutbox() ? POLLOUT : 0);
+                fds.push_back({entry.first, events, 0});
+            }
+            if (poll(fds.data(), fds.size(), POLL_MILLISECONDS) <= 0) continue;
+
+            if (fds[0].revents & POLLIN) {
+                int fd = Net::accept(listener);
+                if (fd >= 0) {
+                    clients[fd].connection = std::make_shared<Connection>(fd, wakePipe[1]);
+                    connectionCount++;
+                }
+            }
+            // Only there to cut the wait short, so the next poll looks for POLLOUT
+            uint8_t drained[64];
+            if (fds[1].revents & POLLIN) {
+                while (::read(wakePipe[0], drained, sizeof(drained)) > 0) {}
+            }
+            for (size_t i = 2; i < fds.size(); ++i) {
+                if (fds[i].revents & POLLOUT) clients[fds[i].fd].connection->flush();
+                if (fds[i].revents & ~POLLOUT) read(fds[i].fd);
+            }
+        }
+        for (auto& entry : clients) Net::shutdown(entry.first);
+    }
+
+private:
+    struct Client {
+        ConnectionPtr connection;
+        std::vector<uint8_t> inbox;
+    };
+
+    void read(int fd) {
+        Client& client = clients[fd];
+        if (!Net::receive(fd, client.inbox)) {
+            drop(fd);
+            return;
+        }
+        Frame frame;
+        while (Net::takeFrame(client.inbox, frame)) route(client.connection, frame);
+    }
+
+    void route(const ConnectionPtr& from, Frame& frame) {
+        Job job;
+        job.from = from;
+        job.arrived = Clock::now();
+        switch (frame.type) {
+            case HOST_NEW_GAME:
+                if (gamesActive >= static_cast<uint32_t>(options.maxGames)) {
+                    sendError(from, 0, ERROR_HOST_FULL);
+                    return;
+                }
+                if (++nextGame == 0) ++nextGame;   // 0 is no game
+                frame.game = nextGame;
+                break;
+            case HOST_JOIN:
+            case HOST_ACTION:
+                if (frame.game == 0) {
+                    sendError(from, 0, ERROR_BAD_REQUEST);
+                    return;
+                }
+                break;
+            case HOST_GET_STATS:
+                from->send(HOST_STATS, 0, encodeHostStats(collectStats(workers)));
+                return;
+            default:
+                sendError(from, frame.game, ERROR_BAD_REQUEST);
+                return;
+        }
+        job.frame = std::move(frame);
+        workers[job.frame.game % workers.size()]->post(std::move(job));
+    }
+
+    // Its games end with it; the descriptor closes once their workers let go
+    void drop(int fd) {
+        Net::shutdown(fd);
+        for (auto& worker : workers) {
+            Job job;
+            job.from = clients[fd].connection;
+            job.hangUp = true;
+            worker->post(std::move(job));
+        }
+        clients.erase(fd);
+        connectionCount--;
+    }
+
+    int listener;
+    const HostOptions& options;
+    std::vector<std::unique_ptr<Worker>>& workers;
+    std::unordered_map<int, Client> clients;
+    uint32_t nextGame = 0;
+    int wakePipe[2];
+};
+
+bool parseOptions(int argc, char* argv[], HostOptions& options) {
+    if ((argc - 1) % 2 != 0) return false;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--listen") options.listen = value;
+        else if (flag == "--threads") options.threads = std::atoi(value);
+        else if (flag == "--max-games") options.maxGames = std::atoi(value);
+        else if (flag == "--report") options.report = std::atoi(value);
+        else if (flag == "--seconds") options.seconds = std::atoi(value);
+        else return false;
+    }
+    if (options.maxGames <= 0 || options.report <= 0 || options.seconds < 0) return false;
+    if (options.threads <= 0) options.threads = std::max(1u, std::thread::hardware_concurrency());
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    AIProfiles::load(AI_PROFILES_FILE);
+    HostOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: host [--listen address] [--threads N] [--max-games N] [--report seconds] [--seconds N]" << std::endl;
+        return 1;
+    }
+    // Each update plays the next move, with no pauses and no dice tumble
+    Animation::setEnabled(false);
+
+    std::string error;
+    int listener = Net::listen(options.listen, error);
+    if (listener < 0) {
+        std::cerr << "Could not listen: " << error << std::endl;
+        return 1;
+    }
+    std::signal(SIGINT, onInterrupt);
+    std::signal(SIGTERM, onInterrupt);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < options.threads; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+        workers.back()->start();
+    }
+    std::atomic<bool> running{true};
+    Acceptor acceptor(listener, options, workers);
+    std::thread io([&]() { acceptor.run(running); });
+    std::cout << "Hosting on " << options.listen << " with " << options.threads << " worker threads" << std::endl;
+
+    auto start = Clock::now();
+    auto lastReport = start;
+    uint64_t lastDecisions = 0;
+    while (!interrupted) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(POLL_MILLISECONDS));
+        auto now = Clock::now();
+        bool finished = options.seconds > 0 && now - start >= std::chrono::seconds(options.seconds);
+        double seconds = std::chrono::duration<double>(now - lastReport).count();
+        if (seconds < options.report && !finished) continue;
+
+        HostStats stats = collectStats(workers);
+        decisionRate = static_cast<float>((stats.decisions - lastDecisions) / seconds);
+        lastDecisions = stats.decisions;
+        lastReport = now;
+        std::cout << stats.gamesActive << " games (" << stats.gamesHosted << " hosted) for " << stats.connections
+                  << " connections: " << std::fixed << std::setprecision(0) << decisionRate.load()
+                  << " decisions/s, requests p50 " << std::setprecision(3) << stats.p50Milliseconds
+                  << " ms, p99 " << stats.p99Milliseconds << " ms" << std::endl;
+        if (finished) break;
+    }
+
+    running = false;
+    io.join();
+    for (auto& worker : workers) worker->stop();
+    Net::close(listener, options.listen);
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include "host_protocol.h"
+#include <cstring>
+
+namespace {
+
+// Little endian, like the snapshot and model files
+struct Writer {
+    std::vector<uint8_t> out;
+
+    void u8(uint8_t v) { out.push_back(v); }
+    void u32(uint32_t v) {
+        for (int shift = 0; shift < 32; shift += 8) out.push_back((v >> shift) & 0xFF);
+    }
+    void u64(uint64_t v) {
+        u32(static_cast<uint32_t>(v));
+        u32(static_cast<uint32_t>(v >> 32));
+    }
+    void f32(float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        u32(bits);
+    }
+};
+
+struct Reader {
+    const std::vector<uint8_t>& in;
+    size_t at = 0;
+    bool ok = true;
+
+    explicit Reader(const std::vector<uint8_t>& data) : in(data) {}
+
+    uint8_t u8() {
+        if (at + 1 > in.size()) {
+            ok = false;
+            return 0;
+        }
+        return in[at++];
+    }
+    uint32_t u32() {
+        uint32_t v = 0;
+        for (int shift = 0; shift < 32; shift += 8) v |= uint32_t(u8()) << shift;
+        return v;
+    }
+    uint64_t u64() {
+        uint64_t low = u32();
+        return low | uint64_t(u32()) << 32;
+    }
+    float f32() {
+        uint32_t bits = u32();
+        float v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+    bool done() const { return ok && at == in.size(); }
+};
+
+const uint8_t GAME_OVER_FLAG = 1;
+const uint8_t LOCK_OTHERS_FLAG = 1;
+const uint8_t REVERSE_LOCK_FLAG = 2;
+
+}
+
+
+std::vector<uint8_t> encodeNewGame(const NewGameRequest& request) {
+    Writer w;
+    w.u32(request.target);
+    w.u64(request.seed);
+    w.u8(request.seats[0]);
+    w.u8(request.seats[1]);
+    return w.out;
+}
+
+bool decodeNewGame(const std::vector<uint8_t>& body, NewGameRequest& request) {
+    Reader r(body);
+    request.target = r.u32();
+    request.seed = r.u64();
+    request.seats[0] = r.u8();
+    request.seats[1] = r.u8();
+    return r.done() && request.target > 0;
+}
+
+std::vector<uint8_t> encodeHostAction(const TurnAction& action) {
+    return {action.type, action.button};
+}
+
+bool decodeHostAction(const std::vector<uint8_t>& body, TurnAction& action) {
+    if (body.size() != 2 || body[0] > TurnAction::ZILCH) return false;
+    action.type = static_cast<TurnAction::Type>(body[0]);
+    action.button = body[1];
+    return true;
+}
+
+// seats | current | over | winner | i32 target | i32 score[2] | u32 moves | 6 x u8 face | u8 held | u8 heldBefore
+// | u32 offered | u32 pressed | i32 soft | i32 scored | u8 zilches | u8 locks | u8 phase
+std::vector<uint8_t> encodeHostView(const HostView& view) {
+    Writer w;
+    w.u8(view.yourSeats);
+    w.u8(view.currentSeat);
+    w.u8(view.gameOver ? GAME_OVER_FLAG : 0);
+    w.u8(view.winner);
+    w.u32(view.target);
+    w.u32(view.scores[0]);
+    w.u32(view.scores[1]);
+    w.u32(view.moves);
+
+    const TurnState& turn = view.turn;
+    for (uint8_t face : turn.faces) w.u8(face);
+    w.u8(turn.held);
+    w.u8(turn.heldBefore);
+    w.u32(turn.offered);
+    w.u32(turn.pressed);
+    w.u32(turn.softPoints);
+    w.u32(turn.scored);
+    w.u8(turn.zilches);
+    w.u8((turn.lockOthers ? LOCK_OTHERS_FLAG : 0) | (turn.reverseLock ? REVERSE_LOCK_FLAG : 0));
+    w.u8(turn.phase);
+    return w.out;
+}
+
+bool decodeHostView(const std::vector<uint8_t>& body, HostView& view) {
+    Reader r(body);
+    view = HostView();
+    view.yourSeats = r.u8();
+    view.currentSeat = r.u8();
+    view.gameOver = r.u8() & GAME_OVER_FLAG;
+    view.winner = r.u8();
+    view.target = r.u32();
+    view.scores[0] = r.u32();
+    view.scores[1] = r.u32();
+    view.moves = r.u32();
+
+    TurnState& turn = view.turn;
+    for (uint8_t& face : turn.faces) face = r.u8();
+    turn.held = r.u8();
+    turn.heldBefore = r.u8();
+    turn.offered = r.u32();
+    turn.pressed = r.u32();
+    turn.softPoints = r.u32();
+    turn.scored = r.u32();
+    turn.zilches = r.u8();
+    uint8_t locks = r.u8();
+    turn.lockOthers = locks & LOCK_OTHERS_FLAG;
+    turn.reverseLock = locks & REVERSE_LOCK_FLAG;
+    uint8_t phase = r.u8();
+    if (phase > TurnState::ZILCHED || view.currentSeat > 1) return false;
+    turn.phase = static_cast<TurnState::Phase>(phase);
+    return r.done();
+}
+
+std::vector<uint8_t> encodeHostStats(const HostStats& stats) {
+    Writer w;
+    w.u32(stats.gamesHosted);
+    w.u32(stats.gamesActive);
+    w.u32(stats.connections);
+    w.u64(stats.decisions);
+    w.f32(stats.decisionsPerSecond);
+    w.f32(stats.p50Milliseconds);
+    w.f32(stats.p99Milliseconds);
+    return w.out;
+}
+
+bool decodeHostStats(const std::vector<uint8_t>& body, HostStats& stats) {
+    Reader r(body);
+    stats.gamesHosted = r.u32();
+    stats.gamesActive = r.u32();
+    stats.connections = r.u32();
+    stats.decisions = r.u64();
+    stats.decisionsPerSecond = r.f32();
+    stats.p50Milliseconds = r.f32();
+    stats.p99Milliseconds = r.f32();
+    return r.done();
+}
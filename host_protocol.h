@@ -0,0 +1,80 @@
+#ifndef HOST_PROTOCOL_H
+#define HOST_PROTOCOL_H
+
+#include <vector>
+#include <cstdint>
+#include "turn_state.h"
+
+// Where the host listens unless told otherwise
+const char DEFAULT_HOST_ADDRESS[] = "zilch_host.sock";
+
+// Frame types between the host and its clients (see Net for the framing)
+enum HostMessage : uint8_t {
+    // Client to host
+    HOST_NEW_GAME = 1,      // i32 target | u64 seed, 0 for any | u8 seat[2]; answered with its first HOST_STATE
+    HOST_JOIN = 2,          // Takes the open seat of the frame's game
+    HOST_ACTION = 3,        // u8 TurnAction::Type | u8 button, for the seat in turn
+    HOST_GET_STATS = 4,
+
+    // Host to client
+    HOST_STATE = 16,        // HostView, to every client in the game after each request
+    HOST_ERROR = 17,        // u8 HostError
+    HOST_STATS = 18         // HostStats
+};
+
+// Who plays a seat of a new game
+const uint8_t SEAT_CLIENT = 0;      // The connection that asked for the game
+const uint8_t SEAT_OPEN = 1;        // Whichever connection joins it
+const uint8_t SEAT_AI = 2;          // SEAT_AI + i: AIProfiles::all()[i], played by the host
+
+enum HostError : uint8_t {
+    ERROR_BAD_REQUEST = 1,
+    ERROR_NO_SUCH_GAME = 2,
+    ERROR_NOT_YOUR_TURN = 3,
+    ERROR_ILLEGAL_ACTION = 4,
+    ERROR_SEAT_TAKEN = 5,
+    ERROR_OPPONENT_LEFT = 6,        // The game is gone
+    ERROR_HOST_FULL = 7
+};
+
+struct NewGameRequest {
+    int32_t target = 10000;
+    uint64_t seed = 0;
+    uint8_t seats[2] = {SEAT_CLIENT, SEAT_AI};
+};
+
+// A game as one client sees it
+struct HostView {
+    uint8_t yourSeats = 0;      // Bit per seat the receiving connection plays
+    uint8_t currentSeat = 0;
+    bool gameOver = false;
+    uint8_t winner = 0;         // Seat, or 2 for a tie, once over
+    int32_t target = 0;
+    int32_t scores[2] = {};
+    uint32_t moves = 0;         // Client moves the game has taken, so a reply can be told from an older state
+    TurnState turn;             // The seat in turn's; its rngState is never sent
+};
+
+struct HostStats {
+    uint32_t gamesHosted = 0;   // Since the host started
+    uint32_t gamesActive = 0;
+    uint32_t connections = 0;
+    uint64_t decisions = 0;     // Rolls, holds, banks and zilches, by clients and the host's AIs
+    float decisionsPerSecond = 0;   // Over the last report period
+    float p50Milliseconds = 0;  // Request to reply, over recent requests
+    float p99Milliseconds = 0;
+};
+
+std::vector<uint8_t> encodeNewGame(const NewGameRequest& request);
+bool decodeNewGame(const std::vector<uint8_t>& body, NewGameRequest& request);
+
+std::vector<uint8_t> encodeHostAction(const TurnAction& action);
+bool decodeHostAction(const std::vector<uint8_t>& body, TurnAction& action);
+
+std::vector<uint8_t> encodeHostView(const HostView& view);
+bool decodeHostView(const std::vector<uint8_t>& body, HostView& view);
+
+std::vector<uint8_t> encodeHostStats(const HostStats& stats);
+bool decodeHostStats(const std::vector<uint8_t>& body, HostStats& stats);
+
+#endif
@@ -0,0 +1,67 @@
+#include "latency.h"
+#include "render_thread.h"
+#include <mutex>
+#include <algorithm>
+
+namespace {
+
+// Enough for a steady p99 without old sessions drowning out a change
+const size_t KEPT_SAMPLES = 512;
+
+const char* INPUT_NAMES[INPUT_KIND_COUNT] = {"roll", "bank", "hold"};
+
+std::mutex samplesMutex;
+std::vector<float> samples[INPUT_KIND_COUNT];   // Milliseconds, a ring once full
+size_t nextSample[INPUT_KIND_COUNT] = {};
+
+double percentile(const std::vector<float>& sorted, int percent) {
+    return sorted[std::min(sorted.size() - 1, sorted.size() * percent / 100)];
+}
+
+}
+
+
+void InputLatency::inputHandled(InputKind kind, Uint32 eventTimestamp) {
+    // Event timestamps are in ticks; moved onto the performance counter by how long ago they were
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint32 ticksAgo = SDL_GetTicks() - eventTimestamp;
+    Uint64 ago = static_cast<Uint64>(ticksAgo) * SDL_GetPerformanceFrequency() / 1000;
+    RenderThread::recordingFrame().inputs.push_back({kind, ago < now ? now - ago : now});
+}
+
+void InputLatency::framePresented(const std::vector<InputStamp>& inputs) {
+    if (inputs.empty()) return;
+    Uint64 now = SDL_GetPerformanceCounter();
+    double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+
+    std::lock_guard<std::mutex> lock(samplesMutex);
+    for (const InputStamp& input : inputs) {
+        float milliseconds = static_cast<float>(1000.0 * (now - input.time) / frequency);
+        std::vector<float>& kept = samples[input.kind];
+        if (kept.size() < KEPT_SAMPLES) {
+            kept.push_back(milliseconds);
+        } else {
+            kept[nextSample[input.kind]] = milliseconds;
+            nextSample[input.kind] = (nextSample[input.kind] + 1) % KEPT_SAMPLES;
+        }
+    }
+}
+
+LatencySummary InputLatency::getSummary(InputKind kind) {
+    std::vector<float> sorted;
+    {
+        std::lock_guard<std::mutex> lock(samplesMutex);
+        sorted = samples[kind];
+    }
+    LatencySummary summary;
+    if (sorted.empty()) return summary;
+    std::sort(sorted.begin(), sorted.end());
+    summary.samples = sorted.size();
+    summary.p50Milliseconds = percentile(sorted, 50);
+    summary.p99Milliseconds = percentile(sorted, 99);
+    return summary;
+}
+
+const char* InputLatency::getName(InputKind kind) {
+    return INPUT_NAMES[kind];
+}
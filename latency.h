@@ -0,0 +1,41 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <SDL.h>
+#include <vector>
+
+enum InputKind {
+    INPUT_ROLL,
+    INPUT_BANK,
+    INPUT_HOLD,
+    INPUT_KIND_COUNT
+};
+
+// An input handled while its frame was recorded, timed on the performance counter
+struct InputStamp {
+    InputKind kind;
+    Uint64 time;
+};
+
+struct LatencySummary {
+    int samples = 0;
+    double p50Milliseconds = 0;
+    double p99Milliseconds = 0;
+};
+
+// Time from a click to the present of the first frame that shows its effect.
+// The game thread stamps the input into the frame it is recording; the
+// render thread closes the measurement once that frame is presented.
+// The most recent samples of each kind are kept.
+class InputLatency {
+public:
+    // Game thread, once the click has been acted on; eventTimestamp is the SDL event's
+    static void inputHandled(InputKind kind, Uint32 eventTimestamp);
+    // Render thread, right after presenting a frame
+    static void framePresented(const std::vector<InputStamp>& inputs);
+
+    static LatencySummary getSummary(InputKind kind);
+    static const char* getName(InputKind kind);
+};
+
+#endif
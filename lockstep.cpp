@@ -0,0 +1,282 @@
+#include "lockstep.h"
+#include "game.h"
+#include "net.h"
+#include "snapshot.h"
+#include <chrono>
+#include <random>
+#include <poll.h>
+
+namespace {
+
+enum LockstepMessage : uint8_t {
+    LOCKSTEP_HELLO = 1,
+    LOCKSTEP_MOVE = 2,
+    LOCKSTEP_HASH = 3
+};
+
+const size_t MAX_NAME = 32;
+
+// Little endian, like the snapshot and model files
+struct Writer {
+    std::vector<uint8_t> out;
+
+    void u8(uint8_t v) { out.push_back(v); }
+    void u16(uint16_t v) {
+        u8(v & 0xFF);
+        u8(v >> 8);
+    }
+    void u32(uint32_t v) {
+        for (int shift = 0; shift < 32; shift += 8) out.push_back((v >> shift) & 0xFF);
+    }
+    void u64(uint64_t v) {
+        u32(static_cast<uint32_t>(v));
+        u32(static_cast<uint32_t>(v >> 32));
+    }
+    void str(const std::string& s) {
+        u8(static_cast<uint8_t>(s.size()));
+        out.insert(out.end(), s.begin(), s.end());
+    }
+};
+
+struct Reader {
+    const std::vector<uint8_t>& in;
+    size_t at = 0;
+    bool ok = true;
+
+    explicit Reader(const std::vector<uint8_t>& data) : in(data) {}
+
+    uint8_t u8() {
+        if (at + 1 > in.size()) {
+            ok = false;
+            return 0;
+        }
+        return in[at++];
+    }
+    uint16_t u16() {
+        uint16_t low = u8();
+        return low | uint16_t(u8()) << 8;
+    }
+    uint32_t u32() {
+        uint32_t v = 0;
+        for (int shift = 0; shift < 32; shift += 8) v |= uint32_t(u8()) << shift;
+        return v;
+    }
+    uint64_t u64() {
+        uint64_t low = u32();
+        return low | uint64_t(u32()) << 32;
+    }
+    std::string str() {
+        size_t size = u8();
+        if (at + size > in.size()) {
+            ok = false;
+            return "";
+        }
+        std::string s(in.begin() + at, in.begin() + at + size);
+        at += size;
+        return s;
+    }
+    bool done() const { return ok && at == in.size(); }
+};
+
+bool endsTurn(const TurnAction& action) {
+    return action.type == TurnAction::BANK || action.type == TurnAction::ZILCH;
+}
+
+}
+
+
+bool Lockstep::host(const std::string& address, Game& game, const std::string& name, int target, std::string& error) {
+    close();
+    listener = Net::listen(address, error);
+    if (listener < 0) return false;
+    listenAddress = address;
+
+    // Any seed will do, as long as both sides use the same one
+    std::random_device device;
+    seed = (static_cast<uint64_t>(device()) << 32) ^ device() ^ std::chrono::steady_clock::now().time_since_epoch().count();
+    this->target = target;
+    this->game = &game;
+    localName = name.substr(0, MAX_NAME);
+    seat = 0;
+    status = CONNECTING;
+    return true;
+}
+
+bool Lockstep::join(const std::string& address, Game& game, const std::string& name, std::string& error) {
+    close();
+    fd = Net::connect(address, error);
+    if (fd < 0) return false;
+    this->game = &game;
+    localName = name.substr(0, MAX_NAME);
+    seat = 1;
+    status = CONNECTING;
+    return true;
+}
+
+bool Lockstep::pollStart(std::string& error, int waitMilliseconds) {
+    if (status != CONNECTING) return true;
+
+    if (fd < 0) {
+        pollfd joining = {listener, POLLIN, 0};
+        if (poll(&joining, 1, waitMilliseconds) <= 0) return true;
+        fd = Net::accept(listener);
+        Net::close(listener, listenAddress);     // One opponent only
+        listener = -1;
+        if (fd < 0) return startFailed("no one joined", error);
+        waitMilliseconds = 0;
+    }
+
+    // The host says what game it is; the joiner only answers with its name
+    Writer hello;
+    hello.u16(VERSION);
+    hello.u64(seed);
+    hello.u32(target);
+    hello.str(localName);
+    if (seat == 0 && !helloSent) {
+        if (!send(LOCKSTEP_HELLO, hello.out)) return startFailed("the other player left", error);
+        helloSent = true;
+    }
+
+    Frame frame;
+    while (!Net::takeFrame(inbox, frame)) {
+        pollfd readable = {fd, POLLIN, 0};
+        if (poll(&readable, 1, waitMilliseconds) <= 0) return true;
+        if (!Net::receive(fd, inbox)) return startFailed("the other player left", error);
+    }
+    if (frame.type != LOCKSTEP_HELLO) return startFailed("the other player left", error);
+    std::string names[2];
+    names[seat] = localName;
+    Reader r(frame.body);
+    uint16_t version = r.u16();
+    uint64_t theirSeed = r.u64();
+    int32_t theirTarget = r.u32();
+    names[1 - seat] = r.str();
+    if (!r.done() || version != VERSION) return startFailed("the other player runs a different version", error);
+    if (seat == 1) {
+        seed = theirSeed;
+        target = theirTarget;
+        if (!send(LOCKSTEP_HELLO, hello.out)) return startFailed("the other player left", error);
+    }
+
+    // Set up the same way on both sides, down to the dice stream
+    game->addPlayer(names[0]);
+    game->addPlayer(names[1]);
+    DiceRng seeder(seed);
+    game->getRng() = DiceRng((static_cast<uint64_t>(seeder.next()) << 32) | seeder.next());
+    game->setWinConditionPoints(target);
+    game->setFirstTurn();
+
+    status = PLAYING;
+    moves = 0;
+    sinceHash = 0;
+    awaitingHash = false;
+    bytesSent = 0;
+    hashesMatched = 0;
+    return true;
+}
+
+bool Lockstep::startFailed(const std::string& why, std::string& error) {
+    error = why;
+    close();
+    return false;
+}
+
+void Lockstep::close() {
+    if (fd >= 0) Net::close(fd);
+    fd = -1;
+    if (listener >= 0) Net::close(listener, listenAddress);
+    listener = -1;
+    helloSent = false;
+    game = nullptr;
+    status = OFF;
+    inbox.clear();
+}
+
+bool Lockstep::isLocalTurn() const {
+    return status == PLAYING && !awaitingHash && !game->checkGameEnd() && game->getCurrentPlayer() == seat;
+}
+
+void Lockstep::played(const TurnAction& action) {
+    if (status != PLAYING) return;
+    uint32_t before = moves++;
+    if (!send(LOCKSTEP_MOVE, {action.type, action.button}, before)) return;
+    if (endsTurn(action) || ++sinceHash >= HASH_INTERVAL) {
+        sinceHash = 0;
+        Writer w;
+        w.u32(stateHash(*game));
+        send(LOCKSTEP_HASH, w.out, moves);
+    }
+}
+
+bool Lockstep::takeRemote(TurnAction& action, int waitMilliseconds) {
+    if (status != PLAYING) return false;
+    Frame frame;
+    while (true) {
+        if (!Net::takeFrame(inbox, frame)) {
+            if (!fill(waitMilliseconds)) return false;
+            continue;
+        }
+        // Numbered by the moves made before it, so one out of order is a desync too
+        if (frame.game != moves) {
+            status = DESYNCED;
+            return false;
+        }
+        if (frame.type == LOCKSTEP_HASH) {
+            Reader r(frame.body);
+            uint32_t hash = r.u32();
+            if (!r.done() || hash != stateHash(*game)) {
+                status = DESYNCED;
+                return false;
+            }
+            hashesMatched++;
+            if (awaitingHash) {
+                awaitingHash = false;
+                return false;       // Our turn now, nothing more will come
+            }
+            continue;
+        }
+        if (frame.type != LOCKSTEP_MOVE || frame.body.size() != 2 || frame.body[0] > TurnAction::ZILCH ||
+            game->checkGameEnd() || game->getCurrentPlayer() == seat) {
+            status = DESYNCED;
+            return false;
+        }
+        action.type = static_cast<TurnAction::Type>(frame.body[0]);
+        action.button = frame.body[1];
+        moves++;
+        // The turn is ours once this is played, but not before its hash is checked
+        awaitingHash = endsTurn(action);
+        return true;
+    }
+}
+
+uint32_t Lockstep::stateHash(Game& game) {
+    game.checkGameEnd();    // Hands a finished game back to player 1, whenever it is first asked
+    std::vector<uint8_t> image = Snapshot::encode(game);
+    return Snapshot::checksum(image.data(), image.size());
+}
+
+bool Lockstep::send(uint8_t type, const std::vector<uint8_t>& body, uint32_t number) {
+    Frame frame;
+    frame.type = type;
+    frame.game = number;
+    frame.body = body;
+    std::vector<uint8_t> out;
+    Net::putFrame(out, frame);
+    if (!Net::sendAll(fd, out.data(), out.size())) {
+        status = PEER_LEFT;
+        return false;
+    }
+    bytesSent += out.size();
+    return true;
+}
+
+// More of the stream, if any arrives within the wait
+bool Lockstep::fill(int waitMilliseconds) {
+    pollfd readable = {fd, POLLIN, 0};
+    if (poll(&readable, 1, waitMilliseconds) <= 0) return false;
+    if (!Net::receive(fd, inbox)) {
+        status = PEER_LEFT;
+        return false;
+    }
+    return true;
+}
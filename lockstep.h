@@ -0,0 +1,86 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "turn_state.h"
+
+class Game;
+
+// A two player game between two processes. Both sides set the game up the same
+// way from a seed the host picks and play every move on their own copy, so only
+// the moves cross the socket (a 9 byte frame each). Whoever made a move sends a
+// hash of the game after it every few moves and at the end of every turn; the
+// other side compares it with its own once it has made the same moves.
+// Frames (see Net), numbered by the moves made before them in the frame's game field:
+//   HELLO   u16 version | u64 seed | i32 target | u8 length + name, host first, then the joiner's
+//   MOVE    u8 TurnAction::Type | u8 button
+//   HASH    u32 Snapshot::checksum of Snapshot::encode
+class Lockstep {
+public:
+    static const uint16_t VERSION = 1;
+    static const int HASH_INTERVAL = 8;     // Moves between hashes within a turn
+
+    enum Status { OFF, CONNECTING, PLAYING, DESYNCED, PEER_LEFT };
+
+    Lockstep() = default;
+    Lockstep(const Lockstep&) = delete;
+    Lockstep& operator=(const Lockstep&) = delete;
+    ~Lockstep() { close(); }
+
+    // Listen for the other player on address (or reach the one hosting there)
+    // without waiting for them; CONNECTING until pollStart has agreed on the
+    // game and set game up for it, with the host as player 1. False with error
+    // set if that fails.
+    bool host(const std::string& address, Game& game, const std::string& name, int target, std::string& error);
+    bool join(const std::string& address, Game& game, const std::string& name, std::string& error);
+    // Takes the handshake as far as it can while CONNECTING, waiting up to
+    // waitMilliseconds for the other side; false with error set (and OFF) if it failed
+    bool pollStart(std::string& error, int waitMilliseconds = 0);
+    void close();
+
+    Status getStatus() const { return status; }
+    bool isPlaying() const { return status == PLAYING; }
+    bool isLocalTurn() const;
+    int getLocalSeat() const { return seat; }
+
+    // After the person here made action on the game
+    void played(const TurnAction& action);
+    // The other player's next move, for the caller to play on the game before
+    // asking again; waits up to waitMilliseconds for one. Hashes that arrived
+    // first are checked here, and the one ending their turn returns false.
+    bool takeRemote(TurnAction& action, int waitMilliseconds = 0);
+
+    uint32_t getMoves() const { return moves; }
+    uint64_t getBytesSent() const { return bytesSent; }
+    uint32_t getHashesMatched() const { return hashesMatched; }
+
+    // What the other side compares against
+    static uint32_t stateHash(Game& game);
+
+private:
+    bool startFailed(const std::string& why, std::string& error);
+    bool send(uint8_t type, const std::vector<uint8_t>& body, uint32_t number = 0);
+    bool fill(int waitMilliseconds);
+
+    Game* game = nullptr;
+    int fd = -1;
+    // Kept while connecting: the host's listener until someone joins, and what the HELLO says
+    int listener = -1;
+    std::string listenAddress;
+    std::string localName;
+    uint64_t seed = 0;
+    int target = 0;
+    bool helloSent = false;
+    int seat = 0;
+    Status status = OFF;
+    std::vector<uint8_t> inbox;
+    uint32_t moves = 0;             // By both players, including the ones taken but not played yet
+    uint32_t sinceHash = 0;
+    bool awaitingHash = false;      // The other player ended their turn; ours starts once its hash matches
+    uint64_t bytesSent = 0;
+    uint32_t hashesMatched = 0;
+};
+
+#endif
@@ -6,19 +6,139 @@
 #include <cstdlib>
 #include <ctime>
 #include <functional>
+#include <thread>
 #include "game.h"
 #include <limits.h>
 #include "players.h"
 #include "achievements.h"
+#include "snapshot.h"
+#include "analytics.h"
+#include "assets.h"
+#include "batch.h"
+#include "render_thread.h"
+#include "animation.h"
+#include "audio.h"
+#include "ui_script.h"
+#include "latency.h"
+#include "decisions.h"
+#include "regret.h"
+#include "rules.h"
+#include "advisor.h"
+#include "decision_quality.h"
+#include "decision_cache.h"
+#include "turn_state.h"
+#include "lockstep.h"
 
 // Allows to display text
 void renderText(SDL_Renderer *renderer, TTF_Font *font, const std::string &text, SDL_Color color, int x, int y) {
-    SDL_Surface *surface = TTF_RenderText_Solid(font, text.c_str(), color);
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_Rect textRect = {x, y, surface->w, surface->h};
-    SDL_RenderCopy(renderer, texture, nullptr, &textRect);
-    SDL_FreeSurface(surface);
-    SDL_DestroyTexture(texture);
+    RenderBatch::drawText(font, text, color, x, y); // Nothing is drawn while the font is still loading
+}
+
+// F3 overlay: renderer, draw cost, click-to-present latency and AI cache hits, refreshed twice a second
+void drawProfilerOverlay() {
+    static std::vector<std::string> lines;
+    static RenderStats lastStats;
+    static Uint64 lastUpdate = 0;
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    double seconds = static_cast<double>(now - lastUpdate) / SDL_GetPerformanceFrequency();
+    if (lines.empty() || seconds >= 0.5) {
+        RenderStats stats = RenderThread::getStats();
+        int frames = stats.frames - lastStats.frames;
+        double drawMilliseconds = frames > 0 ? (stats.drawMilliseconds - lastStats.drawMilliseconds) / frames : 0;
+        char text[96];
+        lines.clear();
+        lines.push_back(std::string("Renderer: ") + RenderThread::getBackendName());
+        std::snprintf(text, sizeof(text), "Draw: %.2f ms per frame, %.0f fps", drawMilliseconds, lastUpdate ? frames / seconds : 0.0);
+        lines.push_back(text);
+        for (int kind = 0; kind < INPUT_KIND_COUNT; ++kind) {
+            LatencySummary latency = InputLatency::getSummary(static_cast<InputKind>(kind));
+            std::snprintf(text, sizeof(text), "%s: p50 %.1f ms, p99 %.1f ms (%d clicks)", InputLatency::getName(static_cast<InputKind>(kind)),
+                          latency.p50Milliseconds, latency.p99Milliseconds, latency.samples);
+            lines.push_back(text);
+        }
+        DecisionCacheStats cache = DecisionCache::getStats();
+        std::snprintf(text, sizeof(text), "AI decision cache: %.0f%% hits (%llu lookups)", cache.hitRate() * 100,
+                      static_cast<unsigned long long>(cache.hits + cache.misses));
+        lines.push_back(text);
+        lastStats = stats;
+        lastUpdate = now;
+    }
+
+    TTF_Font* font = Assets::getFont(FONT_SMALL);
+    SDL_Rect box = {10, SCREEN_HEIGHT - 20 - 22 * static_cast<int>(lines.size()), 360, 10 + 22 * static_cast<int>(lines.size())};
+    RenderBatch::fillRect(box, {0, 0, 0, 255});
+    for (size_t i = 0; i < lines.size(); ++i) {
+        RenderBatch::drawText(font, lines[i], {0, 255, 0, 255}, box.x + 8, box.y + 5 + 22 * i);
+    }
+}
+
+// A finished game: its rolls go to games.col for the analyzer, and the
+// decisions the people at the table made count towards their Decision Quality.
+// Runs on the advisor's thread, so rating them does not hold up the game.
+void recordPlayedGame(const std::vector<DecisionRow>& rows, const std::vector<std::string>& names, bool keepRows) {
+    if (keepRows) {
+        ColumnBlock block(DECISION_SCHEMA);
+        DecisionRecorder::appendRows(rows, block);
+        ColumnFile file;
+        if (!file.open(PLAYED_GAMES_FILE, DECISION_SCHEMA) || !file.appendBlock(block)) {
+            std::cerr << "Error: could not write " << PLAYED_GAMES_FILE << std::endl;
+        }
+    }
+
+    std::vector<DecisionRating> ratings = rateDecisions(rows, 1);
+    std::vector<PlayerQuality> seats(names.size());
+    std::vector<double> pointsGivenUp(names.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        size_t seat = rows[i].seat;
+        if (rows[i].policy != HUMAN_POLICY || !ratings[i].rated || seat >= names.size()) continue;
+        seats[seat].rated++;
+        if (ratings[i].isBest()) seats[seat].best++;
+        if (!ratings[i].lastTurn) pointsGivenUp[seat] += ratings[i].regret;
+    }
+    for (size_t seat = 0; seat < names.size(); ++seat) {
+        if (seats[seat].rated == 0) continue;
+        seats[seat].name = names[seat];
+        seats[seat].pointsGivenUp = static_cast<int>(pointsGivenUp[seat] + 0.5);
+        DecisionQuality::add(seats[seat]);
+    }
+}
+
+// H panel during a person's turn: the best hold for the roll and what to do after it
+void drawHintPanel(const Advice* advice) {
+    std::vector<std::string> lines = {"Hint (H to hide)"};
+    char text[96];
+    if (!advice) {
+        lines.push_back("Working it out...");
+    } else if (advice->hold == 0) {
+        lines.push_back("Nothing scores");
+    } else {
+        const std::vector<std::string>& labels = holdButtonLabels();
+        for (size_t id = 0; id < labels.size(); ++id) {
+            if (advice->hold & (1ULL << id)) lines.push_back((lines.size() == 1 ? "Hold " : "  + ") + labels[id]);
+        }
+        if (advice->bank) {
+            std::snprintf(text, sizeof(text), "Then bank %.0f points", advice->expectedPoints);
+        } else {
+            std::snprintf(text, sizeof(text), "Then roll %d, %.0f%% zilch risk", advice->diceLeft, advice->zilchRisk * 100);
+        }
+        lines.push_back(text);
+        if (advice->lastTurn) {
+            std::snprintf(text, sizeof(text), "Chance to win: %.0f%%", advice->winChance * 100);
+        } else {
+            std::snprintf(text, sizeof(text), "Expected turn: %.0f points", advice->expectedPoints);
+        }
+        lines.push_back(text);
+    }
+
+    // Between the Bank button and the history
+    TTF_Font* font = Assets::getFont(FONT_SMALL);
+    SDL_Rect box = {470, 300, 265, 10 + 22 * static_cast<int>(lines.size())};
+    RenderBatch::fillRect(box, {0, 0, 0, 255});
+    for (size_t i = 0; i < lines.size(); ++i) {
+        SDL_Color color = i == 0 ? SDL_Color{255, 220, 0, 255} : SDL_Color{255, 255, 255, 255};
+        RenderBatch::drawText(font, lines[i], color, box.x + 8, box.y + 5 + 22 * i);
+    }
 }
 
 //Creation of Slider
@@ -40,12 +160,10 @@ struct Slider {
 
     void render(SDL_Renderer* renderer) {
         // Draw bar
-        SDL_SetRenderDrawColor(renderer, 100, 100, 100, 255);
-        SDL_RenderFillRect(renderer, &bar);
+        RenderBatch::fillRect(bar, {100, 100, 100, 255});
 
         // Draw handle
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-        SDL_RenderFillRect(renderer, &handle);
+        RenderBatch::fillRect(handle, {255, 255, 255, 255});
     }
 
     void handleEvent(SDL_Event& e) {
@@ -79,14 +197,13 @@ class Menu {
     SDL_Renderer* renderer;
     TTF_Font* font;
     std::vector<std::string> labels;
-    std::vector<SDL_Texture*> menuTextures;
     std::vector<SDL_Rect> positions;
     int selectedItem = 0;
     int selectedSubMenuItem = 0;
     bool hoverStartButton = false;
 
     bool expandButton1 = false; // Track if button1 is expanded
-    std::vector<std::string> subMenuLabels = {"Aggressive AI", "Cautious AI", "Adaptive AI"};
+    std::vector<std::string> subMenuLabels;   // One per AI profile
     std::vector<SDL_Rect> subMenuPositions;
     Slider winningPointsSlider = Slider(300, 250, 400, 20, 1000, 20000, 500, 10000);
 
@@ -112,47 +229,39 @@ public:
         : renderer(ren), font(f), labels(options) {
 
         tutorialDie.resize(NUM_DICE); //Resize for dice
+        for (const AIProfile& profile : AIProfiles::all()) {
+            subMenuLabels.push_back(profile.name);
+        }
         int startY = 450; // Starting Y position
         int spacingX = SCREEN_WIDTH / 4;  // Space for first row (3 buttons)
         int centerX = SCREEN_WIDTH / 2;   // Center for second row
 
         for (size_t i = 0; i < labels.size(); ++i) {
-            SDL_Surface* textSurface = TTF_RenderText_Solid(font, labels[i].c_str(), {255, 255, 255});
-            SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, textSurface);
-            menuTextures.push_back(texture);
+            SDL_Point textSize = RenderBatch::textSize(font, labels[i]);
 
             SDL_Rect rect;
             
             if (i < 3) { 
                 // First row (button1, button2, button3)
-                rect = {spacingX * (i + 1) - textSurface->w / 2, startY, textSurface->w, textSurface->h};
+                rect = {spacingX * (i + 1) - textSize.x / 2, startY, textSize.x, textSize.y};
             } else { 
                 // Second row (button4, button5)
                 int secondRowY = startY + 80; // Increase Y position for second row
                 int xOffset = (i == 3) ? centerX - SCREEN_WIDTH / 6 : centerX + SCREEN_WIDTH / 6; // Offset for button4 & button5
                 
-                rect = {xOffset - textSurface->w / 2, secondRowY, textSurface->w, textSurface->h};
+                rect = {xOffset - textSize.x / 2, secondRowY, textSize.x, textSize.y};
             }
 
             positions.push_back(rect);
-            SDL_FreeSurface(textSurface);
-        }
-    }
-
-    ~Menu() {
-        for (auto tex : menuTextures) {
-            SDL_DestroyTexture(tex);
         }
     }
 
     void render() {
         //TITLE CARD
         if (currentSelectedItem < 2) {
-            TTF_Font* titleFont = TTF_OpenFont("assets/fonts/TiltPrism.ttf", 120);
             std::string TitleText = "ZILCH";
             SDL_Color textColor = {255, 255, 255};  
-            renderText(renderer, titleFont, TitleText, textColor, (SCREEN_WIDTH / 2) - 150 , 50);
-            TTF_CloseFont(titleFont);
+            renderText(renderer, Assets::getFont(FONT_TITLE), TitleText, textColor, (SCREEN_WIDTH / 2) - 150 , 50);
         }
 
         if (currentSelectedItem != 3) {
@@ -177,16 +286,14 @@ public:
                 SDL_Rect rect = subMenuPositions[i];
         
                 // Fill the button with a solid color
-                SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-                SDL_RenderFillRect(renderer, &rect);
+                RenderBatch::fillRect(rect, {50, 50, 50, 255});
         
                 // Draw the outline of the button
                 SDL_Color textColor = (i == selectedSubMenuItem) ? SDL_Color{255, 0, 0} : SDL_Color{255, 255, 0}; // Red for selected, Yellow for others
 
                 // Render the start button background
                 // Change outline color based on selection
-                SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-                SDL_RenderDrawRect(renderer, &rect);
+                RenderBatch::drawRect(rect, {255, 255, 255, 255});
         
                 // Render the text inside the button
                 //SDL_Color textColor = {255, 255, 0}; // Yellow text
@@ -215,42 +322,28 @@ public:
 
             // Render the player input boxes
             renderText(renderer, font, displayedName1, {255, 255, 255}, player1InputBox.x + 5, player1InputBox.y);
-            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255); // Draw the outline of the input box
-            SDL_RenderDrawRect(renderer, &player1InputBox);
+            RenderBatch::drawRect(player1InputBox, {255, 255, 255, 255}); // Draw the outline of the input box
 
             renderText(renderer, font, displayedName2, {255, 255, 255}, player2InputBox.x + 5, player2InputBox.y);
-            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255); // Draw the outline of the input box
-            SDL_RenderDrawRect(renderer, &player2InputBox);
+            RenderBatch::drawRect(player2InputBox, {255, 255, 255, 255}); // Draw the outline of the input box
             
             // Render the start button
             // Change color if the mouse is hovering over the start button
             SDL_Color textColor = hoverStartButton ? SDL_Color{255, 0, 0} : SDL_Color{255, 255, 0}; // Red text if hovered
 
             // Render the start button background
-            SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-            SDL_RenderFillRect(renderer, &startButton);
+            RenderBatch::fillRect(startButton, {50, 50, 50, 255});
 
             // Render the button outline
-            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-            SDL_RenderDrawRect(renderer, &startButton);
+            RenderBatch::drawRect(startButton, {255, 255, 255, 255});
 
             // Render the text inside the button
             renderText(renderer, font, "Start Game", textColor, startButton.x + 10, startButton.y + 10);
         }
 
         if(currentSelectedItem == 2){
-            SDL_Surface* medalUnlockedSurface = IMG_Load("assets/textures/medal_unlocked.png");
-            SDL_Surface* medalLockedSurface = IMG_Load("assets/textures/medal_locked.png");
-            if (!medalUnlockedSurface || !medalLockedSurface) {
-                std::cerr << "Failed to load images SDL_image Error: " << IMG_GetError() << std::endl;
-            }
-
-            SDL_Texture* medalUnlocked = SDL_CreateTextureFromSurface(renderer, medalUnlockedSurface);
-            SDL_Texture* medalLocked = SDL_CreateTextureFromSurface(renderer, medalLockedSurface);
-
-            SDL_FreeSurface(medalUnlockedSurface);
-            SDL_FreeSurface(medalLockedSurface);
-            
+            Sprite medalUnlocked = Assets::getSprite(SPRITE_MEDAL_UNLOCKED);
+            Sprite medalLocked = Assets::getSprite(SPRITE_MEDAL_LOCKED);
             renderAwardsAndStatistics(renderer, font, medalUnlocked, medalLocked);
         }
     }
@@ -400,21 +493,17 @@ public:
         // ------------------------ Top Buttons ------------------------
         for (int i = 0; i < 4; ++i) {
             SDL_Rect rect = tutorialPositions[i];
-            SDL_SetRenderDrawColor(renderer, (i == currentTutorialIndex) ? selectedColor.r : 50,
-                                (i == currentTutorialIndex) ? selectedColor.g : 50,
-                                (i == currentTutorialIndex) ? selectedColor.b : 50, 255);
-            SDL_RenderFillRect(renderer, &rect);
-            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-            SDL_RenderDrawRect(renderer, &rect);
+            RenderBatch::fillRect(rect, {static_cast<Uint8>((i == currentTutorialIndex) ? selectedColor.r : 50),
+                                         static_cast<Uint8>((i == currentTutorialIndex) ? selectedColor.g : 50),
+                                         static_cast<Uint8>((i == currentTutorialIndex) ? selectedColor.b : 50), 255});
+            RenderBatch::drawRect(rect, {255, 255, 255, 255});
             renderText(renderer, font, tutorialLabels[i], normalColor, rect.x + 10, rect.y + 5);
         }
 
         // ------------------------ Bottom-Right Button ------------------------
         SDL_Rect bottomRight = {750, 710, 190, 40}; // Adjust as needed
-        SDL_SetRenderDrawColor(renderer, 80, 80, 80, 255);
-        SDL_RenderFillRect(renderer, &bottomRight);
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-        SDL_RenderDrawRect(renderer, &bottomRight);
+        RenderBatch::fillRect(bottomRight, {80, 80, 80, 255});
+        RenderBatch::drawRect(bottomRight, {255, 255, 255, 255});
         renderText(renderer, font, "Back to Menu", normalColor, bottomRight.x + 10, bottomRight.y + 5);
 
         // ------------------------ Tutorial Content ------------------------
@@ -474,7 +563,7 @@ public:
             renderText(renderer, font, "#-of-a-Kind Cases:", normalColor, 50, 435);
             renderText(renderer, font, "When calculating a #-of-a-Kind points case an equation is used", normalColor, 50, 465);
             renderText(renderer, font, "(100 * face-of-dice) * 2", normalColor, 50, 495);
-            TTF_Font* exponentFont = TTF_OpenFont("assets/fonts/Rye-Regular.ttf", 15);
+            TTF_Font* exponentFont = Assets::getFont(FONT_SMALL);
             std::string exponentText = "(#-of-dice - 3)";
             SDL_Color textColor = {255, 255, 255};  
             renderText(renderer, exponentFont, exponentText, textColor, 330, 495);
@@ -482,7 +571,6 @@ public:
             renderText(renderer, font, "1000 * 2", normalColor, 50, 555);
             exponentText = "(#-of-dice - 3)";  
             renderText(renderer, exponentFont, exponentText, textColor, 155, 555);
-            TTF_CloseFont(exponentFont);
 
             renderText(renderer, font, "Very Special Case:", normalColor, 50, 605);
             renderText(renderer, font, "Nothing [(2, 2, 3, 6, 4, 3), (4, 4, 3, 6, 6, 2)]  -->", normalColor, 50, 635);
@@ -497,21 +585,11 @@ public:
             int diceY = 250;
             int diceSize = 75;
             for (int i = 0; i < 6; ++i) {
-                std::string imagePath = "assets/textures/" + std::to_string(tutorialDie[i].value) + "-face.png";
-                SDL_Surface* diceSurface = IMG_Load(imagePath.c_str());
-
-                if (!diceSurface) {
-                    std::cerr << "Failed to load image: " << imagePath 
-                            << " SDL_image Error: " << IMG_GetError() << std::endl;
-                } else {
-                    SDL_Texture* diceTexture = SDL_CreateTextureFromSurface(renderer, diceSurface);
-                    SDL_FreeSurface(diceSurface);
-                    SDL_Rect tutorialDiceRect = {diceX, diceY, diceSize, diceSize};
-                    SDL_RenderCopy(renderer, diceTexture, nullptr, &tutorialDiceRect);
-                    SDL_DestroyTexture(diceTexture);
-                    tutorialDie[i].rect = tutorialDiceRect;
-                    diceX += 120;
-                }
+                SDL_Rect tutorialDiceRect = {diceX, diceY, diceSize, diceSize};
+                Sprite face = Assets::getDieSprite(tutorialDie[i].value);
+                RenderBatch::drawTexture(face.texture, &face.rect, tutorialDiceRect);
+                tutorialDie[i].rect = tutorialDiceRect;
+                diceX += 120;
             }
 
             // ------------------------ Render Hand Name + Points ------------------------
@@ -593,8 +671,10 @@ public:
 
 
                     } else if (selectedItem == 4) { // QUIT
-                        SDL_Quit();
-                        exit(0);
+                        // Closes the game the way the window's close button does
+                        SDL_Event quitEvent = {};
+                        quitEvent.type = SDL_QUIT;
+                        RenderThread::pushEvent(quitEvent);
                     }
                 }
             }
@@ -606,38 +686,14 @@ public:
                     if (mouseX >= subButton.x && mouseX <= subButton.x + subButton.w &&
                         mouseY >= subButton.y && mouseY <= subButton.y + subButton.h) {
                         
-                        if (i == 0) {
-                            std::string player1_name = "Player 1";
-                            std::string player2_name = "Aggressive AI";
-                            game.addPlayer(player1_name);
-                            game.addPlayer(player2_name, true, "aggressive");
-
-                            game.setWinConditionPoints(winCondition);
-                            game.setFirstTurn();
-                            inMenu = false;
-                            startGame = true;
-
-                        } else if (i == 1) {
-                            std::string player1_name = "Player 1";
-                            std::string player2_name = "Cautious AI";
-                            game.addPlayer(player1_name);
-                            game.addPlayer(player2_name, true, "cautious");
-
-                            game.setWinConditionPoints(winCondition);
-                            game.setFirstTurn();
-                            inMenu = false;
-                            startGame = true;
-                        } else if (i == 2) {
-                            std::string player1_name = "Player 1";
-                            std::string player2_name = "Adaptive AI";
-                            game.addPlayer(player1_name);
-                            game.addPlayer(player2_name, true, "adaptive");
-
-                            game.setWinConditionPoints(winCondition);
-                            game.setFirstTurn();
-                            inMenu = false;
-                            startGame = true;
-                        }
+                        const AIProfile& profile = AIProfiles::all()[i];
+                        game.addPlayer("Player 1");
+                        game.addPlayer(profile.name, true, profile.type);
+
+                        game.setWinConditionPoints(winCondition);
+                        game.setFirstTurn();
+                        inMenu = false;
+                        startGame = true;
                     }
                 }
             }
@@ -736,12 +792,36 @@ public:
 
     }
 
+    // Where a button showing this label is on the current menu screen, for UI scripts
+    bool findButton(const std::string& label, SDL_Rect& rect) const {
+        std::vector<std::pair<std::string, SDL_Rect>> shown;
+        if (currentSelectedItem != 3) {
+            for (size_t i = 0; i < labels.size(); ++i) shown.push_back({labels[i], positions[i]});
+        }
+        if (currentSelectedItem == 0) {
+            for (size_t i = 0; i < subMenuPositions.size(); ++i) shown.push_back({subMenuLabels[i], subMenuPositions[i]});
+        }
+        if (currentSelectedItem == 1) shown.push_back({"Start Game", startButton});
+        if (currentSelectedItem == 3) {
+            for (size_t i = 0; i < tutorialPositions.size(); ++i) shown.push_back({tutorialLabels[i], tutorialPositions[i]});
+            shown.push_back({"Back to Menu", {750, 710, 190, 40}});
+        }
+        for (const auto& button : shown) {
+            if (button.first == label) {
+                rect = button.second;
+                return true;
+            }
+        }
+        return false;
+    }
+
     void generateSubMenu(TTF_Font* font) {
         subMenuPositions.clear();
     
         int button1X = positions[0].x + 150;
         int button1Y = positions[0].y - 75; // Position above button1
     
+        int spacing = 40;   // Between buttons; one per AI profile, so the row grows with the file
         int totalWidth = 0;
         std::vector<int> buttonWidths;
     
@@ -751,11 +831,12 @@ public:
             TTF_SizeText(font, label.c_str(), &textW, &textH);
             int buttonW = textW + 10; // Add 5px margin on both sides
             buttonWidths.push_back(buttonW);
-            totalWidth += buttonW + 15; // Add spacing
+            totalWidth += buttonW + 10 + spacing;
         }
     
-        totalWidth -= 15; // Remove last extra spacing
+        totalWidth -= spacing; // Remove last extra spacing
         int startX = button1X + (positions[0].w / 2) - (totalWidth / 2); // Center the submenu
+        startX = std::max(15, std::min(startX, SCREEN_WIDTH - 15 - totalWidth)) + 5; // Keep it on screen
     
         for (size_t i = 0; i < subMenuLabels.size(); ++i) {
             SDL_Rect rect = {
@@ -765,7 +846,7 @@ public:
                 40  // Keep height fixed or set `textH + 10`
             };
             subMenuPositions.push_back(rect);
-            startX += buttonWidths[i] + 100; // Move to next position
+            startX += buttonWidths[i] + 10 + spacing; // Move to next position
         }
     }
 
@@ -789,7 +870,7 @@ public:
         }
     }
 
-    void renderAwardsAndStatistics(SDL_Renderer* renderer, TTF_Font* font, SDL_Texture* medalUnlocked, SDL_Texture* medalLocked) {
+    void renderAwardsAndStatistics(SDL_Renderer* renderer, TTF_Font* font, const Sprite& medalUnlocked, const Sprite& medalLocked) {
         SDL_Color textColor = {255, 255, 255};
     
         // Load statistics and achievements
@@ -805,6 +886,7 @@ public:
         int medalSpacing = 60;
     
         int medalSize = 50; // Size of the medal icon
+        size_t qualityLines = 3; // Players with Decision Quality shown
     
         int index = 0;
     
@@ -814,6 +896,36 @@ public:
             renderText(renderer, font, statText, textColor, statX, statY + (index * spacing));
             index++;
         }
+
+        // How close each player's holds and banks came to the best ones, for
+        // the ones who have made the most
+        std::vector<PlayerQuality> ratedPlayers = DecisionQuality::getPlayers();
+        if (ratedPlayers.size() > qualityLines) ratedPlayers.resize(qualityLines);
+        for (const PlayerQuality& player : ratedPlayers) {
+            if (player.rated == 0) continue;
+            char quality[128];
+            std::snprintf(quality, sizeof(quality), "%s Decision Quality: %.0f%% best, %.0f points given up each",
+                          player.name.c_str(), 100.0 * player.best / player.rated,
+                          double(player.pointsGivenUp) / player.rated);
+            renderText(renderer, font, quality, textColor, statX, statY + (index * spacing));
+            index++;
+        }
+
+        // Turn analytics below the statistics, one line per kind of player
+        int analyticsY = std::max(380, statY + index * spacing + 10);
+        renderText(renderer, font, "Turn Analytics", textColor, statX, analyticsY);
+        const std::vector<TurnStats>& rollups = Analytics::getRollups();
+        const std::vector<std::string>& typeNames = Analytics::getPlayerTypeNames();
+        int row = 1;
+        for (size_t i = 0; i < rollups.size(); ++i) {
+            if (rollups[i].turns == 0) continue;
+            char line[128];
+            std::snprintf(line, sizeof(line), "%s: avg bank %.0f, zilch %.0f%%, %s",
+                          typeNames[i].c_str(), rollups[i].averageBank(), rollups[i].zilchRate() * 100.0,
+                          Analytics::getHandName(rollups[i].mostCommonHand()).c_str());
+            renderText(renderer, font, line, textColor, statX, analyticsY + row * 35);
+            row++;
+        }
     
         // Render medals on the right
         for (size_t i = 0; i < achievementList.size(); ++i) {
@@ -821,8 +933,8 @@ public:
     
             SDL_Rect medalRect = {medalX + (i % 5) * medalSpacing, medalY + (i / 5) * (medalSize + 10), medalSize, medalSize};
     
-            SDL_Texture* texture = ach.unlocked ? medalUnlocked : medalLocked;
-            SDL_RenderCopy(renderer, texture, nullptr, &medalRect);
+            const Sprite& medal = ach.unlocked ? medalUnlocked : medalLocked;
+            RenderBatch::drawTexture(medal.texture, &medal.rect, medalRect);
     
             // If hovered, display achievement details
             int mouseX, mouseY;
@@ -844,35 +956,94 @@ public:
 
 
 
-int main() {
+int playGame(SDL_Window* window, const std::string& peerAddress, bool hostingPeer, const std::string& localName);
+
+int main(int argc, char* argv[]) {
+    // --fast plays animations and AI turns at four times the speed, --no-animation skips them.
+    // --renderer=software or --renderer=accelerated overrides picking one by whether there is a GPU.
+    // --script=<file> plays the UI from a script and reports how each screen performed (see ui_script.h).
+    // --host-game=<address> or --join-game=<address> plays a two player game with another copy over a
+    // local socket (see lockstep.h), as --name=<name>.
+    RenderBackend backend = BACKEND_AUTO;
+    std::string peerAddress;
+    bool hostingPeer = false;
+    std::string localName = "Player 1";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--fast") Animation::setSpeed(4.0f);
+        else if (arg == "--no-animation") Animation::setEnabled(false);
+        else if (arg == "--renderer=software") backend = BACKEND_SOFTWARE;
+        else if (arg == "--renderer=accelerated") backend = BACKEND_ACCELERATED;
+        else if (arg.rfind("--script=", 0) == 0 && !UiScript::load(arg.substr(9))) return -1;
+        else if (arg.rfind("--host-game=", 0) == 0) {
+            peerAddress = arg.substr(12);
+            hostingPeer = true;
+        } else if (arg.rfind("--join-game=", 0) == 0) {
+            peerAddress = arg.substr(12);
+            localName = "Player 2";
+        } else if (arg.rfind("--name=", 0) == 0) localName = arg.substr(7);
+    }
+
     // Initialize SDL and SDL_ttf
     if (SDL_Init(SDL_INIT_VIDEO) < 0 || TTF_Init() < 0) {
         std::cerr << "SDL or SDL_ttf could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
         return -1;
     }
 
-    //Create a Window
+    // Effects are decoded now so playing one later costs nothing
+    Audio::open();
+
+    // Textures and fonts load in the background; only wait for the ones the menu needs
+    Assets::startLoading();
+
+    //Create a Window; the renderer lives on this thread, which also uploads the textures
     SDL_Window *window = SDL_CreateWindow("Zilch", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
-    SDL_Renderer *renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-    TTF_Font* font = TTF_OpenFont("assets/fonts/Rye-Regular.ttf", 24);
-    if (!window || !renderer || !font) {
+    if (!window || !RenderThread::start(window, backend)) {
         std::cerr << "Failed to initialize resources! SDL_Error: " << SDL_GetError() << std::endl;
+        Assets::shutdown();
         return -1;
     }
+    std::cout << "Renderer: " << RenderThread::getBackendName() << std::endl;
 
+    // The game plays on a thread of its own; this one draws what it records until it is done
+    int status = 0;
+    std::thread gameThread([&]() {
+        status = playGame(window, peerAddress, hostingPeer, localName);
+        RenderThread::finish();
+    });
+    RenderThread::run();
+    gameThread.join();
 
-    // Setting up Background
-    std::string bgImagePath = "assets/textures/Wooden-Background.jpg";
-    SDL_Surface* bgSurface = IMG_Load(bgImagePath.c_str());    if (!bgSurface) {
-        std::cerr << "Failed to load background image: " << IMG_GetError() << std::endl;
+    // Cleanup
+    Audio::close();
+    RenderThread::stop();
+    Assets::shutdown();
+    SDL_DestroyWindow(window);
+    TTF_Quit();
+    SDL_Quit();
+
+    return status;
+}
+
+// Everything but drawing: the menus, the game, the AI and whatever they save
+int playGame(SDL_Window* window, const std::string& peerAddress, bool hostingPeer, const std::string& localName) {
+    // Passed along to the draw functions for identity only; all drawing is recorded through RenderBatch
+    SDL_Renderer *renderer = RenderThread::getRenderer();
+
+    while (!Assets::isMenuReady()) {
+        SDL_Delay(1);
+    }
+
+    TTF_Font* font = Assets::getFont(FONT_MAIN);
+    if (!font) {
+        std::cerr << "Failed to load the main font! SDL_ttf Error: " << TTF_GetError() << std::endl;
         return -1;
     }
 
-    // Transform Background from a surface to a texture
-    SDL_Texture* bgTexture = SDL_CreateTextureFromSurface(renderer, bgSurface);
-    SDL_FreeSurface(bgSurface);  // Free surface after creating texture
+    // Setting up Background
+    SDL_Texture* bgTexture = Assets::getTexture(TEXTURE_BACKGROUND);
     if (!bgTexture) {
-        std::cerr << "Failed to create background texture: " << SDL_GetError() << std::endl;
+        std::cerr << "Failed to load background image: " << IMG_GetError() << std::endl;
         return -1;
     }
 
@@ -883,6 +1054,14 @@ int main() {
     // Seed random number generator
     std::srand(static_cast<unsigned>(std::time(nullptr)));
 
+    // AI personalities, before the menu lists them or a saved game needs one
+    AIProfiles::load(AI_PROFILES_FILE);
+    Advisor::start();
+
+    // Replay saved achievements and statistics once at startup
+    Achievements::loadProgress();
+    Analytics::open();
+
     // Main loop Setup
     bool inMenu = true;
     bool inTutorial = false;
@@ -891,8 +1070,34 @@ int main() {
     Game game;
     Achievements achievements;
     bool quit = false;
+    bool showProfiler = false;
     SDL_Event e;
-    int statisticsUpdated = 0;
+
+    // Hints for the roll in front of a person, worked out by the advisor's thread
+    bool showHints = false;
+    AdviceKey hintKey;
+    Advice hint;
+    bool hintReady = false;
+
+    // Achievements and statistics follow the game through its events
+    game.addEventListener(Achievements::onGameEvent);
+    game.addEventListener(Analytics::onGameEvent);
+    game.addEventListener(Audio::onGameEvent);
+
+    // Every roll is written down; a game resumed from a snapshot keeps the rest of it
+    DecisionRecorder decisionRecorder(game);
+    decisionRecorder.setGameId(static_cast<int32_t>(std::time(nullptr)));
+    game.addEventListener([&decisionRecorder, &game](const GameEvent& event) {
+        if (event.type == EVENT_GAME_START) decisionRecorder.setGameId(static_cast<int32_t>(std::time(nullptr)));
+        decisionRecorder.onGameEvent(event);
+        if (event.type == EVENT_GAME_END) {
+            std::vector<DecisionRow> rows = decisionRecorder.getRows();
+            std::vector<std::string> names;
+            for (const auto& player : game.getPlayers()) names.push_back(player->getName());
+            bool keepRows = !UiScript::isActive();
+            Advisor::post([rows, names, keepRows] { recordPlayedGame(rows, names, keepRows); });
+        }
+    });
 
     // Create Buttons for the game
     Button rollButton = {{350, 400, 100, 50}, "Roll", {0, 128, 255, 255}};
@@ -903,40 +1108,138 @@ int main() {
     Button mainmenuButton = {{370, 550, 265, 50}, "Back to Main Menu", {0, 128, 255, 255}}; //At the end of a game
     Button returnmenuButton = {{660, 700, 290, 50}, "Return to Main Menu", {0, 128, 255, 255}}; //In the middle of Game or Tutorial
 
+    // Sound on or off, top right on every screen
+    SDL_Rect muteRect = {SCREEN_WIDTH - 68, 20, 48, 48};
+
     // CREATE PLAYERS
     std::string player1_name = "Player 1";
     std::string player2_name = "Player 2";
+
+    // Resume a game that was interrupted by a restart; a scripted run or a networked game always starts afresh
+    bool networked = !peerAddress.empty();
+    if (!UiScript::isActive() && !networked && Snapshot::load(game, SNAPSHOT_FILE)) {
+        inMenu = false;
+        startGame = true;
+    }
+    game.setAutoSnapshot(!UiScript::isActive() && !networked);
+    if (UiScript::isActive()) game.getRng() = DiceRng(UiScript::getSeed());
+
+    // Both copies play every move, so the game only starts once the other one is
+    // there; the loop below keeps the window going while it waits
+    Lockstep lockstep;
+    std::string peerError;
+    if (networked) {
+        if (hostingPeer) std::cout << "Waiting for the other player on " << peerAddress << std::endl;
+        bool started = hostingPeer ? lockstep.host(peerAddress, game, localName, game.getWinConditionPoints(), peerError)
+                                   : lockstep.join(peerAddress, game, localName, peerError);
+        if (!started) {
+            std::cerr << "Could not start the networked game: " << peerError << std::endl;
+            Advisor::stop();
+            return -1;
+        }
+        inMenu = false;
+        startGame = true;
+    }
+
+    // Every way out of a game, including one that never got past the handshake
+    auto returnToMenu = [&]() {
+        lockstep.close();
+        game.clearGame();
+        inMenu = true;
+        startGame = false;
+        menu.currentSelectedItem = -1;
+    };
+
+    // Buttons on screen right now, for UI scripts to click
+    auto findButton = [&](const std::string& label, SDL_Rect& rect) {
+        if (inMenu) return menu.findButton(label, rect);
+        std::vector<Button*> shown;
+        if (game.checkGameEnd()) {
+            shown = {&restartButton, &mainmenuButton};
+        } else {
+            shown = {&rollButton, &bankButton, &returnmenuButton};
+            if (!game.isRolling()) {
+                for (Button& btn : game.getHoldButtons()) shown.push_back(&btn);
+            }
+        }
+        for (Button* button : shown) {
+            if (button->label == label) {
+                rect = button->rect;
+                return true;
+            }
+        }
+        // Whichever hand is offered first, as a script cannot know the roll
+        if (label == "first hold" && shown.size() > 3 && !game.checkGameEnd()) {
+            rect = shown[3]->rect;
+            return true;
+        }
+        return false;
+    };
     
 
+    Uint64 lastFrame = SDL_GetPerformanceCounter();
     while (!quit) {
-        while (SDL_PollEvent(&e) != 0) {
-            if(e.type == SDL_WINDOWEVENT){
-                if (e.window.event == SDL_WINDOWEVENT_RESIZED) {
-                    SDL_SetWindowSize(window, SCREEN_WIDTH, SCREEN_HEIGHT);
-                }
-            }
+        // Everything animated runs off this clock rather than waiting
+        Uint64 thisFrame = SDL_GetPerformanceCounter();
+        Animation::update(static_cast<float>(thisFrame - lastFrame) / SDL_GetPerformanceFrequency());
+        lastFrame = thisFrame;
+
+        UiScene scene = inMenu ? (menu.currentSelectedItem == 2 ? SCENE_AWARDS : SCENE_MENU)
+                               : (game.checkGameEnd() ? SCENE_GAME_OVER : SCENE_GAME);
+        UiScript::beginFrame(window, scene, findButton);
+
+        // Totals are live in the shared segment; this writes them to disk every few seconds
+        achievements.saveProgress();
+
+        // Handshake with the other copy, a step a frame
+        if (!lockstep.pollStart(peerError)) {
+            std::cerr << "Could not start the networked game: " << peerError << std::endl;
+            peerError.clear();
+            returnToMenu();
+        }
+        bool waitingForPeer = lockstep.getStatus() == Lockstep::CONNECTING;
+
+        // The render thread polls the window and passes its events on
+        while (RenderThread::pollEvent(e)) {
             if (e.type == SDL_QUIT) {
                 quit = true;
             }
+            if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F3 && !e.key.repeat) {
+                showProfiler = !showProfiler;
+            }
+            if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_h && !e.key.repeat && !inMenu) {
+                showHints = !showHints;
+                if (showHints) Advisor::request(hintKey);
+            }
+
+            if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT) {
+                SDL_Point click = {e.button.x, e.button.y};
+                if (SDL_PointInRect(&click, &muteRect)) {
+                    Audio::setMuted(!Audio::isMuted());
+                    continue;
+                }
+            }
 
             if (inMenu) {
-                statisticsUpdated = 0;
                 menu.handleEvent(e, game, renderer, inMenu, startGame, inTutorial);
+            } else if (waitingForPeer) {
+                // Nothing to play yet, but the wait can be given up
+                if (e.type == SDL_MOUSEBUTTONDOWN && returnmenuButton.isClicked(e.button.x, e.button.y)) {
+                    returnToMenu();
+                }
             } else {
 
-                if (game.getCurrentPlayerIsAI() && !game.checkGameEnd()) {
-                    //Retrieve currentPlayer for the AI
-                    game.getPlayers()[game.getCurrentPlayer()]->takeTurn(game, renderer, font, rollButton, bankButton, returnmenuButton, bgTexture, bgRect, game.getPlayers()[game.getCurrentPlayer()]);
+                bool othersTurn = game.getCurrentPlayerIsAI() ||
+                                  (lockstep.getStatus() != Lockstep::OFF && !lockstep.isLocalTurn());
+                if (othersTurn && !game.checkGameEnd()) {
+                    // The AI or the other copy plays from the main loop; only leaving the game is possible meanwhile
                     if (e.type == SDL_MOUSEBUTTONDOWN) {
                         int mouseX, mouseY;
                         SDL_GetMouseState(&mouseX, &mouseY);
     
                           
                         if (returnmenuButton.isClicked(mouseX, mouseY)) {
-                            game.clearGame();
-                            inMenu = true;
-                            startGame = false;
-                            menu.currentSelectedItem = -1;
+                            returnToMenu();
                         }
 
                     }
@@ -949,7 +1252,8 @@ int main() {
                     int mouseX, mouseY;
                     SDL_GetMouseState(&mouseX, &mouseY);
 
-                    if(!game.checkGameEnd()){
+                    // Nothing can be held, banked or rolled again until the dice have landed
+                    if(!game.checkGameEnd() && !game.isRolling()){
 
                         //Retrieve current Player for display calls
                         //game.getPlayers()[game.getCurrentPlayer()]
@@ -972,8 +1276,14 @@ int main() {
                                 if(game.getPlayers()[currentPlayer]->getFirstRoll()){
                                     game.getPlayers()[currentPlayer]->firstRolled();
                                 }
-                                game.rollDice(renderer, font, bgTexture, bgRect);
+                                game.rollDice();
+                                InputLatency::inputHandled(INPUT_ROLL, e.common.timestamp);
                                 game.getPossibleHolds();
+                                lockstep.played({TurnAction::ROLL, 0});
+
+                                hintKey = Advisor::keyFor(game);
+                                hintReady = false;
+                                if (showHints) Advisor::request(hintKey);
                             }
                         }
 
@@ -989,78 +1299,84 @@ int main() {
 
                             if(canBank){
                                 game.bankCurrentPlayerScore();
+                                InputLatency::inputHandled(INPUT_BANK, e.common.timestamp);
+                                lockstep.played({TurnAction::BANK, 0});
                             }
                         }
 
                         for (Button& btn : game.getHoldButtons()) {
                             if (btn.isClicked(x, y)) {
                                 if (btn.onClick) {
+                                    // Taken before the click, which may end the turn and remove the buttons
+                                    int button = holdButtonId(btn.getLabel());
+                                    TurnAction move = button < 0 ? TurnAction{TurnAction::ZILCH, 0} : TurnAction::press(button);
+
                                     // Setting up so that rolls can be done after a single button selected
                                     btn.toggleSelected();
                                     
                                     // Call the assigned function
                                     btn.onClick();
+                                    InputLatency::inputHandled(INPUT_HOLD, e.common.timestamp);
+                                    lockstep.played(move);
                                 }
                             }
                         }
 
-                        if (returnmenuButton.isClicked(mouseX, mouseY)) {
-                            game.clearGame();
-                            inMenu = true;
-                            startGame = false;
-                            menu.currentSelectedItem = -1;
-                        }    
+                    }
+                    if (!game.checkGameEnd() && returnmenuButton.isClicked(mouseX, mouseY)) {
+                        returnToMenu();
                     }
                     if (game.checkGameEnd()) {    
-                        if (restartButton.isClicked(mouseX, mouseY)) {
-                            statisticsUpdated = 0;
+                        // A networked game is over for good; another one needs both copies started again
+                        if (lockstep.getStatus() == Lockstep::OFF && restartButton.isClicked(mouseX, mouseY)) {
                             game.restartGame();
                         }
                         if (mainmenuButton.isClicked(mouseX, mouseY)) {
-                            game.clearGame();
-                            inMenu = true;
-                            startGame = false;
-                            menu.currentSelectedItem = -1;
+                            returnToMenu();
                         }
                     }       
                 }
             }
         }
+        // AI turns advance a step at a time, paced by the animation clock
+        if (!inMenu && !game.getPlayers().empty() && game.getCurrentPlayerIsAI() && !game.checkGameEnd()) {
+            game.getPlayers()[game.getCurrentPlayer()]->update(game);
+        }
+        // So do the other copy's moves, one a frame once the dice have landed
+        TurnAction remoteMove;
+        if (!inMenu && !game.isRolling() && lockstep.takeRemote(remoteMove)) {
+            playAction(game, remoteMove);
+        }
+
         // Render screen
-        SDL_RenderClear(renderer);
-        SDL_RenderCopy(renderer, bgTexture, nullptr, &bgRect);
+        RenderBatch::drawTexture(bgTexture, nullptr, bgRect);
 
         if (inMenu) {
             menu.render();
+        } else if (waitingForPeer) {
+            std::string waiting = hostingPeer ? "Waiting for the other player on " + peerAddress
+                                              : "Waiting for the other player";
+            SDL_Point size = RenderBatch::textSize(font, waiting);
+            renderText(renderer, font, waiting, {255, 255, 255, 255}, (SCREEN_WIDTH - size.x) / 2, (SCREEN_HEIGHT - size.y) / 2);
+            returnmenuButton.render(renderer, font);
         } else {
 
             // Checking if the game is over, and displays the winner
             if (game.checkGameEnd()) {
-                TTF_Font* winnerFont = TTF_OpenFont("assets/fonts/TiltPrism.ttf", 80);
+                TTF_Font* winnerFont = Assets::getFont(FONT_WINNER);
 
-                std::string winnerText = game.getWinningPlayerName(achievements, statisticsUpdated);
+                std::string winnerText = game.getWinningPlayerName();
 
-                statisticsUpdated = 1;
-                achievements.saveProgress();
                 SDL_Color white = {255, 255, 255, 255};
                 
-                // Create text surface and texture
-                SDL_Surface* surface = TTF_RenderText_Solid(winnerFont, winnerText.c_str(), white);
-                SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-
                 // Center the text on screen
-                int x = (SCREEN_WIDTH - surface->w) / 2;
-                int y = (SCREEN_HEIGHT - surface->h) / 2;
-                SDL_Rect textRect = {x, (y - 150), surface->w, surface->h};
-                SDL_RenderCopy(renderer, texture, nullptr, &textRect);
-
-                // Clean up
-                SDL_FreeSurface(surface);
-                SDL_DestroyTexture(texture);
-                TTF_CloseFont(winnerFont);
+                SDL_Point size = RenderBatch::textSize(winnerFont, winnerText);
+                int x = (SCREEN_WIDTH - size.x) / 2;
+                int y = (SCREEN_HEIGHT - size.y) / 2;
+                RenderBatch::drawText(winnerFont, winnerText, white, x, y - 150);
 
                 // Render
-                restartButton.render(renderer, font);
+                if (lockstep.getStatus() == Lockstep::OFF) restartButton.render(renderer, font);
                 mainmenuButton.render(renderer, font);
             } else {
                 // In the middle of a game
@@ -1068,29 +1384,47 @@ int main() {
                 bankButton.render(renderer, font);  // Render the bank button
                 returnmenuButton.render(renderer, font); //render the return menu button
                 
-                // Render each button so that holds can be called individually
-                for (Button& btn : game.getHoldButtons()) {
-                    btn.render(renderer, font);
+                // Render each button so that holds can be called individually, once the dice have landed
+                if (!game.isRolling()) {
+                    for (Button& btn : game.getHoldButtons()) {
+                        btn.render(renderer, font);
+                    }
+                }
+
+                // Only ever looked up, so a hint still being worked out never holds up the frame
+                if (showHints && !game.getCurrentPlayerIsAI() && !game.isRolling() &&
+                    !game.getHoldButtons().empty() && hintKey.isValid()) {
+                    if (!hintReady) hintReady = Advisor::lookup(hintKey, hint);
+                    drawHintPanel(hintReady ? &hint : nullptr);
                 }
                 
                 game.displaySoftScore(renderer, font); // Render the score for soft points
                 game.displayHardScore(renderer, font); // Render the score for hard points
                 game.displayHistory(renderer, font, game.getPlayers()[game.getCurrentPlayer()]); //Render History
                 game.displayDice(renderer);  // Render dice and their hold states
+
+                // A networked game that cannot go on stays on screen as it was
+                if (lockstep.getStatus() == Lockstep::DESYNCED || lockstep.getStatus() == Lockstep::PEER_LEFT) {
+                    std::string problem = lockstep.getStatus() == Lockstep::DESYNCED ? "Out of sync with the other player"
+                                                                                     : "The other player left";
+                    renderText(renderer, font, problem, {255, 80, 80, 255}, 20, 20);
+                }
             }
         }
 
-        SDL_RenderPresent(renderer);  // Update the screen
+        if (showProfiler) drawProfilerOverlay();
+
+        Sprite muteIcon = Assets::getSprite(Audio::isMuted() ? SPRITE_MUTE : SPRITE_UNMUTE);
+        RenderBatch::drawTexture(muteIcon.texture, &muteIcon.rect, muteRect);
+
+        UiScript::endFrame();        // Measured before submitting, which may wait for the display
+        RenderBatch::submitFrame();  // The render thread draws and presents it
     }
 
     // Cleanup
-    SDL_DestroyTexture(bgTexture);
-    TTF_CloseFont(font);
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
-    TTF_Quit();
-    IMG_Quit();
-    SDL_Quit();
+    Advisor::stop();
+    Analytics::flush();
+    Achievements::compactProgress();
 
-    return 0;
+    return UiScript::finish();
 }
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "match_runner.h"
+#include "game.h"
+#include "ai_profile.h"
+#include <thread>
+#include <atomic>
+#include <vector>
+
+void MatchRunner::setUp(Game& game, const AIProfile* const seats[2], int points, uint64_t seed) {
+    for (int seat = 0; seat < 2; ++seat) {
+        game.addPlayer(seats[seat]->name, *seats[seat]);
+    }
+    game.getRng() = DiceRng(seed);
+    game.setWinConditionPoints(points);
+}
+
+bool MatchRunner::play(Game& game) {
+    game.setFirstTurn();
+    for (int updates = 0; !game.checkGameEnd(); ++updates) {
+        if (updates == MAX_UPDATES_PER_GAME) return false;
+        game.getPlayers()[game.getCurrentPlayer()]->update(game);
+    }
+    return true;
+}
+
+int MatchRunner::winner(Game& game) {
+    int first = game.getPlayers()[0]->getHardPoints(), second = game.getPlayers()[1]->getHardPoints();
+    return first > second ? 0 : (second > first ? 1 : -1);
+}
+
+void MatchRunner::runParallel(size_t count, int threads, const std::function<void(size_t index, int worker)>& job) {
+    std::atomic<size_t> nextJob{0};
+    auto work = [&](int worker) {
+        for (size_t index = nextJob++; index < count; index = nextJob++) {
+            job(index, worker);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; ++i) pool.emplace_back(work, i);
+    for (std::thread& thread : pool) thread.join();
+}
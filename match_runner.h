@@ -0,0 +1,32 @@
+#ifndef MATCH_RUNNER_H
+#define MATCH_RUNNER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+class Game;
+struct AIProfile;
+
+// A game between two AIs takes a few hundred updates; this only stops one that never ends
+const int MAX_UPDATES_PER_GAME = 100000;
+
+// Headless games between AI profiles for the offline tools (tuner, trainer,
+// exporter), played as fast as the AI decides. The tools turn animation off
+// first, so each update plays the next move.
+class MatchRunner {
+public:
+    // Seats the two profiles the way the menu would and sets the dice and
+    // target; listeners and parameters can still be added before play()
+    static void setUp(Game& game, const AIProfile* const seats[2], int points, uint64_t seed);
+    // Plays the game to the end; false if it never ended
+    static bool play(Game& game);
+    // Seat of the player with more points, -1 for a tie
+    static int winner(Game& game);
+
+    // Runs job for every index below count, shared out among threads; worker
+    // is which of them runs it, for state kept per thread
+    static void runParallel(size_t count, int threads, const std::function<void(size_t index, int worker)>& job);
+};
+
+#endif
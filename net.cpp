@@ -0,0 +1,194 @@
+#include "net.h"
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+namespace {
+
+const char TCP_PREFIX[] = "tcp:";
+const size_t HEADER_SIZE = 7;           // u16 size, u8 type, u32 game
+const size_t RECEIVE_CHUNK = 4096;
+
+bool isTcp(const std::string& address, int& port) {
+    if (address.compare(0, sizeof(TCP_PREFIX) - 1, TCP_PREFIX) != 0) return false;
+    port = std::atoi(address.c_str() + sizeof(TCP_PREFIX) - 1);
+    return true;
+}
+
+sockaddr_in loopback(int port) {
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return addr;
+}
+
+bool unixAddress(const std::string& path, sockaddr_un& addr, std::string& error) {
+    addr = {};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        error = "socket path must be 1 to " + std::to_string(sizeof(addr.sun_path) - 1) + " characters";
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+// Replies are a few bytes, so they should not wait to be batched
+void noDelay(int fd) {
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+int fail(int fd, std::string& error, const std::string& what) {
+    error = what + ": " + std::strerror(errno);
+    if (fd >= 0) ::close(fd);
+    return -1;
+}
+
+}
+
+
+int Net::listen(const std::string& address, std::string& error) {
+    int port = 0;
+    if (isTcp(address, port)) {
+        if (port <= 0 || port > 65535) {
+            error = "bad port in " + address;
+            return -1;
+        }
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return fail(fd, error, "socket");
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr = loopback(port);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) return fail(fd, error, "bind " + address);
+        if (::listen(fd, SOMAXCONN) != 0) return fail(fd, error, "listen " + address);
+        return fd;
+    }
+
+    sockaddr_un addr;
+    if (!unixAddress(address, addr, error)) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return fail(fd, error, "socket");
+    unlink(address.c_str());    // Left behind by a host that did not shut down
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) return fail(fd, error, "bind " + address);
+    if (::listen(fd, SOMAXCONN) != 0) return fail(fd, error, "listen " + address);
+    return fd;
+}
+
+int Net::accept(int listener) {
+    int fd = ::accept(listener, nullptr, nullptr);
+    if (fd >= 0) noDelay(fd);
+    return fd;
+}
+
+int Net::connect(const std::string& address, std::string& error) {
+    int port = 0;
+    if (isTcp(address, port)) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return fail(fd, error, "socket");
+        sockaddr_in addr = loopback(port);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) return fail(fd, error, "connect " + address);
+        noDelay(fd);
+        return fd;
+    }
+
+    sockaddr_un addr;
+    if (!unixAddress(address, addr, error)) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return fail(fd, error, "socket");
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) return fail(fd, error, "connect " + address);
+    return fd;
+}
+
+void Net::close(int fd, const std::string& address) {
+    if (fd >= 0) ::close(fd);
+    int port = 0;
+    if (!address.empty() && !isTcp(address, port)) unlink(address.c_str());
+}
+
+void Net::shutdown(int fd) {
+    if (fd >= 0) ::shutdown(fd, SHUT_RDWR);
+}
+
+bool Net::sendAll(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        data += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+bool Net::sendFrame(int fd, const Frame& frame) {
+    std::vector<uint8_t> out;
+    putFrame(out, frame);
+    return sendAll(fd, out.data(), out.size());
+}
+
+bool Net::sendSome(int fd, std::vector<uint8_t>& buffer) {
+    size_t sent = 0;
+    while (sent < buffer.size()) {
+        ssize_t now = send(fd, buffer.data() + sent, buffer.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (now < 0 && errno == EINTR) continue;
+        if (now < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (now <= 0) {
+            buffer.clear();
+            return false;
+        }
+        sent += now;
+    }
+    buffer.erase(buffer.begin(), buffer.begin() + sent);
+    return true;
+}
+
+bool Net::receive(int fd, std::vector<uint8_t>& buffer) {
+    uint8_t chunk[RECEIVE_CHUNK];
+    while (true) {
+        ssize_t got = recv(fd, chunk, sizeof(chunk), 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        buffer.insert(buffer.end(), chunk, chunk + got);
+        return true;
+    }
+}
+
+bool Net::takeFrame(std::vector<uint8_t>& buffer, Frame& frame) {
+    size_t size = 0;
+    while (true) {
+        if (buffer.size() < 2) return false;
+        size = buffer[0] | (buffer[1] << 8);
+        if (buffer.size() < 2 + size) return false;
+        if (size >= HEADER_SIZE - 2) break;
+        buffer.erase(buffer.begin(), buffer.begin() + 2 + size);    // Too short to be a frame
+    }
+    frame.type = buffer[2];
+    frame.game = buffer[3] | (buffer[4] << 8) | (buffer[5] << 16) | (uint32_t(buffer[6]) << 24);
+    frame.body.assign(buffer.begin() + HEADER_SIZE, buffer.begin() + 2 + size);
+    buffer.erase(buffer.begin(), buffer.begin() + 2 + size);
+    return true;
+}
+
+bool Net::readFrame(int fd, std::vector<uint8_t>& buffer, Frame& frame) {
+    while (!takeFrame(buffer, frame)) {
+        if (!receive(fd, buffer)) return false;
+    }
+    return true;
+}
+
+void Net::putFrame(std::vector<uint8_t>& out, const Frame& frame) {
+    size_t size = HEADER_SIZE - 2 + frame.body.size();
+    out.push_back(size & 0xFF);
+    out.push_back(size >> 8);
+    out.push_back(frame.type);
+    for (int shift = 0; shift < 32; shift += 8) out.push_back((frame.game >> shift) & 0xFF);
+    out.insert(out.end(), frame.body.begin(), frame.body.end());
+}
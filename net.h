@@ -0,0 +1,44 @@
+#ifndef NET_H
+#define NET_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// One message: u16 size | u8 type | u32 game | body, little endian, where size
+// counts everything after itself. Game 0 is for messages about no game.
+struct Frame {
+    uint8_t type = 0;
+    uint32_t game = 0;
+    std::vector<uint8_t> body;
+};
+
+// Local sockets for the host and networked play (POSIX only). An address is a
+// Unix socket path, or "tcp:PORT" for TCP on the loopback interface.
+class Net {
+public:
+    // -1 on failure, with error set
+    static int listen(const std::string& address, std::string& error);
+    static int accept(int listener);
+    static int connect(const std::string& address, std::string& error);
+    // A listener's Unix socket file is removed too
+    static void close(int fd, const std::string& address = "");
+    // Ends both directions but keeps the descriptor, so nothing else can be given its number yet
+    static void shutdown(int fd);
+
+    static bool sendAll(int fd, const uint8_t* data, size_t size);
+    static bool sendFrame(int fd, const Frame& frame);
+    // Sends as much of buffer as the socket takes without waiting and removes
+    // it from the front; false once the peer is gone
+    static bool sendSome(int fd, std::vector<uint8_t>& buffer);
+    // Appends whatever has arrived, waiting for something; false once the peer is gone
+    static bool receive(int fd, std::vector<uint8_t>& buffer);
+    // Takes the first whole frame off the front of buffer
+    static bool takeFrame(std::vector<uint8_t>& buffer, Frame& frame);
+    // Waits for the next frame; false once the peer is gone
+    static bool readFrame(int fd, std::vector<uint8_t>& buffer, Frame& frame);
+
+    static void putFrame(std::vector<uint8_t>& out, const Frame& frame);
+};
+
+#endif
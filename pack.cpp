@@ -0,0 +1,108 @@
+#include "pack.h"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+const char MAGIC[4] = {'Z', 'P', 'A', 'K'};
+
+// Same FNV-1a as Snapshot::checksum, repeated so the packer does not have to link the game
+uint32_t checksum(const uint8_t* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+}
+
+static_assert(sizeof(PackEntry) == 96, "PackEntry is written to disk as is");
+
+
+AssetPack::~AssetPack() {
+    close();
+}
+
+bool AssetPack::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < HEADER_SIZE) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+    mapping = static_cast<const uint8_t*>(mapped);
+    mappedSize = info.st_size;
+
+    uint16_t version, count;
+    std::memcpy(&version, mapping + sizeof(MAGIC), sizeof(version));
+    std::memcpy(&count, mapping + sizeof(MAGIC) + sizeof(version), sizeof(count));
+    if (std::memcmp(mapping, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION ||
+        HEADER_SIZE + count * sizeof(PackEntry) > mappedSize) {
+        close();
+        return false;
+    }
+
+    entries.resize(count);
+    std::memcpy(entries.data(), mapping + HEADER_SIZE, count * sizeof(PackEntry));
+    for (const PackEntry& entry : entries) {
+        if (entry.offset + entry.size > mappedSize) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetPack::close() {
+    if (mapping) {
+        munmap(const_cast<uint8_t*>(mapping), mappedSize);
+        mapping = nullptr;
+        mappedSize = 0;
+    }
+    entries.clear();
+}
+
+const PackEntry* AssetPack::find(const std::string& name) const {
+    for (const PackEntry& entry : entries) {
+        if (name == entry.name) return &entry;
+    }
+    return nullptr;
+}
+
+bool AssetPack::verify(const PackEntry& entry) const {
+    return checksum(data(entry), entry.size) == entry.checksum;
+}
+
+std::vector<uint8_t> AssetPack::build(std::vector<PackEntry> newEntries, const std::vector<std::vector<uint8_t>>& blobs) {
+    size_t offset = HEADER_SIZE + newEntries.size() * sizeof(PackEntry);
+    for (size_t i = 0; i < newEntries.size(); ++i) {
+        offset = (offset + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+        newEntries[i].offset = offset;
+        newEntries[i].size = blobs[i].size();
+        newEntries[i].checksum = checksum(blobs[i].data(), blobs[i].size());
+        offset += blobs[i].size();
+    }
+
+    std::vector<uint8_t> out(offset, 0);
+    uint16_t version = VERSION;
+    uint16_t count = static_cast<uint16_t>(newEntries.size());
+    std::memcpy(out.data(), MAGIC, sizeof(MAGIC));
+    std::memcpy(out.data() + sizeof(MAGIC), &version, sizeof(version));
+    std::memcpy(out.data() + sizeof(MAGIC) + sizeof(version), &count, sizeof(count));
+    std::memcpy(out.data() + HEADER_SIZE, newEntries.data(), newEntries.size() * sizeof(PackEntry));
+    for (size_t i = 0; i < newEntries.size(); ++i) {
+        if (!blobs[i].empty()) std::memcpy(out.data() + newEntries[i].offset, blobs[i].data(), blobs[i].size());
+    }
+    return out;
+}
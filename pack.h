@@ -0,0 +1,65 @@
+#ifndef PACK_H
+#define PACK_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// File built from assets/ by the packer (make pack)
+const std::string ASSET_PACK_FILE = "assets.pak";
+
+enum PackEntryKind : uint8_t {
+    PACK_TEXTURE = 1,   // Decoded pixels in pixelFormat, pitch bytes per row
+    PACK_FONT = 2,      // The .ttf file as is
+    PACK_AUDIO = 3      // Decoded PCM in audioFormat
+};
+
+// One entry of the index. Names are paths relative to assets/, e.g. "textures/1-face.png".
+struct PackEntry {
+    char name[48];
+    uint8_t kind;
+    uint8_t channels;       // Audio only
+    uint16_t audioFormat;   // Audio only, an SDL_AudioFormat
+    uint32_t width;         // Textures only
+    uint32_t height;
+    uint32_t pitch;
+    uint32_t pixelFormat;   // An SDL_PixelFormatEnum
+    uint32_t frequency;     // Audio only
+    uint32_t checksum;      // Of the data
+    uint64_t offset;        // From the start of the file, aligned to PACK_ALIGNMENT
+    uint64_t size;
+};
+
+// Pack layout:
+//   "ZPAK" | u16 version | u16 entryCount | PackEntry[entryCount] | data
+// The whole file is mapped read only; entries point straight into the mapping.
+class AssetPack {
+public:
+    static const uint16_t VERSION = 1;
+    static const size_t PACK_ALIGNMENT = 16;
+    static const size_t HEADER_SIZE = 8;
+
+    ~AssetPack();
+
+    // False if the file is missing, damaged or from another version
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return mapping != nullptr; }
+
+    const PackEntry* find(const std::string& name) const;
+    const uint8_t* data(const PackEntry& entry) const { return mapping + entry.offset; }
+
+    // Checksums the entry's data, which reads all of it
+    bool verify(const PackEntry& entry) const;
+
+    // Used by the packer
+    static std::vector<uint8_t> build(std::vector<PackEntry> entries, const std::vector<std::vector<uint8_t>>& blobs);
+
+private:
+    const uint8_t* mapping = nullptr;
+    size_t mappedSize = 0;
+    std::vector<PackEntry> entries;
+};
+
+#endif
@@ -0,0 +1,151 @@
+// Offline asset packer: bakes assets/ into a single pack file for the game to map.
+// Usage: packer <assets directory> <output pack>
+#include <SDL.h>
+#include <SDL_image.h>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include "pack.h"
+
+namespace fs = std::filesystem;
+
+// Pixels are stored the way SDL_CreateTextureFromSurface would upload them
+const Uint32 PACK_PIXEL_FORMAT = SDL_PIXELFORMAT_ARGB8888;
+
+bool setName(PackEntry& entry, const std::string& name) {
+    if (name.size() >= sizeof(entry.name)) {
+        std::cerr << "Name too long for the pack: " << name << std::endl;
+        return false;
+    }
+    std::strncpy(entry.name, name.c_str(), sizeof(entry.name) - 1);
+    return true;
+}
+
+bool packTexture(const fs::path& file, PackEntry& entry, std::vector<uint8_t>& blob) {
+    SDL_Surface* loaded = IMG_Load(file.string().c_str());
+    if (!loaded) {
+        std::cerr << "Failed to load image: " << file << " SDL_image Error: " << IMG_GetError() << std::endl;
+        return false;
+    }
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(loaded, PACK_PIXEL_FORMAT, 0);
+    SDL_FreeSurface(loaded);
+    if (!converted) {
+        std::cerr << "Failed to convert image: " << file << " SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    entry.kind = PACK_TEXTURE;
+    entry.width = converted->w;
+    entry.height = converted->h;
+    entry.pitch = converted->w * 4;
+    entry.pixelFormat = PACK_PIXEL_FORMAT;
+
+    // Rows are stored tightly packed
+    blob.resize(static_cast<size_t>(entry.pitch) * entry.height);
+    SDL_LockSurface(converted);
+    for (int y = 0; y < converted->h; ++y) {
+        std::memcpy(blob.data() + y * entry.pitch, static_cast<uint8_t*>(converted->pixels) + y * converted->pitch, entry.pitch);
+    }
+    SDL_UnlockSurface(converted);
+    SDL_FreeSurface(converted);
+    return true;
+}
+
+bool packFont(const fs::path& file, PackEntry& entry, std::vector<uint8_t>& blob) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Failed to read font: " << file << std::endl;
+        return false;
+    }
+    blob.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    entry.kind = PACK_FONT;
+    return true;
+}
+
+bool packAudio(const fs::path& file, PackEntry& entry, std::vector<uint8_t>& blob) {
+    SDL_AudioSpec spec;
+    Uint8* buffer = nullptr;
+    Uint32 length = 0;
+    if (!SDL_LoadWAV(file.string().c_str(), &spec, &buffer, &length)) {
+        std::cerr << "Failed to load audio: " << file << " SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    blob.assign(buffer, buffer + length);
+    SDL_FreeWAV(buffer);
+
+    entry.kind = PACK_AUDIO;
+    entry.audioFormat = spec.format;
+    entry.channels = spec.channels;
+    entry.frequency = spec.freq;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: packer <assets directory> <output pack>" << std::endl;
+        return 1;
+    }
+    fs::path root = argv[1];
+    std::string output = argv[2];
+
+    if (SDL_Init(0) < 0) {
+        std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG);
+
+    // Sorted so the pack is the same from one build to the next
+    std::vector<fs::path> files;
+    for (const char* folder : {"textures", "fonts", "audio"}) {
+        std::error_code error;
+        for (const auto& item : fs::directory_iterator(root / folder, error)) {
+            if (item.is_regular_file()) files.push_back(item.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<PackEntry> entries;
+    std::vector<std::vector<uint8_t>> blobs;
+    bool ok = true;
+    for (const fs::path& file : files) {
+        std::string extension = file.extension().string();
+        std::string folder = file.parent_path().filename().string();
+        PackEntry entry = {};
+        std::vector<uint8_t> blob;
+
+        bool packed;
+        if (folder == "textures" && (extension == ".png" || extension == ".jpg")) {
+            packed = packTexture(file, entry, blob);
+        } else if (folder == "fonts" && extension == ".ttf") {
+            packed = packFont(file, entry, blob);
+        } else if (folder == "audio" && extension == ".wav") {
+            packed = packAudio(file, entry, blob);
+        } else {
+            continue; // e.g. the .mp3 copies of the sounds
+        }
+
+        if (!packed || !setName(entry, folder + "/" + file.filename().string())) {
+            ok = false;
+            continue;
+        }
+        std::cout << "  " << entry.name << " (" << blob.size() << " bytes)" << std::endl;
+        entries.push_back(entry);
+        blobs.push_back(std::move(blob));
+    }
+
+    if (ok) {
+        std::vector<uint8_t> pack = AssetPack::build(entries, blobs);
+        std::string tempPath = output + ".tmp";
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(pack.data()), pack.size());
+        out.close();
+        ok = out && std::rename(tempPath.c_str(), output.c_str()) == 0;
+        if (ok) std::cout << "Wrote " << output << ": " << entries.size() << " entries, " << pack.size() << " bytes" << std::endl;
+    }
+
+    IMG_Quit();
+    SDL_Quit();
+    return ok ? 0 : 1;
+}
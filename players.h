@@ -6,10 +6,14 @@
 #include <vector>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include "animation.h"
+#include "ai_profile.h"
+#include "decision_cache.h"
 
 // Forward declaration to avoid circular dependency
 class Game;
 class Button;
+struct HoldChoice;
 
 
 class Player {
@@ -37,9 +41,13 @@ public:
 
     bool getFirstRoll() const;
 
+    // The AI profile's type for AI players, empty for humans
+    virtual std::string getAIType() const;
+
     // Virtual function for AI behavior
     bool isAIPlayer() const;
-    virtual void takeTurn(Game& game, SDL_Renderer* renderer, TTF_Font* font, Button rollButton, Button bankButton, Button mainmenu, SDL_Texture* bgTexture, SDL_Rect bgRect, std::unique_ptr<Player>& currentPlayer); //Placeholder that is overriden by AI classes
+    // Called every frame while it is this player's turn; AI classes play their turn from here, a step at a time
+    virtual void update(Game& game);
 
     // Banking History
     void addToHistory(int points, bool isZilch);
@@ -66,53 +74,82 @@ class AIPlayer : public Player {
         AIPlayer(std::string name, bool isAI = true);
         virtual ~AIPlayer() = default;
     
-        virtual void takeTurn(Game& game, SDL_Renderer* renderer, TTF_Font* font, Button rollButton, Button bankButton, Button mainmenu, SDL_Texture* bgTexture, SDL_Rect bgRect, std::unique_ptr<Player>& currentPlayer) override = 0;
+        // Rolls, then presses the chosen hands one by one, then banks or rolls again.
+        // Never waits: pauses between actions are timeline steps on the animation clock.
+        void update(Game& game) override;
+
+        // The personality's tunable numbers, in the order of its table
+        virtual const std::vector<AIParam>& getParamTable() const = 0;
+        const std::vector<float>& getParams() const { return params; }
+        // Clamped to the table's ranges; false if the count does not match
+        bool setParams(const std::vector<float>& values);
+        void resetParams();
     
     protected:
-        virtual void selectHands(Game& game) = 0;
+        // Labels of the hold buttons to press, in order; sets zilched if nothing scores
+        virtual std::vector<std::string> selectHands(Game& game) = 0;
         virtual bool shouldBank(Game& game) = 0;
-};
-    
-/// Aggressive AI
-class AggressiveAI : public AIPlayer {
-    public:
-        AggressiveAI(std::string name);
-        void takeTurn(Game& game, SDL_Renderer* renderer, TTF_Font* font, Button rollButton, Button bankButton, Button mainmenu, SDL_Texture* bgTexture, SDL_Rect bgRect, std::unique_ptr<Player>& currentPlayer) override;
-    
-    private:
-        void selectHands(Game& game) override;
-        bool shouldBank(Game& game) override;
+        virtual void onTurnStart();
+        virtual void onRoll(bool freeRoll);
+
+        // Called once params has changed
+        virtual void applyParams() {}
+
         bool zilched;
-        int rolledAgain;
+        int rolledAgain;    // Rolls made so far this turn
+        std::vector<float> params;
+
+    private:
+        static void pressHoldButton(Game& game, const std::string& label);
+
+        Timeline steps;
+        bool inTurn = false;
+        bool canRollAgain = false;
 };
     
-/// Cautious AI
-class CautiousAI : public AIPlayer {
+/// Profile AI: plays any personality from assets/ai_profiles.json
+class ProfileAI : public AIPlayer {
     public:
-        CautiousAI(std::string name);
-        void takeTurn(Game& game, SDL_Renderer* renderer, TTF_Font* font, Button rollButton, Button bankButton, Button mainmenu, SDL_Texture* bgTexture, SDL_Rect bgRect, std::unique_ptr<Player>& currentPlayer) override;
-    
+        ProfileAI(std::string name, const AIProfile& profile);
+        std::string getAIType() const override;
+        const std::vector<AIParam>& getParamTable() const override;
+        // With the tuned params applied
+        const AIProfile& getProfile() const { return profile; }
+
     private:
-        void selectHands(Game& game) override;
+        std::vector<std::string> selectHands(Game& game) override;
         bool shouldBank(Game& game) override;
-        bool zilched;
-        int rolledAgain;
+        void applyParams() override;
+
+        AIProfile profile;
+        std::shared_ptr<const ProfileTables> tables;
+        std::vector<AIParam> paramTable;
 };
-    
-    
-/// Advanced/Adaptive AI
-class AdaptiveAI : public AIPlayer {
+
+/// Learned AI: holds whatever leaves the best chance of winning, by its value model
+class LearnedAI : public AIPlayer {
     public:
-        AdaptiveAI(std::string name);
-        void takeTurn(Game& game, SDL_Renderer* renderer, TTF_Font* font, Button rollButton, Button bankButton, Button mainmenu, SDL_Texture* bgTexture, SDL_Rect bgRect, std::unique_ptr<Player>& currentPlayer) override;
-        
+        LearnedAI(std::string name, const AIProfile& profile);
+        std::string getAIType() const override;
+        const std::vector<AIParam>& getParamTable() const override;  // Nothing to tune
+
     private:
-        void selectHands(Game& game) override;
+        std::vector<std::string> selectHands(Game& game) override;
         bool shouldBank(Game& game) override;
-        float safeProbability(int remainingDice);
-        long long combination(int n, int r);
-        bool zilched;
-        int rolledAgain;
+
+        // The hold with the best chance of winning, and whether banking would then beat rolling on
+        HoldChoice bestHold(Game& game, bool& bankAfter) const;
+        DecisionKey keyFor(Game& game, DecisionKey::Kind kind) const;
+        // The bank decision that comes up once a hold from key's roll is made
+        static DecisionKey afterHold(const DecisionKey& key, const HoldChoice& held);
+
+        // Chance of winning when rolling on with this turn's points, or banking them
+        float rollValue(Game& game, int turnPoints, int dice) const;
+        float bankValue(Game& game, int turnPoints) const;
+
+        std::string type;
+        std::shared_ptr<const ValueModel> model;
+        std::vector<AIParam> noParams;
 };
 
 #endif
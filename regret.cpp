@@ -0,0 +1,216 @@
+#include "regret.h"
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+const int POINT_STEP = 50;      // Every hand scores a multiple of this
+const int STEPS = TurnSolver::MAX_TURN_POINTS / POINT_STEP + 1;
+const int MAX_DICE = 6;
+const int ZILCH_PENALTY = 500;
+
+// Calls visit(counts, chance) for every set of n dice, counts[1] to [6] per face
+template <typename Visit>
+void forEachRoll(int counts[7], int face, int left, double chance, const Visit& visit) {
+    if (face == 6) {
+        counts[6] = left;
+        visit(counts, chance / std::tgamma(left + 1));
+        return;
+    }
+    for (int n = 0; n <= left; ++n) {
+        counts[face] = n;
+        forEachRoll(counts, face + 1, left - n, chance / std::tgamma(n + 1), visit);
+    }
+}
+
+}
+
+
+const TurnSolver& TurnSolver::get() {
+    static const TurnSolver solver;
+    return solver;
+}
+
+TurnSolver::TurnSolver() {
+    auto start = std::chrono::steady_clock::now();
+    for (int dice = 1; dice <= MAX_DICE; ++dice) {
+        // Each set of dice comes up in dice! / (a! b! ...) of the 6^dice orders
+        double orders = std::tgamma(dice + 1) / std::pow(6.0, dice);
+        int counts[7] = {};
+        forEachRoll(counts, 1, dice, orders, [&](const int* faceCounts, double chance) {
+            Outcome outcome = {chance, {}};
+            for (const HoldChoice& choice : holdChoices(offeredHolds(faceCounts))) {
+                auto same = std::find_if(outcome.choices.begin(), outcome.choices.end(),
+                                         [&](const HoldChoice& kept) { return kept.dice == choice.dice; });
+                if (same == outcome.choices.end()) outcome.choices.push_back(choice);
+                else if (choice.points > same->points) *same = choice;
+            }
+            outcomes[dice].push_back(outcome);
+        });
+    }
+
+    // The tables never look at each other's values
+    std::thread withPenalty([this]() { solve(true); });
+    std::thread chase([this]() { solveChase(); });
+    solve(false);
+    withPenalty.join();
+    chase.join();
+    solveSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Every choice adds points, so each turn score only needs the higher ones
+void TurnSolver::solve(bool zilchPenalty) {
+    std::vector<float>& values = rolls[zilchPenalty];
+    values.assign(STEPS * (MAX_DICE + 1), 0.0f);
+    for (int step = STEPS - 1; step >= 0; --step) {
+        for (int dice = 1; dice <= MAX_DICE; ++dice) {
+            values[step * (MAX_DICE + 1) + dice] = expectRoll(step, dice, zilchPenalty);
+        }
+    }
+}
+
+// Every choice brings the goal closer, so each distance only needs the shorter ones
+void TurnSolver::solveChase() {
+    chases.assign(STEPS * (MAX_DICE + 1), 0.0f);
+    for (int step = 0; step < STEPS; ++step) {
+        for (int dice = 1; dice <= MAX_DICE; ++dice) {
+            double chance = 0;
+            for (const Outcome& outcome : outcomes[dice]) {
+                double best = 0;
+                for (const HoldChoice& choice : outcome.choices) {
+                    int left = step - choice.points / POINT_STEP;
+                    best = std::max(best, left <= 0 ? 1.0 : chanceAt(left, dice - choice.dice <= 0 ? MAX_DICE : dice - choice.dice));
+                }
+                chance += outcome.chance * best;
+            }
+            chases[step * (MAX_DICE + 1) + dice] = chance;
+        }
+    }
+}
+
+// Needing more than the table covers is taken as needing the most it does
+double TurnSolver::chanceAt(int stepsNeeded, int dice) const {
+    stepsNeeded = std::min(std::max(stepsNeeded, 0), STEPS - 1);
+    return chases[stepsNeeded * (MAX_DICE + 1) + dice];
+}
+
+double TurnSolver::expectRoll(int step, int dice, bool zilchPenalty) const {
+    int turnPoints = step * POINT_STEP;
+    double expected = 0;
+    for (const Outcome& outcome : outcomes[dice]) {
+        double best = zilchPenalty ? -ZILCH_PENALTY : 0;
+        for (size_t i = 0; i < outcome.choices.size(); ++i) {
+            const HoldChoice& choice = outcome.choices[i];
+            double value = holdValue(turnPoints + choice.points, dice - choice.dice, zilchPenalty);
+            if (i == 0 || value > best) best = value;
+        }
+        expected += outcome.chance * best;
+    }
+    return expected;
+}
+
+double TurnSolver::rollValue(int turnPoints, int dice, bool zilchPenalty) const {
+    dice = std::min(std::max(dice, 1), MAX_DICE);
+    int step = std::max(turnPoints, 0) / POINT_STEP;
+    if (step < STEPS && !rolls[zilchPenalty].empty()) {
+        return rolls[zilchPenalty][step * (MAX_DICE + 1) + dice];
+    }
+    return expectRoll(step, dice, zilchPenalty);
+}
+
+double TurnSolver::holdValue(int turnPoints, int dice, bool zilchPenalty) const {
+    if (turnPoints > MAX_TURN_POINTS) return turnPoints;
+    double roll = rollValue(turnPoints, dice <= 0 ? MAX_DICE : dice, zilchPenalty);
+    return turnPoints >= MIN_BANK_POINTS ? std::max<double>(roll, turnPoints) : roll;
+}
+
+// Banking needs at least MIN_BANK_POINTS too; steps are rounded up as hands score in steps
+double TurnSolver::rollChance(int turnPoints, int dice, int goal) const {
+    int needed = std::max(goal, MIN_BANK_POINTS) - turnPoints;
+    return chanceAt((needed + POINT_STEP - 1) / POINT_STEP, std::min(std::max(dice, 1), MAX_DICE));
+}
+
+double TurnSolver::holdChance(int turnPoints, int dice, int goal) const {
+    if (turnPoints >= std::max(goal, MIN_BANK_POINTS)) return 1;
+    return rollChance(turnPoints, dice <= 0 ? MAX_DICE : dice, goal);
+}
+
+double TurnSolver::zilchChance(int dice) const {
+    double chance = 0;
+    for (const Outcome& outcome : outcomes[std::min(std::max(dice, 1), MAX_DICE)]) {
+        if (outcome.choices.empty()) chance += outcome.chance;
+    }
+    return chance;
+}
+
+
+bool DecisionRating::isBest() const {
+    return regret < (lastTurn ? BEST_LAST_TURN_REGRET : BEST_DECISION_REGRET);
+}
+
+DecisionRating rateDecision(const DecisionRow& row) {
+    DecisionRating rating;
+    if (row.legal == 0) return rating;
+
+    const TurnSolver& solver = TurnSolver::get();
+    bool penalty = row.zilches >= 2;    // The next zilch is the third
+    // The opponent has reached the target, so this turn ends the game: only passing them counts
+    rating.lastTurn = row.opponentScore >= row.target;
+    int goal = row.opponentScore - row.ownScore + 1;
+    auto holdValue = [&](int turnPoints, int dice) {
+        return rating.lastTurn ? solver.holdChance(turnPoints, dice, goal) : solver.holdValue(turnPoints, dice, penalty);
+    };
+
+    bool first = true;
+    for (const HoldChoice& choice : holdChoices(static_cast<uint32_t>(row.legal))) {
+        int turnPoints = row.turnPoints + choice.points;
+        double value = holdValue(turnPoints, row.dice - choice.dice);
+        if (first || value > rating.best) {
+            rating.best = value;
+            rating.bestHold = choice.mask;
+            rating.bestBanks = turnPoints >= MIN_BANK_POINTS &&
+                               value == (rating.lastTurn ? (turnPoints >= goal ? 1.0 : 0.0) : turnPoints);
+            first = false;
+        }
+    }
+
+    HoldChoice held = holdMaskValue(static_cast<uint32_t>(row.held));
+    int turnPoints = row.turnPoints + held.points;
+    int left = row.dice - held.dice <= 0 ? MAX_DICE : row.dice - held.dice;
+    switch (row.action) {
+        case ACTION_ZILCH:      // Held nothing though something scored
+            rating.chosen = rating.lastTurn ? 0 : (penalty ? -ZILCH_PENALTY : 0);
+            break;
+        case ACTION_BANK:
+            rating.chosen = rating.lastTurn ? (turnPoints >= goal ? 1 : 0) : turnPoints;
+            break;
+        default:
+            rating.chosen = rating.lastTurn ? solver.rollChance(turnPoints, left, goal)
+                                            : solver.rollValue(turnPoints, left, penalty);
+            break;
+    }
+    rating.regret = std::max(rating.best - rating.chosen, 0.0);
+    rating.rated = true;
+    return rating;
+}
+
+std::vector<DecisionRating> rateDecisions(const std::vector<DecisionRow>& rows, int threads) {
+    TurnSolver::get();      // Solved once, not by whichever worker gets there first
+    std::vector<DecisionRating> ratings(rows.size());
+    if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<size_t>(threads, rows.size() / 64 + 1);
+
+    auto rateRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) ratings[i] = rateDecision(rows[i]);
+    };
+    std::vector<std::thread> pool;
+    size_t chunk = (rows.size() + threads - 1) / threads;
+    for (int i = 1; i < threads; ++i) {
+        pool.emplace_back(rateRange, std::min(rows.size(), i * chunk), std::min(rows.size(), (i + 1) * chunk));
+    }
+    rateRange(0, std::min(rows.size(), chunk));
+    for (std::thread& thread : pool) thread.join();
+    return ratings;
+}
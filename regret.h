@@ -0,0 +1,76 @@
+#ifndef REGRET_H
+#define REGRET_H
+
+#include <vector>
+#include <cstdint>
+#include "decisions.h"
+#include "rules.h"
+
+// Best play for the rest of a turn, worked out once for every turn score up to
+// MAX_TURN_POINTS and every number of dice:
+//  - expected points banked, or lost to a zilch, with and without a zilch costing 500
+//  - on the last turn, once the opponent has reached the target, the chance of banking
+//    enough to pass them, which only depends on how many points are still needed.
+// Otherwise winning the game is not looked at: a turn is only worth its points.
+class TurnSolver {
+public:
+    static const int MAX_TURN_POINTS = 50000;   // Banked at once beyond this
+
+    // Solved on first use, the three tables on threads of their own
+    static const TurnSolver& get();
+
+    // Before rolling dice with turnPoints already held
+    double rollValue(int turnPoints, int dice, bool zilchPenalty) const;
+    // With turnPoints held and dice left to roll (0 for all held): the better of banking and rolling on
+    double holdValue(int turnPoints, int dice, bool zilchPenalty) const;
+
+    // The same for the chance of banking at least goal points in the turn
+    double rollChance(int turnPoints, int dice, int goal) const;
+    double holdChance(int turnPoints, int dice, int goal) const;
+
+    // Chance that a roll of this many dice scores nothing
+    double zilchChance(int dice) const;
+
+    double getSolveSeconds() const { return solveSeconds; }
+
+private:
+    // One set of rolled dice and the best points it offers for each number of dice held
+    struct Outcome {
+        double chance;
+        std::vector<HoldChoice> choices;
+    };
+
+    TurnSolver();
+    void solve(bool zilchPenalty);
+    void solveChase();
+    double expectRoll(int step, int dice, bool zilchPenalty) const;
+    double chanceAt(int stepsNeeded, int dice) const;
+
+    std::vector<Outcome> outcomes[7];           // By dice rolled
+    std::vector<float> rolls[2];                // rollValue by penalty, step of 50 points and dice
+    std::vector<float> chases;                  // rollChance by steps still needed and dice
+    double solveSeconds = 0;
+};
+
+// What one decision gave up against the best play from the same roll
+struct DecisionRating {
+    bool rated = false;         // A zilch with nothing to hold was no decision
+    bool lastTurn = false;      // Rated by the chance of winning rather than points
+    double chosen = 0;          // Expected turn points, or chance of winning, after what was done
+    double best = 0;            // ... after the best choice
+    double regret = 0;          // best - chosen
+    uint64_t bestHold = 0;      // Hold mask of the best choice
+    bool bestBanks = false;
+
+    bool isBest() const;
+};
+
+// Regret below these is as good as the best choice
+const double BEST_DECISION_REGRET = 0.5;        // Expected points
+const double BEST_LAST_TURN_REGRET = 0.001;     // Chance of winning
+
+DecisionRating rateDecision(const DecisionRow& row);
+// Shares the rows out over threads (0 for one per core)
+std::vector<DecisionRating> rateDecisions(const std::vector<DecisionRow>& rows, int threads = 0);
+
+#endif
@@ -0,0 +1,116 @@
+// Renderer benchmark: draws the same scripted game screen through the
+// accelerated and the software (dirty rectangle) paths and reports what a
+// frame costs on each. Usage: render_bench [frames]
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <thread>
+#include "assets.h"
+#include "batch.h"
+#include "render_thread.h"
+
+const int BENCH_WIDTH = 1000;
+const int BENCH_HEIGHT = 800;
+
+// Roughly the screen in the middle of a game: a score counting up, a die
+// changing now and then and a pulsing highlight, on a background that never changes
+void drawScene(int frame) {
+    TTF_Font* font = Assets::getFont(FONT_MAIN);
+    SDL_Color white = {255, 255, 255, 255};
+
+    RenderBatch::drawTexture(Assets::getTexture(TEXTURE_BACKGROUND), nullptr, {0, 0, BENCH_WIDTH, BENCH_HEIGHT});
+
+    RenderBatch::drawText(font, "Player 1", white, 20, 20);
+    RenderBatch::drawText(font, "Score: 1250", white, 20, 50);
+    RenderBatch::drawText(font, "Player 2", white, 600, 20);
+    RenderBatch::drawText(font, "Score: 900", white, 600, 50);
+    RenderBatch::drawText(font, "Soft Points: " + std::to_string(frame / 3 * 50), white, 200, 75);
+
+    const char* labels[] = {"Roll", "Bank", "Return to Main Menu"};
+    SDL_Rect buttons[] = {{350, 400, 100, 50}, {350, 500, 100, 50}, {660, 700, 290, 50}};
+    for (int i = 0; i < 3; ++i) {
+        RenderBatch::fillRect(buttons[i], {0, 128, 255, 255});
+        RenderBatch::drawRect(buttons[i], {0, 0, 0, 255}, 3);
+        RenderBatch::drawText(font, labels[i], white, buttons[i].x + 10, buttons[i].y + 10);
+    }
+
+    for (int i = 0; i < 6; ++i) {
+        int value = (i == 2) ? (frame / 20) % 6 + 1 : i + 1;
+        Sprite face = Assets::getDieSprite(value);
+        RenderBatch::drawTexture(face.texture, &face.rect, {100 + i * 90, 200, 75, 75});
+    }
+    int thickness = 2 + (frame / 10) % 3;
+    RenderBatch::drawRect({100 - thickness, 200 - thickness, 75 + 2 * thickness, 75 + 2 * thickness}, {255, 230, 0, 255}, thickness);
+
+    RenderBatch::fillRect({700, 300, 250, 300}, {50, 50, 50, 255});
+    for (int i = 0; i < 5; ++i) {
+        RenderBatch::drawText(font, "Banked " + std::to_string(300 + i * 150), white, 710, 310 + i * 35);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 600;
+    if (frames <= 0) {
+        std::cerr << "Usage: render_bench [frames]" << std::endl;
+        return 1;
+    }
+    if (SDL_Init(SDL_INIT_VIDEO) < 0 || TTF_Init() < 0) {
+        std::cerr << "SDL or SDL_ttf could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    // Measure the drawing, not the wait for the display
+    SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+
+    int status = 0;
+    for (RenderBackend backend : {BACKEND_ACCELERATED, BACKEND_SOFTWARE}) {
+        // A fresh window each time, as the accelerated renderer may have made the last one a GL window
+        SDL_Window* window = SDL_CreateWindow("Zilch renderer benchmark", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                              BENCH_WIDTH, BENCH_HEIGHT, SDL_WINDOW_SHOWN);
+        Assets::startLoading();
+        if (!window || !RenderThread::start(window, backend)) {
+            std::cerr << "Could not start a renderer. SDL_Error: " << SDL_GetError() << std::endl;
+            Assets::shutdown();
+            if (window) SDL_DestroyWindow(window);
+            status = 1;
+            continue;
+        }
+
+        // Recorded on a thread of its own, as the game does, and drawn on this one
+        std::thread recorder([frames]() {
+            while (!Assets::isFullyLoaded()) {
+                SDL_Delay(1);
+            }
+            for (int frame = 0; frame < frames; ++frame) {
+                drawScene(frame);
+                RenderBatch::submitFrame();
+            }
+            RenderThread::finish();
+        });
+        RenderThread::run();
+        recorder.join();
+
+        RenderBackend used = RenderThread::getBackend();
+        std::string name = RenderThread::getBackendName();
+        RenderThread::stop();
+        Assets::shutdown();
+        SDL_DestroyWindow(window);
+
+        RenderStats stats = RenderThread::getStats();
+        if (used != backend) {
+            std::cout << "accelerated: not available, fell back to " << name << std::endl;
+            continue;
+        }
+        if (stats.frames == 0) continue;
+        std::cout << std::fixed << std::setprecision(3)
+                  << name << ": " << stats.frames << " frames, "
+                  << stats.drawMilliseconds / stats.frames << " ms per frame, "
+                  << std::setprecision(1) << 100.0 * stats.updatedFraction / stats.frames << "% of the window presented" << std::endl;
+    }
+
+    TTF_Quit();
+    SDL_Quit();
+    return status;
+}
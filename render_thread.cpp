@@ -0,0 +1,408 @@
+#include "render_thread.h"
+#include "assets.h"
+#include "batch.h"
+#include "dirty_rects.h"
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+#include <deque>
+#include <chrono>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+// While no frames arrive the thread still wakes this often to upload loaded assets
+const auto IDLE_WAKE = std::chrono::milliseconds(2);
+
+// The software path has no vsync to wait on, so it keeps itself to this rate instead
+const auto SOFTWARE_FRAME_TIME = std::chrono::microseconds(16667);
+
+const uint64_t HASH_SEED = 0xcbf29ce484222325ULL;
+
+struct RenderTask {
+    std::function<void(SDL_Renderer*)> work;
+    std::promise<void>* done;
+};
+
+std::thread::id renderThreadId;
+SDL_Renderer* renderer = nullptr;
+SDL_Window* targetWindow = nullptr;
+int windowWidth = 0;
+int windowHeight = 0;
+RenderBackend backend = BACKEND_ACCELERATED;
+
+// Software path only
+DirtyRects dirtyRects;
+std::atomic<bool> invalidated{true};
+std::chrono::steady_clock::time_point nextSoftwareFrame;
+bool paceSoftwareFrames = true;
+
+std::mutex statsMutex;
+RenderStats stats;
+
+std::mutex frameMutex;
+std::condition_variable frameReady;     // Wakes the render thread
+std::condition_variable frameClaimed;   // Wakes a game thread waiting in submit()
+bool running = false;
+
+// Polled from the window on the render thread, taken by the game thread
+std::mutex eventMutex;
+std::deque<SDL_Event> events;
+
+// The game thread owns recording, the render thread owns drawing, and the
+// waiting frame is only swapped with either under frameMutex
+RenderFrame frames[3];
+RenderFrame* recording = &frames[0];
+RenderFrame* waiting = &frames[1];
+RenderFrame* drawing = &frames[2];
+bool frameWaiting = false;
+
+std::vector<RenderTask> tasks;
+std::atomic<int> lastDrawCalls{0};
+
+uint64_t hashBytes(const void* data, size_t size, uint64_t hash) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Surfaces are new every frame, so they are told apart by what they show
+uint64_t hashSurface(SDL_Surface* surface) {
+    uint64_t hash = hashBytes(&surface->w, sizeof(surface->w), HASH_SEED);
+    hash = hashBytes(&surface->h, sizeof(surface->h), hash);
+    SDL_LockSurface(surface);
+    for (int y = 0; y < surface->h; ++y) {
+        hash = hashBytes(static_cast<const char*>(surface->pixels) + y * surface->pitch,
+                         surface->w * surface->format->BytesPerPixel, hash);
+    }
+    SDL_UnlockSurface(surface);
+    return hash;
+}
+
+SDL_Rect quadBounds(const SDL_Vertex* quad) {
+    float minX = quad[0].position.x, maxX = minX, minY = quad[0].position.y, maxY = minY;
+    for (int i = 1; i < 4; ++i) {
+        minX = std::min(minX, quad[i].position.x);
+        maxX = std::max(maxX, quad[i].position.x);
+        minY = std::min(minY, quad[i].position.y);
+        maxY = std::max(maxY, quad[i].position.y);
+    }
+    int x = static_cast<int>(std::floor(minX)), y = static_cast<int>(std::floor(minY));
+    return {x, y, static_cast<int>(std::ceil(maxX)) - x, static_cast<int>(std::ceil(maxY)) - y};
+}
+
+// Per-frame surfaces become textures once, however many times the frame is drawn
+void uploadSurfaces(const RenderFrame& frame, std::vector<SDL_Texture*>& uploaded) {
+    uploaded.assign(frame.usedBatches, nullptr);
+    for (size_t i = 0; i < frame.usedBatches; ++i) {
+        if (!frame.batches[i].surface) continue;
+        uploaded[i] = SDL_CreateTextureFromSurface(renderer, frame.batches[i].surface);
+        RenderThread::countTextureUpload();
+    }
+}
+
+int drawBatches(const RenderFrame& frame, const std::vector<SDL_Texture*>& uploaded) {
+    int drawCalls = 0;
+    for (size_t i = 0; i < frame.usedBatches; ++i) {
+        const DrawBatch& batch = frame.batches[i];
+        if (batch.indices.empty()) continue;
+        SDL_Texture* texture = batch.surface ? uploaded[i] : batch.texture;
+        if (batch.surface && !texture) continue;
+        SDL_RenderGeometry(renderer, texture, batch.vertices.data(), batch.vertices.size(),
+                           batch.indices.data(), batch.indices.size());
+        drawCalls++;
+    }
+    return drawCalls;
+}
+
+// Returns the share of the window presented
+float drawAccelerated(const RenderFrame& frame, const std::vector<SDL_Texture*>& uploaded) {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    lastDrawCalls = drawBatches(frame, uploaded);
+    SDL_RenderPresent(renderer);
+    return 1.0f;
+}
+
+// Only the tiles whose quads changed are redrawn, clipped, and copied to the window
+float drawSoftware(const RenderFrame& frame, const std::vector<SDL_Texture*>& uploaded) {
+    if (invalidated.exchange(false)) dirtyRects.invalidate();
+
+    dirtyRects.beginFrame();
+    for (size_t i = 0; i < frame.usedBatches; ++i) {
+        const DrawBatch& batch = frame.batches[i];
+        uint64_t source = batch.surface ? hashSurface(batch.surface) : reinterpret_cast<uintptr_t>(batch.texture);
+        for (size_t v = 0; v + 4 <= batch.vertices.size(); v += 4) {
+            dirtyRects.addQuad(quadBounds(&batch.vertices[v]), hashBytes(&batch.vertices[v], 4 * sizeof(SDL_Vertex), source));
+        }
+    }
+    const std::vector<SDL_Rect>& rects = dirtyRects.endFrame();
+    if (rects.empty()) {
+        lastDrawCalls = 0;
+        return 0;
+    }
+
+    int drawCalls = 0;
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    for (const SDL_Rect& rect : rects) {
+        SDL_RenderSetClipRect(renderer, &rect);
+        SDL_RenderFillRect(renderer, &rect);
+        drawCalls += drawBatches(frame, uploaded);
+    }
+    SDL_RenderSetClipRect(renderer, nullptr);
+    SDL_RenderFlush(renderer);
+    SDL_UpdateWindowSurfaceRects(targetWindow, rects.data(), rects.size());
+    lastDrawCalls = drawCalls;
+    return dirtyRects.getDirtyFraction();
+}
+
+void draw(const RenderFrame& frame) {
+    Uint64 started = SDL_GetPerformanceCounter();
+
+    std::vector<SDL_Texture*> uploaded;
+    uploadSurfaces(frame, uploaded);
+    float updated = backend == BACKEND_SOFTWARE ? drawSoftware(frame, uploaded) : drawAccelerated(frame, uploaded);
+    InputLatency::framePresented(frame.inputs);
+    for (SDL_Texture* texture : uploaded) {
+        if (texture) SDL_DestroyTexture(texture);
+    }
+
+    double milliseconds = 1000.0 * (SDL_GetPerformanceCounter() - started) / SDL_GetPerformanceFrequency();
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats.frames++;
+        stats.drawMilliseconds += milliseconds;
+        stats.updatedFraction += updated;
+    }
+
+    if (backend == BACKEND_SOFTWARE && paceSoftwareFrames) {
+        auto now = std::chrono::steady_clock::now();
+        if (nextSoftwareFrame > now) std::this_thread::sleep_until(nextSoftwareFrame);
+        else nextSoftwareFrame = now;
+        nextSoftwareFrame += SOFTWARE_FRAME_TIME;
+    }
+}
+
+// LIBGL_ALWAYS_SOFTWARE is how machines without a usable GPU are set up to run the game
+bool hasNoGpu() {
+    const char* softwareGl = SDL_getenv("LIBGL_ALWAYS_SOFTWARE");
+    return softwareGl && *softwareGl && std::strcmp(softwareGl, "0") != 0;
+}
+
+SDL_Renderer* createRenderer(SDL_Window* window) {
+    if (backend == BACKEND_AUTO) backend = hasNoGpu() ? BACKEND_SOFTWARE : BACKEND_ACCELERATED;
+    if (backend == BACKEND_ACCELERATED) {
+        SDL_Renderer* accelerated = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+        if (accelerated) return accelerated;
+        std::cerr << "No accelerated renderer, using the software one. SDL_Error: " << SDL_GetError() << std::endl;
+        backend = BACKEND_SOFTWARE;
+    }
+
+    // Vsync turned off (for benchmarks) also turns off the software path's own pacing
+    paceSoftwareFrames = SDL_GetHintBoolean(SDL_HINT_RENDER_VSYNC, SDL_TRUE);
+    nextSoftwareFrame = std::chrono::steady_clock::now();
+    dirtyRects.resize(windowWidth, windowHeight);
+    invalidated = true;
+    return SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+}
+
+// Only the render thread may poll the window; everything it sends goes on to the game thread
+void forwardEvents() {
+    SDL_Event event;
+    while (SDL_PollEvent(&event) != 0) {
+        if (event.type == SDL_WINDOWEVENT) {
+            // The game is laid out for one size only
+            if (event.window.event == SDL_WINDOWEVENT_RESIZED) {
+                SDL_SetWindowSize(targetWindow, windowWidth, windowHeight);
+            }
+            // Anything the window system threw away is redrawn, not just what changed
+            if (event.window.event == SDL_WINDOWEVENT_EXPOSED || event.window.event == SDL_WINDOWEVENT_RESIZED ||
+                event.window.event == SDL_WINDOWEVENT_RESTORED) {
+                invalidated = true;
+            }
+        }
+        RenderThread::pushEvent(event);
+    }
+}
+
+}
+
+
+void RenderFrame::clear() {
+    for (size_t i = 0; i < usedBatches; ++i) {
+        DrawBatch& batch = batches[i];
+        if (batch.surface) SDL_FreeSurface(batch.surface);
+        batch.surface = nullptr;
+        batch.texture = nullptr;
+        batch.vertices.clear();
+        batch.indices.clear();
+        batch.bounds.clear();
+    }
+    usedBatches = 0;
+    inputs.clear();
+}
+
+bool RenderThread::start(SDL_Window* window, RenderBackend chosen) {
+    targetWindow = window;
+    backend = chosen;
+    SDL_GetWindowSize(window, &windowWidth, &windowHeight);
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats = RenderStats();
+    }
+    renderThreadId = std::this_thread::get_id();
+    renderer = createRenderer(window);
+    if (!renderer) return false;
+    running = true;
+    return true;
+}
+
+void RenderThread::run() {
+    std::unique_lock<std::mutex> lock(frameMutex);
+    while (true) {
+        lock.unlock();
+        forwardEvents();
+        lock.lock();
+
+        while (!tasks.empty()) {
+            RenderTask task = std::move(tasks.front());
+            tasks.erase(tasks.begin());
+            lock.unlock();
+            task.work(renderer);
+            task.done->set_value();
+            lock.lock();
+        }
+
+        if (frameWaiting) {
+            std::swap(waiting, drawing);
+            frameWaiting = false;
+            frameClaimed.notify_all();
+            lock.unlock();
+            Assets::update(renderer);
+            draw(*drawing);
+            Assets::framePresented();
+            lock.lock();
+            continue;
+        }
+
+        if (!running) break;
+
+        lock.unlock();
+        Assets::update(renderer);
+        lock.lock();
+        frameReady.wait_for(lock, IDLE_WAKE, [] { return frameWaiting || !tasks.empty() || !running; });
+    }
+}
+
+void RenderThread::finish() {
+    {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        running = false;
+    }
+    frameReady.notify_all();
+    frameClaimed.notify_all();
+}
+
+void RenderThread::stop() {
+    finish();
+    if (!renderer) return;
+
+    // Textures go with the renderer, on the thread that made them
+    RenderBatch::releaseTextures();
+    Assets::releaseTextures();
+    SDL_DestroyRenderer(renderer);
+    renderer = nullptr;
+
+    for (RenderFrame& frame : frames) {
+        frame.clear();
+    }
+    std::lock_guard<std::mutex> lock(eventMutex);
+    events.clear();
+}
+
+SDL_Renderer* RenderThread::getRenderer() {
+    return renderer;
+}
+
+RenderBackend RenderThread::getBackend() {
+    return backend;
+}
+
+const char* RenderThread::getBackendName() {
+    return backend == BACKEND_SOFTWARE ? "software (dirty rectangles)" : "accelerated";
+}
+
+void RenderThread::invalidate() {
+    invalidated = true;
+}
+
+bool RenderThread::pollEvent(SDL_Event& event) {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    if (events.empty()) return false;
+    event = events.front();
+    events.pop_front();
+    return true;
+}
+
+void RenderThread::pushEvent(const SDL_Event& event) {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    events.push_back(event);
+}
+
+RenderFrame& RenderThread::recordingFrame() {
+    return *recording;
+}
+
+void RenderThread::submit() {
+    {
+        std::unique_lock<std::mutex> lock(frameMutex);
+        frameClaimed.wait(lock, [] { return !frameWaiting || !running; });
+        if (running) {
+            std::swap(recording, waiting);
+            frameWaiting = true;
+        }
+    }
+    frameReady.notify_one();
+
+    // Either the frame the render thread last let go of, or this one if nobody will draw it
+    recording->clear();
+}
+
+void RenderThread::invoke(const std::function<void(SDL_Renderer*)>& work) {
+    if (std::this_thread::get_id() == renderThreadId) {
+        work(renderer);
+        return;
+    }
+
+    std::promise<void> done;
+    std::future<void> finished = done.get_future();
+    {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        if (!running) return;
+        tasks.push_back({work, &done});
+    }
+    frameReady.notify_one();
+    finished.wait();
+}
+
+int RenderThread::getDrawCalls() {
+    return lastDrawCalls;
+}
+
+RenderStats RenderThread::getStats() {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return stats;
+}
+
+void RenderThread::countTextureUpload() {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    stats.textureUploads++;
+}
@@ -0,0 +1,90 @@
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include <SDL.h>
+#include <vector>
+#include <functional>
+#include "latency.h"
+
+// One run of quads drawn with a single SDL_RenderGeometry call
+struct DrawBatch {
+    SDL_Texture* texture = nullptr;
+    SDL_Surface* surface = nullptr;     // Uploaded for this frame only, in place of texture
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+    std::vector<SDL_Rect> bounds;       // Everything drawn by this batch, to test overlaps against
+};
+
+// Everything one frame draws, in order. Filled by the game thread, then
+// handed over whole and never changed while the render thread draws it.
+struct RenderFrame {
+    std::vector<DrawBatch> batches;     // Kept between frames so the buffers keep their capacity
+    size_t usedBatches = 0;
+    std::vector<InputStamp> inputs;     // Inputs this frame is the first to show
+
+    void clear();
+};
+
+enum RenderBackend {
+    BACKEND_AUTO,           // Software when there is no GPU to speak of, accelerated otherwise
+    BACKEND_ACCELERATED,
+    BACKEND_SOFTWARE        // SDL's software renderer on the window surface, presenting only what changed
+};
+
+// Frame cost as measured on the render thread, from the first draw call to the end of the present
+struct RenderStats {
+    int frames = 0;
+    double drawMilliseconds = 0;    // Summed over all frames
+    double updatedFraction = 0;     // Summed share of the window presented
+    long long textureUploads = 0;   // Textures created from pixels, assets and glyph atlases included
+};
+
+// Owns the renderer on the main thread, the one that made the window, as SDL
+// needs it to; the game runs on a thread of its own. The game thread records a
+// frame and submits it; the render thread passes the window's events on to it,
+// uploads loaded assets, draws the newest frame and presents it. Three frames
+// rotate between recording, waiting and drawing, so a slow turn or a save on
+// the game thread never holds up a present, and a slow present only holds up
+// the game thread once a whole frame is already waiting.
+class RenderThread {
+public:
+    // Creates the renderer on the calling thread, which becomes the render
+    // thread; false if it could not be created
+    static bool start(SDL_Window* window, RenderBackend backend = BACKEND_AUTO);
+    // The render thread's loop, drawing every frame submitted until finish()
+    static void run();
+    // Lets run() return once the frames already submitted are drawn
+    static void finish();
+    // Releases all textures and the renderer, on the render thread once run() has returned
+    static void stop();
+
+    static SDL_Renderer* getRenderer();
+    static RenderBackend getBackend();     // The one chosen, never BACKEND_AUTO once started
+    static const char* getBackendName();
+
+    // The window needs drawing in full, e.g. it was uncovered
+    static void invalidate();
+
+    // The window's events in the order they came, for the game thread
+    static bool pollEvent(SDL_Event& event);
+    // Queues an event for the game thread as if the window had sent it
+    static void pushEvent(const SDL_Event& event);
+
+    // The frame being recorded; only touch it from the game thread
+    static RenderFrame& recordingFrame();
+    // Hands the recorded frame over, waiting only while the previous one is still unclaimed
+    static void submit();
+
+    // Runs work on the render thread and waits for it, for the rare texture
+    // that has to exist before a frame can refer to it, or anything else
+    // that has to happen on the thread that owns the window
+    static void invoke(const std::function<void(SDL_Renderer*)>& work);
+
+    // Draw calls made by the last frame drawn
+    static int getDrawCalls();
+    static RenderStats getStats();
+    // Render thread only, wherever a texture is made from pixels
+    static void countTextureUpload();
+};
+
+#endif
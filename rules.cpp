@@ -0,0 +1,150 @@
+#include "rules.h"
+
+namespace {
+
+const int FACES = 6;
+const int MAX_DICE = 6;
+
+// Every label a hold button can show, with the dice it takes and what it scores
+struct HandLabel {
+    std::string label;
+    int dice;
+    int points;
+    int face;           // 0 when the hand takes all six dice whatever they show
+};
+
+// Same scores as Game::manyOfAKindPoints and the hold buttons
+std::vector<HandLabel> makeHandLabels() {
+    const char* counts[] = {"Three", "Four", "Five", "Six"};
+    const int basePoints[] = {0, 1000, 200, 300, 400, 500, 600};
+    std::vector<HandLabel> labels;
+    for (int n = 3; n <= MAX_DICE; ++n) {
+        for (int face = 1; face <= FACES; ++face) {
+            int points = n == MAX_DICE ? 2500 : basePoints[face] << (n - 3);
+            labels.push_back({std::string(counts[n - 3]) + " " + std::to_string(face) + "s", n, points, face});
+        }
+    }
+    labels.push_back({"Single 1", 1, 100, 1});
+    labels.push_back({"Double 1", 2, 200, 1});
+    labels.push_back({"Single 5", 1, 50, 5});
+    labels.push_back({"Double 5", 2, 100, 5});
+    labels.push_back({"Straight", 6, 1750, 0});
+    labels.push_back({"Three Pairs", 6, 1500, 0});
+    labels.push_back({"Nothing", 6, 500, 0});
+    return labels;
+}
+
+// Built on first use, so constants here and in other files may look labels up
+// while they are initialised themselves
+const std::vector<HandLabel>& handLabels() {
+    static const std::vector<HandLabel> labels = makeHandLabels();
+    return labels;
+}
+
+uint64_t labelBit(const std::string& label) {
+    return 1ULL << holdButtonId(label);
+}
+
+// Looked up once: profiles and the solver ask for the buttons of every set of dice
+const uint64_t STRAIGHT_BIT = labelBit("Straight");
+const uint64_t THREE_PAIRS_BIT = labelBit("Three Pairs");
+const uint64_t SINGLE_1_BIT = labelBit("Single 1");
+const uint64_t DOUBLE_1_BIT = labelBit("Double 1");
+const uint64_t SINGLE_5_BIT = labelBit("Single 5");
+const uint64_t DOUBLE_5_BIT = labelBit("Double 5");
+const uint64_t NOTHING_BIT = labelBit("Nothing");
+
+// handLabels() starts with the many of a kind hands, by count and then face
+uint64_t ofAKindBit(int count, int face) {
+    return 1ULL << ((count - 3) * FACES + face - 1);
+}
+
+}
+
+
+const std::vector<std::string>& holdButtonLabels() {
+    static const std::vector<std::string> labels = [] {
+        std::vector<std::string> names;
+        for (const HandLabel& hand : handLabels()) names.push_back(hand.label);
+        return names;
+    }();
+    return labels;
+}
+
+int holdButtonId(const std::string& label) {
+    const std::vector<HandLabel>& hands = handLabels();
+    for (size_t i = 0; i < hands.size(); ++i) {
+        if (hands[i].label == label) return i;
+    }
+    return -1;
+}
+
+bool holdButtonValue(const std::string& label, int& dice, int& points) {
+    return holdButtonValue(holdButtonId(label), dice, points);
+}
+
+bool holdButtonValue(int id, int& dice, int& points) {
+    const std::vector<HandLabel>& hands = handLabels();
+    if (id < 0 || id >= static_cast<int>(hands.size())) return false;
+    dice = hands[id].dice;
+    points = hands[id].points;
+    return true;
+}
+
+int holdButtonFace(int id) {
+    const std::vector<HandLabel>& hands = handLabels();
+    if (id < 0 || id >= static_cast<int>(hands.size())) return 0;
+    return hands[id].face;
+}
+
+// The same buttons Game::getPossibleHolds offers for these dice
+uint64_t offeredHolds(const int faceCounts[7]) {
+    uint64_t offered = 0;
+
+    int dice = 0, faces = 0, pairs = 0;
+    for (int face = 1; face <= FACES; ++face) {
+        dice += faceCounts[face];
+        if (faceCounts[face] > 0) faces++;
+        if (faceCounts[face] == 2) pairs++;
+        if (faceCounts[face] >= 3) offered |= ofAKindBit(faceCounts[face], face);
+    }
+    if (dice == MAX_DICE && faces == MAX_DICE) offered |= STRAIGHT_BIT;
+    if (faces == 3 && pairs == 3) offered |= THREE_PAIRS_BIT;
+    if (faceCounts[1] == 1) offered |= SINGLE_1_BIT;
+    if (faceCounts[1] == 2) offered |= DOUBLE_1_BIT;
+    if (faceCounts[5] == 1) offered |= SINGLE_5_BIT;
+    if (faceCounts[5] == 2) offered |= DOUBLE_5_BIT;
+    if (offered == 0 && dice == MAX_DICE) offered |= NOTHING_BIT;
+    return offered;
+}
+
+std::vector<HoldChoice> holdChoices(uint64_t offered) {
+    std::vector<HoldChoice> choices;
+    std::vector<int> parts;
+    const std::vector<HandLabel>& hands = handLabels();
+    for (size_t id = 0; id < hands.size(); ++id) {
+        if (!(offered & (1ULL << id))) continue;
+        if (hands[id].dice == MAX_DICE) choices.push_back({1ULL << id, MAX_DICE, hands[id].points});
+        else parts.push_back(id);
+    }
+    for (uint32_t subset = 1; subset < (1u << parts.size()); ++subset) {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < parts.size(); ++i) {
+            if (subset & (1u << i)) mask |= 1ULL << parts[i];
+        }
+        choices.push_back(holdMaskValue(mask));
+    }
+    return choices;
+}
+
+HoldChoice holdMaskValue(uint64_t mask) {
+    HoldChoice choice = {mask, 0, 0};
+    const std::vector<HandLabel>& hands = handLabels();
+    for (size_t id = 0; id < hands.size(); ++id) {
+        if (mask & (1ULL << id)) {
+            choice.dice += hands[id].dice;
+            choice.points += hands[id].points;
+        }
+    }
+    return choice;
+}
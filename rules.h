@@ -0,0 +1,38 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Least soft points that can be banked
+const int MIN_BANK_POINTS = 300;
+
+// The hold buttons Game::getPossibleHolds makes, for code that needs them without a game.
+// Every label has a fixed id: bit i of a hold mask stands for label i.
+const std::vector<std::string>& holdButtonLabels();
+int holdButtonId(const std::string& label);    // -1 if no button has the label
+// Dice the button takes and the points it scores; false if no button has the label
+bool holdButtonValue(const std::string& label, int& dice, int& points);
+bool holdButtonValue(int id, int& dice, int& points);
+// The face of the dice the button takes, 0 for Straight, Three Pairs and Nothing, which take all six
+int holdButtonFace(int id);
+
+// Mask of the buttons offered for the dice not yet held (faceCounts[1] to [6])
+uint64_t offeredHolds(const int faceCounts[7]);
+
+// One set of buttons that can be held together
+struct HoldChoice {
+    uint64_t mask;
+    int dice;
+    int points;
+};
+
+// Every choice the offered buttons allow: a hand that takes all six dice on
+// its own, or any mix of the others, which never share a die
+std::vector<HoldChoice> holdChoices(uint64_t offered);
+
+// Sum of the dice and points of the buttons in a mask
+HoldChoice holdMaskValue(uint64_t mask);
+
+#endif
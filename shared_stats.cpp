@@ -0,0 +1,157 @@
+#include "shared_stats.h"
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+namespace {
+
+const char MAGIC[4] = {'Z', 'S', 'H', 'M'};
+
+}
+
+// Counters are used through the mapping by several processes, so they must not need a lock
+static_assert(std::atomic<int64_t>::is_always_lock_free, "shared counters must be lock free");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared unlock bits must be lock free");
+
+// Mapped layout; plain fields are only written while the file lock is held
+struct SharedStats::Segment {
+    char magic[4];
+    uint32_t version;
+    uint32_t statisticCount;
+    uint32_t achievementCount;
+    std::atomic<uint64_t> changes;
+    char statisticNames[MAX_STATISTICS][NAME_LENGTH];
+    char achievementNames[MAX_ACHIEVEMENTS][NAME_LENGTH];
+    std::atomic<int64_t> counters[MAX_STATISTICS];
+    std::atomic<uint64_t> unlocked[MAX_ACHIEVEMENTS / 64];
+};
+
+
+SharedStats::~SharedStats() {
+    close();
+}
+
+bool SharedStats::open(const std::string& path, const std::function<void(SharedStats&, bool created)>& attach) {
+    close();
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd >= 0 && flock(fd, LOCK_EX) == 0) {
+        struct stat info;
+        bool created = fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) != sizeof(Segment);
+        if (created && ftruncate(fd, sizeof(Segment)) != 0) {
+            std::cerr << "Error: Could not size " << path << ".\n";
+        } else {
+            void* mapping = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (mapping != MAP_FAILED) {
+                segment = static_cast<Segment*>(mapping);
+                shared = true;
+            }
+        }
+
+        if (shared) {
+            if (!created && (std::memcmp(segment->magic, MAGIC, sizeof(MAGIC)) != 0 || segment->version != VERSION)) {
+                created = true;
+            }
+            if (created) {
+                // Magic goes in last, so a crash while seeding leaves a segment that gets rebuilt
+                std::memset(static_cast<void*>(segment), 0, sizeof(Segment));
+                attach(*this, true);
+                segment->version = VERSION;
+                std::memcpy(segment->magic, MAGIC, sizeof(MAGIC));
+                msync(segment, sizeof(Segment), MS_SYNC);
+            } else {
+                attach(*this, false);
+            }
+            flock(fd, LOCK_UN);
+            return true;
+        }
+        flock(fd, LOCK_UN);
+    }
+
+    std::cerr << "Error: Could not map " << path << ", statistics will not be shared.\n";
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    void* mapping = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) return false;
+    segment = static_cast<Segment*>(mapping);
+    attach(*this, true);
+    return true;
+}
+
+void SharedStats::close() {
+    if (segment) {
+        munmap(segment, sizeof(Segment));
+        segment = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    shared = false;
+}
+
+int SharedStats::registerStatistic(const std::string& name, int64_t initial) {
+    for (uint32_t i = 0; i < segment->statisticCount; ++i) {
+        if (name == segment->statisticNames[i]) return i;
+    }
+    if (segment->statisticCount >= MAX_STATISTICS || name.size() >= NAME_LENGTH) return -1;
+
+    int slot = segment->statisticCount;
+    std::strncpy(segment->statisticNames[slot], name.c_str(), NAME_LENGTH - 1);
+    segment->counters[slot].store(initial);
+    segment->statisticCount++;
+    return slot;
+}
+
+int SharedStats::registerAchievement(const std::string& name, bool unlocked) {
+    for (uint32_t i = 0; i < segment->achievementCount; ++i) {
+        if (name == segment->achievementNames[i]) return i;
+    }
+    if (segment->achievementCount >= MAX_ACHIEVEMENTS || name.size() >= NAME_LENGTH) return -1;
+
+    int slot = segment->achievementCount;
+    std::strncpy(segment->achievementNames[slot], name.c_str(), NAME_LENGTH - 1);
+    if (unlocked) segment->unlocked[slot / 64].fetch_or(uint64_t(1) << (slot % 64));
+    segment->achievementCount++;
+    return slot;
+}
+
+void SharedStats::add(int statistic, int64_t amount) {
+    if (!segment || statistic < 0) return;
+    segment->counters[statistic].fetch_add(amount, std::memory_order_relaxed);
+    segment->changes.fetch_add(1, std::memory_order_release);
+}
+
+int64_t SharedStats::get(int statistic) const {
+    if (!segment || statistic < 0) return 0;
+    return segment->counters[statistic].load(std::memory_order_relaxed);
+}
+
+bool SharedStats::unlock(int achievement) {
+    if (!segment || achievement < 0) return false;
+    uint64_t bit = uint64_t(1) << (achievement % 64);
+    uint64_t before = segment->unlocked[achievement / 64].fetch_or(bit, std::memory_order_relaxed);
+    if (before & bit) return false;
+    segment->changes.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+bool SharedStats::isUnlocked(int achievement) const {
+    if (!segment || achievement < 0) return false;
+    uint64_t bit = uint64_t(1) << (achievement % 64);
+    return segment->unlocked[achievement / 64].load(std::memory_order_relaxed) & bit;
+}
+
+uint64_t SharedStats::getChangeCount() const {
+    return segment ? segment->changes.load(std::memory_order_acquire) : 0;
+}
+
+void SharedStats::sync() {
+    if (shared) msync(segment, sizeof(Segment), MS_SYNC);
+}
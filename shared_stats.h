@@ -0,0 +1,53 @@
+#ifndef SHARED_STATS_H
+#define SHARED_STATS_H
+
+#include <string>
+#include <cstdint>
+#include <atomic>
+#include <functional>
+
+// Statistic counters and achievement unlock bits in a file mapped by every
+// game instance on the machine. Updates are single atomic operations on the
+// mapping, so instances never overwrite each other and all see live totals.
+// Names are only registered while attaching, under an exclusive file lock.
+class SharedStats {
+public:
+    static const uint32_t VERSION = 1;
+    static const int MAX_STATISTICS = 64;
+    static const int MAX_ACHIEVEMENTS = 256;
+    static const int NAME_LENGTH = 64;
+
+    ~SharedStats();
+
+    // Maps the segment, creating it if missing or from another version.
+    // attach runs while the segment is locked; created tells it to seed the counts.
+    // Falls back to memory private to this process if the file cannot be mapped.
+    bool open(const std::string& path, const std::function<void(SharedStats&, bool created)>& attach);
+    void close();
+    bool isShared() const { return shared; }
+
+    // Only valid inside attach. Return the slot for a name, adding it with the initial value if new.
+    int registerStatistic(const std::string& name, int64_t initial);
+    int registerAchievement(const std::string& name, bool unlocked);
+
+    void add(int statistic, int64_t amount);
+    int64_t get(int statistic) const;
+
+    // Returns true for the one caller that actually flipped the bit
+    bool unlock(int achievement);
+    bool isUnlocked(int achievement) const;
+
+    // Bumped by every add and unlock, so callers can tell when to persist
+    uint64_t getChangeCount() const;
+
+    // Flushes the mapping to disk
+    void sync();
+
+private:
+    struct Segment;
+    Segment* segment = nullptr;
+    int fd = -1;
+    bool shared = false;
+};
+
+#endif
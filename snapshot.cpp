@@ -0,0 +1,190 @@
+#include "snapshot.h"
+#include "game.h"
+#include "players.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char MAGIC[4] = {'Z', 'S', 'N', 'P'};
+
+}
+
+
+// FNV-1a, enough to catch torn or truncated writes
+uint32_t Snapshot::checksum(const uint8_t* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+std::vector<uint8_t> Snapshot::encode(Game& game) {
+    std::vector<uint8_t> data;
+    data.reserve(256);
+    ByteWriter w{data};
+
+    w.bytes(MAGIC, sizeof(MAGIC));
+    w.u16(VERSION);
+    w.u8(static_cast<uint8_t>(game.currentPlayerIndex));
+    w.i32(game.winningPoints);
+    w.u64(game.rng.state);
+    w.u8(game.lockOtherButtons);
+    w.u8(game.reverseLockOtherButtons);
+
+    // Dice
+    for (int i = 0; i < NUM_DICE; ++i) {
+        w.u8(static_cast<uint8_t>(game.die[i].value));
+        w.u8(game.die[i].held);
+    }
+    w.u8(static_cast<uint8_t>(game.previousHeldDice.size()));
+    for (int index : game.previousHeldDice) {
+        w.u8(static_cast<uint8_t>(index));
+    }
+
+    // Players
+    w.u8(static_cast<uint8_t>(game.players.size()));
+    for (const auto& player : game.players) {
+        w.str(player->getAIType());
+        w.str(player->getName());
+        w.i32(player->getHardPoints());
+        w.i32(player->getSoftPoints());
+        w.i32(player->getZilches());
+        w.u8(player->getFirstRoll());
+        w.u8(player->isTurn());
+
+        const auto& history = player->getHistory();
+        w.u32(static_cast<uint32_t>(history.size()));
+        for (const auto& entry : history) {
+            w.i32(entry.first);
+            w.u8(entry.second);
+        }
+    }
+
+    w.u32(checksum(data.data(), data.size()));
+    return data;
+}
+
+bool Snapshot::decode(Game& game, const std::vector<uint8_t>& data) {
+    if (data.size() < sizeof(MAGIC) + sizeof(uint16_t) + sizeof(uint32_t)) return false;
+    if (std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) return false;
+
+    // Verify the checksum before touching the game
+    size_t body = data.size() - sizeof(uint32_t);
+    ByteReader tail{data, body, true};
+    if (tail.u32() != checksum(data.data(), body)) return false;
+
+    ByteReader r{data, sizeof(MAGIC), true};
+    if (r.u16() != VERSION) return false;
+
+    int currentPlayer = r.u8();
+    int winningPoints = r.i32();
+    uint64_t rngState = r.u64();
+    bool lockOther = r.u8();
+    bool reverseLock = r.u8();
+
+    std::vector<Dice> die(NUM_DICE);
+    for (int i = 0; i < NUM_DICE; ++i) {
+        die[i].value = r.u8();
+        die[i].held = r.u8();
+        if (die[i].value < 1 || die[i].value > 6) return false;
+    }
+    std::vector<int> previousHeld(r.u8());
+    for (int& index : previousHeld) {
+        index = r.u8();
+        if (index >= NUM_DICE) return false;
+    }
+
+    // Players are rebuilt through addPlayer so the right AI class is created
+    int playerCount = r.u8();
+    if (!r.ok || playerCount < 2 || currentPlayer >= playerCount) return false;
+
+    game.clearGame();
+    for (int p = 0; p < playerCount && r.ok; ++p) {
+        std::string aiType = r.str();
+        std::string name = r.str();
+        game.addPlayer(name, !aiType.empty(), aiType);
+        if (game.players.size() != static_cast<size_t>(p + 1)) {
+            r.ok = false; // Unknown AI type
+            break;
+        }
+
+        std::unique_ptr<Player>& player = game.players.back();
+        player->addHardPoints(r.i32());
+        player->addSoftPoints(r.i32());
+        int zilches = r.i32();
+        for (int z = 0; z < zilches; ++z) player->addZilch();
+        if (!r.u8()) player->firstRolled();
+        player->setTurn(r.u8());
+
+        uint32_t historyCount = r.u32();
+        for (uint32_t h = 0; h < historyCount && r.ok; ++h) {
+            int points = r.i32();
+            bool isZilch = r.u8();
+            player->addToHistory(points, isZilch);
+        }
+    }
+
+    if (!r.ok || r.pos != body) {
+        game.clearGame();
+        return false;
+    }
+
+    game.currentPlayerIndex = currentPlayer;
+    game.winningPoints = winningPoints;
+    game.rng.state = rngState;
+    game.lockOtherButtons = lockOther;
+    game.reverseLockOtherButtons = reverseLock;
+    game.gameOver = false;
+    for (int i = 0; i < NUM_DICE; ++i) {
+        game.die[i].value = die[i].value;
+        game.die[i].held = die[i].held;
+    }
+    game.previousHeldDice = previousHeld;
+    return true;
+}
+
+
+// Written to a temporary file first so a crash never leaves half a snapshot
+bool Snapshot::save(Game& game, const std::string& path) {
+    std::vector<uint8_t> data = encode(game);
+
+    std::string tempPath = path + ".tmp";
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) return false;
+    bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    written = (std::fclose(file) == 0) && written;
+
+    if (!written || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Snapshot::load(Game& game, const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + read);
+    }
+    std::fclose(file);
+
+    if (!decode(game, data)) {
+        std::cerr << "Ignoring unreadable snapshot: " << path << std::endl;
+        return false;
+    }
+    // Listeners pick the game up where it was, as they would a new one
+    game.emitEvent(EVENT_GAME_RESUME);
+    return true;
+}
+
+void Snapshot::remove(const std::string& path) {
+    std::remove(path.c_str());
+}
@@ -0,0 +1,92 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+class Game;
+
+// Appends fixed size values to a byte buffer; savegame.bin and progress.snap both use it
+struct ByteWriter {
+    std::vector<uint8_t>& out;
+
+    void bytes(const void* data, size_t size) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), p, p + size);
+    }
+    void u8(uint8_t v) { out.push_back(v); }
+    // Byte by byte, so the file reads the same on any host
+    void u16(uint16_t v) { u8(v & 0xFF); u8(v >> 8); }
+    void u32(uint32_t v) {
+        for (int shift = 0; shift < 32; shift += 8) u8((v >> shift) & 0xFF);
+    }
+    void i32(int32_t v) { u32(static_cast<uint32_t>(v)); }
+    void u64(uint64_t v) { u32(static_cast<uint32_t>(v)); u32(static_cast<uint32_t>(v >> 32)); }
+    void str(const std::string& s) {
+        uint8_t len = s.size() > 255 ? 255 : static_cast<uint8_t>(s.size());
+        u8(len);
+        bytes(s.data(), len);
+    }
+};
+
+// Reads values back, failing (ok = false) instead of running past the end
+struct ByteReader {
+    const std::vector<uint8_t>& in;
+    size_t pos;
+    bool ok;
+
+    void bytes(void* data, size_t size) {
+        if (!ok || pos + size > in.size()) {
+            ok = false;
+            std::memset(data, 0, size);
+            return;
+        }
+        std::memcpy(data, in.data() + pos, size);
+        pos += size;
+    }
+    uint8_t u8() { uint8_t v; bytes(&v, sizeof(v)); return v; }
+    uint16_t u16() { uint16_t low = u8(); return low | uint16_t(u8()) << 8; }
+    uint32_t u32() {
+        uint32_t v = 0;
+        for (int shift = 0; shift < 32; shift += 8) v |= uint32_t(u8()) << shift;
+        return v;
+    }
+    int32_t i32() { return static_cast<int32_t>(u32()); }
+    uint64_t u64() { uint64_t low = u32(); return low | uint64_t(u32()) << 32; }
+    std::string str() {
+        uint8_t len = u8();
+        std::string s(len, '\0');
+        bytes(&s[0], len);
+        return s;
+    }
+};
+
+// File the running game is saved to on every turn boundary
+const std::string SNAPSHOT_FILE = "savegame.bin";
+
+// Compact versioned binary image of a game in progress.
+// Layout (little endian):
+//   "ZSNP" | u16 version | u8 currentPlayer | i32 winningPoints | u64 rng
+//   u8 lockOtherButtons | u8 reverseLockOtherButtons
+//   6 x (u8 value, u8 held) | u8 count + u8 previousHeldDice[count]
+//   u8 playerCount, per player:
+//     u8 typeLength + aiType | u8 nameLength + name | i32 hard | i32 soft | i32 zilches
+//     u8 firstRoll | u8 turn | u32 historyCount + (i32 points, u8 zilch)[count]
+//   u32 checksum of everything before it
+class Snapshot {
+public:
+    static const uint16_t VERSION = 1;
+
+    static bool save(Game& game, const std::string& path);
+    static bool load(Game& game, const std::string& path);
+    static void remove(const std::string& path);
+
+    // Used by save/load, exposed so other binary formats can share them
+    static std::vector<uint8_t> encode(Game& game);
+    static bool decode(Game& game, const std::vector<uint8_t>& data);
+    static uint32_t checksum(const uint8_t* data, size_t size);
+};
+
+#endif
@@ -0,0 +1,347 @@
+// Value model trainer for the learned AI: plays headless games between the rule
+// profiles in assets/ai_profiles.json, records every roll as the position the
+// roller was in and whether they went on to win, and fits ValueModel to those
+// outcomes. From the second round on the model also plays, against the rules
+// and itself, so it learns what its own choices lead to. The round whose model
+// wins most against the rules is kept, and written to assets/learned_ai.bin
+// unless told otherwise.
+// Usage: trainer [--games N] [--rounds N] [--epochs N] [--eval N]
+//                [--threads N] [--seed N] [--out file]
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include "game.h"
+#include "players.h"
+#include "animation.h"
+#include "ai_profile.h"
+#include "value_model.h"
+#include "decision_cache.h"
+#include "match_runner.h"
+
+// Flat layout of the network's weights while training, in double precision
+const int W_OFFSET = 0;
+const int B_OFFSET = VALUE_INPUTS * VALUE_HIDDEN;
+const int V_OFFSET = B_OFFSET + VALUE_HIDDEN;
+const int C_OFFSET = V_OFFSET + VALUE_HIDDEN;
+const int PARAM_COUNT = C_OFFSET + 1;
+
+const int BATCH_SIZE = 256;
+const double LEARNING_RATE = 0.002;
+
+struct TrainerOptions {
+    int games = 10000;           // Per round
+    int rounds = 4;
+    int epochs = 4;              // Passes over each round's positions
+    int evalGames = 2000;        // Against each rule profile after every round
+    int threads = 0;             // 0 for one per core
+    uint64_t seed = 0;
+    std::string out = LEARNED_AI_MODEL_FILE;
+};
+
+// One roll: the features of the roller's position, then whether they won (0.5 for a tie)
+struct Sample {
+    float x[VALUE_INPUTS];
+    float won;
+};
+
+struct Matchup {
+    const AIProfile* seats[2];
+    int points;
+    uint64_t seed;
+};
+
+// Winner's seat, -1 for a tie, -2 if the game never ended; fills samples if given
+int playGame(const Matchup& matchup, std::vector<Sample>* samples) {
+    Game game;
+    MatchRunner::setUp(game, matchup.seats, matchup.points, matchup.seed);
+
+    std::vector<int> rollers;
+    if (samples) {
+        game.addEventListener([&](const GameEvent& event) {
+            if (event.type != EVENT_ROLL) return;
+            Player& self = *game.getPlayers()[event.playerIndex];
+            Player& opponent = *game.getPlayers()[1 - event.playerIndex];
+            ValueState state = {self.getSoftPoints(), event.diceCount, self.getHardPoints(),
+                                opponent.getHardPoints(), self.getZilches(), matchup.points};
+            Sample sample;
+            ValueModel::features(state, sample.x);
+            samples->push_back(sample);
+            rollers.push_back(event.playerIndex);
+        });
+    }
+    if (!MatchRunner::play(game)) {
+        if (samples) samples->clear();
+        return -2;
+    }
+    int winner = MatchRunner::winner(game);
+    if (samples) {
+        for (size_t i = 0; i < samples->size(); ++i) {
+            (*samples)[i].won = winner < 0 ? 0.5f : (rollers[i] == winner ? 1.0f : 0.0f);
+        }
+    }
+    return winner;
+}
+
+// Plays every matchup across the threads; results and samples come back in matchup order
+std::vector<int> playAll(const std::vector<Matchup>& matchups, int threads, std::vector<Sample>* samples) {
+    std::vector<int> winners(matchups.size());
+    std::vector<std::vector<Sample>> perGame(samples ? matchups.size() : 0);
+    MatchRunner::runParallel(matchups.size(), threads, [&](size_t job, int) {
+        winners[job] = playGame(matchups[job], samples ? &perGame[job] : nullptr);
+    });
+
+    if (samples) {
+        for (const std::vector<Sample>& game : perGame) samples->insert(samples->end(), game.begin(), game.end());
+    }
+    return winners;
+}
+
+uint64_t makeSeed(DiceRng& rng) {
+    return (static_cast<uint64_t>(rng.next()) << 32) | rng.next();
+}
+
+double gaussian(DiceRng& rng) {
+    // Box-Muller; the +1 keeps the log away from zero
+    double u1 = (rng.next() + 1.0) / 4294967297.0;
+    double u2 = rng.next() / 4294967296.0;
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+}
+
+// Log loss over the batch; adds the gradient of its mean to grad
+double backpropagate(const std::vector<double>& p, const Sample* batch, size_t count, std::vector<double>& grad) {
+    double loss = 0;
+    for (size_t s = 0; s < count; ++s) {
+        const Sample& sample = batch[s];
+        double hidden[VALUE_HIDDEN];
+        double z = p[C_OFFSET];
+        for (int j = 0; j < VALUE_HIDDEN; ++j) {
+            double h = p[B_OFFSET + j];
+            for (int i = 0; i < VALUE_INPUTS; ++i) h += p[W_OFFSET + i * VALUE_HIDDEN + j] * sample.x[i];
+            hidden[j] = h;
+            if (h > 0) z += p[V_OFFSET + j] * h;
+        }
+        double prob = 1 / (1 + std::exp(-z));
+        double clamped = std::min(1 - 1e-7, std::max(1e-7, prob));
+        loss -= sample.won * std::log(clamped) + (1 - sample.won) * std::log(1 - clamped);
+
+        double dz = (prob - sample.won) / count;
+        grad[C_OFFSET] += dz;
+        for (int j = 0; j < VALUE_HIDDEN; ++j) {
+            if (hidden[j] <= 0) continue;
+            grad[V_OFFSET + j] += dz * hidden[j];
+            double dh = dz * p[V_OFFSET + j];
+            grad[B_OFFSET + j] += dh;
+            for (int i = 0; i < VALUE_INPUTS; ++i) grad[W_OFFSET + i * VALUE_HIDDEN + j] += dh * sample.x[i];
+        }
+    }
+    return loss;
+}
+
+double meanLoss(const std::vector<double>& p, const std::vector<Sample>& samples, size_t begin, size_t end) {
+    std::vector<double> unused(PARAM_COUNT, 0.0);
+    return end > begin ? backpropagate(p, samples.data() + begin, end - begin, unused) / (end - begin) : 0;
+}
+
+// Adam, with its moment estimates kept across rounds
+struct Optimizer {
+    std::vector<double> m = std::vector<double>(PARAM_COUNT, 0.0);
+    std::vector<double> v = std::vector<double>(PARAM_COUNT, 0.0);
+    long long steps = 0;
+
+    void step(std::vector<double>& p, const std::vector<double>& grad) {
+        const double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+        ++steps;
+        double correction1 = 1 - std::pow(beta1, steps);
+        double correction2 = 1 - std::pow(beta2, steps);
+        for (int k = 0; k < PARAM_COUNT; ++k) {
+            m[k] = beta1 * m[k] + (1 - beta1) * grad[k];
+            v[k] = beta2 * v[k] + (1 - beta2) * grad[k] * grad[k];
+            p[k] -= LEARNING_RATE * (m[k] / correction1) / (std::sqrt(v[k] / correction2) + epsilon);
+        }
+    }
+};
+
+ValueWeights toWeights(const std::vector<double>& p) {
+    ValueWeights weights;
+    for (int i = 0; i < VALUE_INPUTS; ++i) {
+        for (int j = 0; j < VALUE_HIDDEN; ++j) weights.input[i][j] = p[W_OFFSET + i * VALUE_HIDDEN + j];
+    }
+    for (int j = 0; j < VALUE_HIDDEN; ++j) {
+        weights.hiddenBias[j] = p[B_OFFSET + j];
+        weights.output[j] = p[V_OFFSET + j];
+    }
+    weights.outputBias = p[C_OFFSET];
+    return weights;
+}
+
+// Nanoseconds per evaluation over a spread of positions, as the AI asks them
+double benchmark(const ValueModel& model) {
+    std::vector<ValueState> states;
+    for (int turn = 0; turn <= 3000; turn += 150) {
+        for (int dice = 1; dice <= 6; ++dice) states.push_back({turn, dice, 4000, 5500, 1, 10000});
+    }
+    const int rounds = 20000;
+    volatile float sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        float sum = 0;
+        for (const ValueState& state : states) sum += model.evaluate(state);
+        sink = sink + sum;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / (static_cast<double>(rounds) * states.size());
+}
+
+bool parseOptions(int argc, char* argv[], TrainerOptions& options) {
+    if ((argc - 1) % 2 != 0) return false;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--games") options.games = std::atoi(value);
+        else if (flag == "--rounds") options.rounds = std::atoi(value);
+        else if (flag == "--epochs") options.epochs = std::atoi(value);
+        else if (flag == "--eval") options.evalGames = std::atoi(value);
+        else if (flag == "--threads") options.threads = std::atoi(value);
+        else if (flag == "--seed") options.seed = std::strtoull(value, nullptr, 10);
+        else if (flag == "--out") options.out = value;
+        else return false;
+    }
+    if (options.games <= 0 || options.rounds <= 0 || options.epochs <= 0 || options.evalGames < 0) return false;
+    if (options.threads <= 0) options.threads = std::max(1u, std::thread::hardware_concurrency());
+    if (options.seed == 0) options.seed = static_cast<uint64_t>(std::time(nullptr));
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    AIProfiles::load(AI_PROFILES_FILE);
+    TrainerOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: trainer [--games N] [--rounds N] [--epochs N] [--eval N] "
+                     "[--threads N] [--seed N] [--out file]" << std::endl;
+        return 1;
+    }
+    // No pauses between the AI's moves and no dice tumble: each update plays the next move
+    Animation::setEnabled(false);
+
+    std::vector<const AIProfile*> teachers;
+    for (const AIProfile& profile : AIProfiles::all()) {
+        if (!profile.valueModel) teachers.push_back(&profile);
+    }
+    if (teachers.empty()) {
+        std::cerr << "No rule profiles to learn from in " << AI_PROFILES_FILE << std::endl;
+        return 1;
+    }
+
+    DiceRng rng(options.seed);
+    std::vector<double> p(PARAM_COUNT, 0.0);
+    for (int k = W_OFFSET; k < B_OFFSET; ++k) p[k] = gaussian(rng) * std::sqrt(2.0 / VALUE_INPUTS);
+    for (int k = V_OFFSET; k < C_OFFSET; ++k) p[k] = gaussian(rng) * std::sqrt(1.0 / VALUE_HIDDEN);
+    Optimizer optimizer;
+
+    AIProfile learner;
+    learner.type = "learned";
+    learner.name = "Learned";
+
+    // The same dice for every round's check, at the menu's default target
+    std::vector<Matchup> checks;
+    for (int g = 0; g < options.evalGames; ++g) {
+        uint64_t seed = makeSeed(rng);
+        for (const AIProfile* teacher : teachers) {
+            Matchup matchup = {{&learner, teacher}, 10000, seed};
+            if (g % 2) std::swap(matchup.seats[0], matchup.seats[1]);
+            checks.push_back(matchup);
+        }
+    }
+
+    std::cout << "Training on " << options.games << " games a round for " << options.rounds
+              << " rounds on " << options.threads << " threads" << std::endl;
+    std::shared_ptr<const ValueModel> best;
+    double bestScore = -1;
+    int bestRound = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&]() { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+
+    for (int round = 1; round <= options.rounds; ++round) {
+        // Any target the menu allows; once there is a model, each seat plays it half the time
+        std::vector<Matchup> matchups(options.games);
+        for (Matchup& matchup : matchups) {
+            for (const AIProfile*& seat : matchup.seats) {
+                bool learned = round > 1 && rng.percent() <= 50;
+                seat = learned ? &learner : teachers[rng.next() % teachers.size()];
+            }
+            matchup.points = 1000 + 500 * static_cast<int>(rng.next() % 39);
+            matchup.seed = makeSeed(rng);
+        }
+        std::vector<Sample> samples;
+        playAll(matchups, options.threads, &samples);
+
+        // Positions from the same game are alike, so shuffle before holding some out
+        for (size_t i = samples.size(); i > 1; --i) std::swap(samples[i - 1], samples[rng.next() % i]);
+        size_t heldOut = samples.size() / 20;
+        size_t trainEnd = samples.size() - heldOut;
+
+        std::vector<double> grad(PARAM_COUNT);
+        double loss = 0;
+        for (int epoch = 0; epoch < options.epochs; ++epoch) {
+            loss = 0;
+            for (size_t begin = 0; begin < trainEnd; begin += BATCH_SIZE) {
+                size_t count = std::min<size_t>(BATCH_SIZE, trainEnd - begin);
+                std::fill(grad.begin(), grad.end(), 0.0);
+                loss += backpropagate(p, samples.data() + begin, count, grad);
+                optimizer.step(p, grad);
+            }
+            loss /= std::max<size_t>(trainEnd, 1);
+        }
+
+        auto model = std::make_shared<ValueModel>();
+        model->setWeights(toWeights(p));
+        learner.valueModel = model;
+
+        std::cout << "Round " << round << ": " << samples.size() << " positions, loss " << std::fixed
+                  << std::setprecision(4) << loss << " (held out " << meanLoss(p, samples, trainEnd, samples.size())
+                  << ") (" << std::setprecision(0) << elapsed() << "s)" << std::endl;
+
+        if (checks.empty()) {
+            best = model;
+            bestRound = round;
+            continue;
+        }
+        std::vector<int> winners = playAll(checks, options.threads, nullptr);
+        double score = 0;
+        for (size_t t = 0; t < teachers.size(); ++t) {
+            int won = 0, games = 0;
+            for (size_t c = t; c < checks.size(); c += teachers.size()) {
+                int learnerSeat = checks[c].seats[0] == &learner ? 0 : 1;
+                won += winners[c] == learnerSeat;
+                games++;
+            }
+            std::cout << "  vs " << std::setw(12) << teachers[t]->type << ": won " << std::setprecision(3)
+                      << static_cast<double>(won) / games << " of " << games << std::endl;
+            score += static_cast<double>(won) / games;
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            best = model;
+            bestRound = round;
+        }
+    }
+
+    std::cout << "Keeping round " << bestRound << "; evaluation takes " << std::setprecision(1)
+              << benchmark(*best) << " ns" << std::endl;
+    DecisionCacheStats cache = DecisionCache::getStats();
+    std::cout << "Learned AI decisions: " << std::setprecision(1) << cache.hitRate() * 100 << "% of "
+              << cache.hits + cache.misses << " found in the decision cache" << std::endl;
+    if (!best->save(options.out)) {
+        std::cerr << "Could not write " << options.out << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << options.out << std::endl;
+    return 0;
+}
@@ -0,0 +1,259 @@
+// AI parameter tuner: searches one AI profile's tunable numbers for the set
+// that wins most often against every profile in assets/ai_profiles.json, by
+// playing thousands of headless games per candidate across every core.
+// Writes the result as a new profile, "<type>-tuned", in the same format.
+// Usage: tuner <profile type> [--seconds N] [--games N]
+//              [--threads N] [--points N] [--seed N] [--out file]
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <numeric>
+#include "game.h"
+#include "players.h"
+#include "animation.h"
+#include "ai_profile.h"
+#include "match_runner.h"
+
+struct TunerOptions {
+    std::string type;
+    double seconds = 60;
+    int games = 1000;            // Per candidate per generation
+    int threads = 0;             // 0 for one per core
+    int points = 10000;
+    uint64_t seed = 0;
+    std::string out;
+};
+
+// Values in [0,1] are mapped onto each parameter's range, so every axis searches alike
+std::vector<float> toParams(const std::vector<AIParam>& table, const std::vector<double>& x) {
+    std::vector<float> values(table.size());
+    for (size_t i = 0; i < table.size(); ++i) {
+        values[i] = static_cast<float>(table[i].min + x[i] * (table[i].max - table[i].min));
+    }
+    return values;
+}
+
+std::vector<double> fromParams(const std::vector<AIParam>& table, const std::vector<float>& values) {
+    std::vector<double> x(table.size());
+    for (size_t i = 0; i < table.size(); ++i) {
+        double range = table[i].max - table[i].min;
+        x[i] = range > 0 ? (values[i] - table[i].min) / range : 0.5;
+    }
+    return x;
+}
+
+std::vector<float> defaultParams(const std::vector<AIParam>& table) {
+    std::vector<float> values;
+    for (const AIParam& p : table) values.push_back(p.value);
+    return values;
+}
+
+// Game number decides the opponent and which seat the tuned AI takes, so every
+// candidate of a generation meets the same opponents on the same dice
+bool playGame(const TunerOptions& options, const std::vector<float>& params, int gameNumber, uint64_t seed) {
+    const std::vector<AIProfile>& opponents = AIProfiles::all();
+    int seat = (gameNumber / opponents.size()) % 2;
+    const AIProfile* seats[2];
+    seats[seat] = AIProfiles::find(options.type);
+    seats[1 - seat] = &opponents[gameNumber % opponents.size()];
+
+    Game game;
+    MatchRunner::setUp(game, seats, options.points, seed);
+    dynamic_cast<AIPlayer&>(*game.getPlayers()[seat]).setParams(params);
+    return MatchRunner::play(game) && MatchRunner::winner(game) == seat;
+}
+
+// Win rate of each candidate over the same seeds, with the games shared out among the threads
+std::vector<double> evaluate(const TunerOptions& options, const std::vector<std::vector<float>>& candidates,
+                             const std::vector<uint64_t>& seeds) {
+    size_t games = seeds.size();
+    size_t jobs = candidates.size() * games;
+    std::vector<char> won(jobs, 0);
+    MatchRunner::runParallel(jobs, options.threads, [&](size_t job, int) {
+        size_t game = job % games;
+        won[job] = playGame(options, candidates[job / games], static_cast<int>(game), seeds[game]);
+    });
+
+    std::vector<double> rates(candidates.size());
+    for (size_t c = 0; c < candidates.size(); ++c) {
+        rates[c] = std::accumulate(won.begin() + c * games, won.begin() + (c + 1) * games, 0.0) / games;
+    }
+    return rates;
+}
+
+std::vector<uint64_t> makeSeeds(DiceRng& rng, int count) {
+    std::vector<uint64_t> seeds(count);
+    for (uint64_t& seed : seeds) seed = (static_cast<uint64_t>(rng.next()) << 32) | rng.next();
+    return seeds;
+}
+
+double gaussian(DiceRng& rng) {
+    // Box-Muller; the +1 keeps the log away from zero
+    double u1 = (rng.next() + 1.0) / 4294967297.0;
+    double u2 = rng.next() / 4294967296.0;
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+}
+
+// Half-width of the 95% interval on a win rate measured over n games
+double margin(double rate, int games) {
+    return 1.96 * std::sqrt(rate * (1 - rate) / games);
+}
+
+// The tuned profile under a type of its own, ready to add to assets/ai_profiles.json
+bool writeResult(const std::string& path, const AIProfile& base, const std::vector<float>& params,
+                 double winRate, int games) {
+    ProfileAI tuned("Tuned", base);
+    tuned.setParams(params);
+    AIProfile profile = tuned.getProfile();
+    profile.type += "-tuned";
+    profile.name += " (Tuned)";
+
+    std::ofstream out(path);
+    if (!out) return false;
+    out << AIProfiles::toJson(profile, winRate, games);
+    return static_cast<bool>(out);
+}
+
+bool parseOptions(int argc, char* argv[], TunerOptions& options) {
+    if (argc < 2) return false;
+    options.type = argv[1];
+    if (!AIProfiles::find(options.type)) return false;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--seconds") options.seconds = std::atof(value);
+        else if (flag == "--games") options.games = std::atoi(value);
+        else if (flag == "--threads") options.threads = std::atoi(value);
+        else if (flag == "--points") options.points = std::atoi(value);
+        else if (flag == "--seed") options.seed = std::strtoull(value, nullptr, 10);
+        else if (flag == "--out") options.out = value;
+        else return false;
+    }
+    if ((argc - 2) % 2 != 0 || options.seconds <= 0 || options.games <= 0 || options.points <= 0) return false;
+    if (options.threads <= 0) options.threads = std::max(1u, std::thread::hardware_concurrency());
+    if (options.seed == 0) options.seed = static_cast<uint64_t>(std::time(nullptr));
+    if (options.out.empty()) options.out = "ai_profile_" + options.type + ".json";
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    AIProfiles::load(AI_PROFILES_FILE);
+    TunerOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: tuner <profile type> [--seconds N] [--games N] "
+                     "[--threads N] [--points N] [--seed N] [--out file]" << std::endl;
+        return 1;
+    }
+    // No pauses between the AI's moves and no dice tumble: each update plays the next move
+    Animation::setEnabled(false);
+
+    const AIProfile& profile = *AIProfiles::find(options.type);
+    const std::vector<AIParam> table = profile.getTunables();
+    const int n = static_cast<int>(table.size());
+    if (n == 0) {
+        std::cerr << options.type << " has nothing to tune" << std::endl;
+        return 1;
+    }
+
+    // Separable CMA-ES: a diagonal covariance is all the budget can learn for this many
+    // parameters, and the step size follows the evolution path (CSA)
+    const int lambda = std::max(12, 4 + static_cast<int>(3 * std::log(n)));
+    const int mu = lambda / 2;
+    std::vector<double> weights(mu);
+    for (int i = 0; i < mu; ++i) weights[i] = std::log(mu + 0.5) - std::log(i + 1.0);
+    double weightSum = std::accumulate(weights.begin(), weights.end(), 0.0);
+    double weightSquares = 0;
+    for (double& w : weights) { w /= weightSum; weightSquares += w * w; }
+    const double muEff = 1 / weightSquares;
+    const double cSigma = (muEff + 2) / (n + muEff + 5);
+    const double dSigma = 1 + 2 * std::max(0.0, std::sqrt((muEff - 1) / (n + 1)) - 1) + cSigma;
+    const double chiN = std::sqrt(n) * (1 - 1.0 / (4 * n) + 1.0 / (21.0 * n * n));
+    const double cMu = 0.1;   // Learning rate of the variances; fitness is noisy, so slow
+
+    DiceRng rng(options.seed);
+    std::vector<double> mean = fromParams(table, defaultParams(table));
+    std::vector<double> deviation(n, 1.0);   // Per-axis scale, the root of the diagonal covariance
+    std::vector<double> path(n, 0.0);
+    double sigma = 0.15;
+
+    std::vector<float> bestParams = defaultParams(table);
+    double bestRate = -1;
+
+    std::cout << "Tuning " << options.type << ": " << n << " parameters, " << lambda << " candidates x "
+              << options.games << " games per generation on " << options.threads << " threads" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&]() { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+    int generation = 0;
+    while (elapsed() < options.seconds) {
+        std::vector<std::vector<double>> z(lambda, std::vector<double>(n));
+        std::vector<std::vector<double>> x(lambda, std::vector<double>(n));
+        std::vector<std::vector<float>> candidates(lambda);
+        for (int k = 0; k < lambda; ++k) {
+            for (int i = 0; i < n; ++i) {
+                x[k][i] = std::min(1.0, std::max(0.0, mean[i] + sigma * deviation[i] * gaussian(rng)));
+                // The step actually taken, after clipping to the range
+                z[k][i] = (x[k][i] - mean[i]) / (sigma * deviation[i]);
+            }
+            candidates[k] = toParams(table, x[k]);
+        }
+
+        std::vector<double> rates = evaluate(options, candidates, makeSeeds(rng, options.games));
+        std::vector<int> order(lambda);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return rates[a] > rates[b]; });
+        if (rates[order[0]] > bestRate) {
+            bestRate = rates[order[0]];
+            bestParams = candidates[order[0]];
+        }
+
+        std::vector<double> zMean(n, 0.0);
+        for (int j = 0; j < mu; ++j) {
+            for (int i = 0; i < n; ++i) zMean[i] += weights[j] * z[order[j]][i];
+        }
+        double pathLength = 0;
+        for (int i = 0; i < n; ++i) {
+            mean[i] = std::min(1.0, std::max(0.0, mean[i] + sigma * deviation[i] * zMean[i]));
+            path[i] = (1 - cSigma) * path[i] + std::sqrt(cSigma * (2 - cSigma) * muEff) * zMean[i];
+            pathLength += path[i] * path[i];
+        }
+        for (int i = 0; i < n; ++i) {
+            double variance = 0;
+            for (int j = 0; j < mu; ++j) variance += weights[j] * z[order[j]][i] * z[order[j]][i];
+            deviation[i] *= std::sqrt((1 - cMu) + cMu * variance);
+        }
+        sigma *= std::exp((cSigma / dSigma) * (std::sqrt(pathLength) / chiN - 1));
+        sigma = std::min(0.5, std::max(0.001, sigma));
+
+        ++generation;
+        std::cout << "Generation " << generation << ": best " << std::fixed << std::setprecision(3)
+                  << rates[order[0]] << ", median " << rates[order[lambda / 2]] << ", step " << sigma
+                  << " (" << std::setprecision(0) << elapsed() << "s)" << std::endl;
+    }
+
+    // The best single score is flattered by luck, so the finalists are measured again on new dice
+    int validationGames = options.games * 5;
+    std::vector<std::vector<float>> finalists = {defaultParams(table), toParams(table, mean), bestParams};
+    const char* finalistNames[] = {"defaults", "search mean", "best candidate"};
+    std::vector<double> rates = evaluate(options, finalists, makeSeeds(rng, validationGames));
+    int winner = 0;
+    for (int i = 0; i < 3; ++i) {
+        std::cout << std::setw(15) << finalistNames[i] << ": " << std::fixed << std::setprecision(4) << rates[i]
+                  << " +/- " << margin(rates[i], validationGames) << " over " << validationGames << " games" << std::endl;
+        if (rates[i] > rates[winner]) winner = i;
+    }
+
+    if (!writeResult(options.out, profile, finalists[winner], rates[winner], validationGames)) {
+        std::cerr << "Could not write " << options.out << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote the " << finalistNames[winner] << " to " << options.out << std::endl;
+    return 0;
+}
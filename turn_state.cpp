@@ -0,0 +1,232 @@
+#include "turn_state.h"
+#include "game.h"
+#include "rules.h"
+#include <type_traits>
+
+namespace {
+
+static_assert(std::is_trivially_copyable<TurnState>::value, "TurnState is copied by value during searches");
+
+const uint8_t ALL_DICE = (1 << TurnState::DICE) - 1;
+const int ZILCH_PENALTY = 500;
+const int ZILCHES_FOR_PENALTY = 3;
+
+const int STRAIGHT = holdButtonId("Straight");
+const int THREE_PAIRS = holdButtonId("Three Pairs");
+
+// Straight and Three Pairs check and set one lock, singles and doubles the other
+bool locksOthers(int button) {
+    return button == STRAIGHT || button == THREE_PAIRS;
+}
+
+bool isSingleOrDouble(int button) {
+    int dice = 0, points = 0;
+    holdButtonValue(button, dice, points);
+    return dice <= 2;
+}
+
+// Dice showing face that this roll rolled
+uint8_t rolledWith(const TurnState& state, int face) {
+    uint8_t dice = 0;
+    for (int i = 0; i < TurnState::DICE; ++i) {
+        if (state.faces[i] == face && !(state.heldBefore & (1 << i))) dice |= 1 << i;
+    }
+    return dice;
+}
+
+// The first count of them, by die
+uint8_t firstDice(uint8_t dice, int count) {
+    uint8_t taken = 0;
+    for (int i = 0; i < TurnState::DICE && count > 0; ++i) {
+        if (dice & (1 << i)) {
+            taken |= 1 << i;
+            count--;
+        }
+    }
+    return taken;
+}
+
+// What the button's onClick does in Game::getPossibleHolds
+void pressButton(TurnState& state, int button) {
+    uint32_t bit = 1u << button;
+    bool blocked = (locksOthers(button) && state.reverseLock) || (isSingleOrDouble(button) && state.lockOthers);
+    if (!(state.offered & bit) || blocked) {
+        state.pressed &= ~bit;  // A locked button is deselected again and does nothing
+        return;
+    }
+    state.pressed ^= bit;
+
+    int dice = 0, points = 0;
+    holdButtonValue(button, dice, points);
+    int face = holdButtonFace(button);
+    bool holding;
+    uint8_t toggled;
+    if (face == 0) {                // Straight, Three Pairs, Nothing
+        holding = state.held == 0;
+        toggled = ALL_DICE;
+    } else if (dice == TurnState::DICE) {
+        holding = state.held == 0;
+        toggled = 0;
+        for (int i = 0; i < TurnState::DICE; ++i) {
+            if (state.faces[i] == face) toggled |= 1 << i;
+        }
+    } else {
+        uint8_t rolled = rolledWith(state, face);
+        holding = (state.held & rolled) == 0;
+        toggled = firstDice(rolled, dice);
+    }
+    state.held ^= toggled;
+    state.softPoints += holding ? points : -points;
+
+    if (locksOthers(button)) state.lockOthers = holding;
+    else if (isSingleOrDouble(button)) state.reverseLock = holding;
+}
+
+// Game::rollDice, then the buttons Game::getPossibleHolds makes
+void roll(TurnState& state) {
+    state.lockOthers = false;
+    state.reverseLock = false;
+    state.heldBefore = state.held;
+    if (state.held == ALL_DICE) {
+        state.held = 0;
+        state.heldBefore = 0;
+    }
+
+    DiceRng rng(state.rngState);
+    int faceCounts[7] = {};
+    for (int i = 0; i < TurnState::DICE; ++i) {
+        if (state.held & (1 << i)) continue;
+        state.faces[i] = rng.rollFace();
+        faceCounts[state.faces[i]]++;
+    }
+    state.rngState = rng.state;
+
+    state.offered = static_cast<uint32_t>(offeredHolds(faceCounts));
+    state.pressed = 0;
+    state.phase = TurnState::IN_PLAY;
+}
+
+}
+
+
+TurnState TurnState::fromGame(Game& game, uint64_t rngState) {
+    TurnState state;
+    std::vector<Dice>& dice = game.getDice();
+    for (int i = 0; i < DICE; ++i) {
+        state.faces[i] = dice[i].value;
+        if (dice[i].held) state.held |= 1 << i;
+    }
+    for (int index : game.getPreviousHeldDice()) state.heldBefore |= 1 << index;
+    for (Button& btn : game.getHoldButtons()) {
+        int button = holdButtonId(btn.getLabel());
+        if (button < 0) continue;       // ZILCH
+        state.offered |= 1u << button;
+        if (btn.getSelected()) state.pressed |= 1u << button;
+    }
+
+    Player& player = *game.getPlayers()[game.getCurrentPlayer()];
+    state.softPoints = player.getSoftPoints();
+    state.zilches = player.getZilches();
+    state.lockOthers = game.getButtonLock();
+    state.reverseLock = game.getReverseButtonLock();
+    state.phase = game.getHoldButtons().empty() ? FIRST_ROLL : IN_PLAY;
+    state.rngState = rngState;
+    return state;
+}
+
+int TurnState::diceToRoll() const {
+    int dice = 0;
+    for (int i = 0; i < DICE; ++i) {
+        if (!(held & (1 << i))) dice++;
+    }
+    return dice == 0 ? DICE : dice;
+}
+
+// The roll and bank buttons need a hold selected, as they do for people
+int TurnState::legalActions(TurnAction out[MAX_ACTIONS]) const {
+    int count = 0;
+    if (phase == FIRST_ROLL) {
+        out[count++] = {TurnAction::ROLL};
+        return count;
+    }
+    if (phase != IN_PLAY) return 0;
+    if (offered == 0) {
+        out[count++] = {TurnAction::ZILCH};
+        return count;
+    }
+
+    int buttons = static_cast<int>(holdButtonLabels().size());
+    for (int button = 0; button < buttons; ++button) {
+        uint32_t bit = 1u << button;
+        if (!(offered & bit) || (pressed & bit)) continue;
+        if ((locksOthers(button) && reverseLock) || (isSingleOrDouble(button) && lockOthers)) continue;
+        out[count++] = TurnAction::press(button);
+    }
+    if (pressed != 0) {
+        out[count++] = {TurnAction::ROLL};
+        if (softPoints >= MIN_BANK_POINTS) out[count++] = {TurnAction::BANK};
+    }
+    return count;
+}
+
+TurnState TurnState::apply(const TurnAction& action) const {
+    TurnState next = *this;
+    if (isOver()) return next;
+
+    switch (action.type) {
+        case TurnAction::PRESS:
+            if (phase == IN_PLAY && action.button < holdButtonLabels().size()) pressButton(next, action.button);
+            break;
+        case TurnAction::ROLL:
+            roll(next);
+            break;
+        case TurnAction::BANK:
+            // Game::bankCurrentPlayerScore
+            if (phase != IN_PLAY || softPoints < MIN_BANK_POINTS) break;
+            next.scored = softPoints;
+            next.softPoints = 0;
+            next.zilches = 0;
+            next.phase = BANKED;
+            break;
+        case TurnAction::ZILCH:
+            // Game::zilchCurrentPlayer
+            if (phase != IN_PLAY) break;
+            next.zilches++;
+            if (next.zilches == ZILCHES_FOR_PENALTY) {
+                next.zilches = 0;
+                next.scored = -ZILCH_PENALTY;
+            }
+            next.softPoints = 0;
+            next.phase = ZILCHED;
+            break;
+    }
+    return next;
+}
+
+void playAction(Game& game, const TurnAction& action) {
+    Player& player = *game.getPlayers()[game.getCurrentPlayer()];
+    std::string label = action.type == TurnAction::ZILCH ? "ZILCH" : "";
+    if (action.type == TurnAction::PRESS && action.button < holdButtonLabels().size()) {
+        label = holdButtonLabels()[action.button];
+    }
+    switch (action.type) {
+        case TurnAction::PRESS:
+        case TurnAction::ZILCH:
+            for (Button& btn : game.getHoldButtons()) {
+                if (btn.getLabel() == label) {
+                    btn.toggleSelected();
+                    btn.onClick();
+                    break;
+                }
+            }
+            break;
+        case TurnAction::ROLL:
+            if (player.getFirstRoll()) player.firstRolled();
+            game.rollDice();
+            game.getPossibleHolds();
+            break;
+        case TurnAction::BANK:
+            game.bankCurrentPlayerScore();
+            break;
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef TURN_STATE_H
+#define TURN_STATE_H
+
+#include <cstdint>
+
+class Game;
+
+// One move of a turn: pressing a hold button (id from holdButtonId), rolling,
+// banking or taking the zilch
+struct TurnAction {
+    enum Type : uint8_t { PRESS, ROLL, BANK, ZILCH };
+
+    Type type = ROLL;
+    uint8_t button = 0;         // PRESS only
+
+    static TurnAction press(int button) { return {PRESS, static_cast<uint8_t>(button)}; }
+};
+
+// The turn in play as a plain value: no heap, no buttons, no players, so an AI
+// can copy it onto the stack and try moves on the copy instead of the game.
+// apply() follows the game's own rules, the hold buttons' quirks and locks
+// included, and rolls with the state's own DiceRng state: seeded from the
+// game's, a roll shows what the game's next roll would.
+struct TurnState {
+    static const int DICE = 6;              // NUM_DICE, without game.h
+    static const int MAX_ACTIONS = 32;      // Every hold button, roll and bank, with room to spare
+
+    enum Phase : uint8_t { FIRST_ROLL, IN_PLAY, BANKED, ZILCHED };
+
+    uint8_t faces[DICE] = {};   // What each die shows
+    uint8_t held = 0;           // Bit i: die i is held
+    uint8_t heldBefore = 0;     // Held before this roll (Game's previousHeldDice)
+    uint32_t offered = 0;       // Hold buttons this roll made, 0 when it zilched
+    uint32_t pressed = 0;       // Of those, selected now
+    int32_t softPoints = 0;
+    int32_t scored = 0;         // Hard points the turn added once over: the bank, or -500 for a third zilch
+    uint8_t zilches = 0;        // In a row, before this turn ends
+    bool lockOthers = false;    // Straight or Three Pairs held: singles and doubles do nothing
+    bool reverseLock = false;   // A single or double held: Straight and Three Pairs do nothing
+    Phase phase = FIRST_ROLL;
+    uint64_t rngState = 0;      // DiceRng::state for the next roll
+
+    // The current player's turn as it stands; rngState is the caller's, so an
+    // AI cannot peek at the dice unless it is handed the game's
+    static TurnState fromGame(Game& game, uint64_t rngState);
+
+    bool isOver() const { return phase == BANKED || phase == ZILCHED; }
+    int diceToRoll() const;     // Six once all are held
+
+    // Moves the game would act on, into out; returns how many. Pressing a
+    // button already selected lets go of it, which apply() allows but this
+    // leaves out, as a search never needs to undo on a copy.
+    int legalActions(TurnAction out[MAX_ACTIONS]) const;
+    // The state after the action; the one that went in is untouched
+    TurnState apply(const TurnAction& action) const;
+};
+
+// Makes the move on the game itself, as the game screen does for the same click
+void playAction(Game& game, const TurnAction& action);
+
+#endif
@@ -0,0 +1,408 @@
+#include "ui_script.h"
+#include "render_thread.h"
+#include "latency.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <cctype>
+#include <new>
+
+namespace {
+
+const char* SCENE_NAMES[SCENE_COUNT] = {"menu", "awards", "game", "game-over"};
+
+const std::string RESULTS_FILE = "ui_perf.txt";
+const std::string BASELINE_FILE = "ui_perf_baseline.txt";
+
+// How much worse than the baseline a scene may get before the run fails.
+// Times are noisy on a shared CI box, so they need both a ratio and a floor.
+const double TIME_RATIO = 1.5;
+const double TIME_SLACK_MS = 0.5;
+const double ALLOCATION_RATIO = 1.2;
+const double ALLOCATION_SLACK = 2;
+const double UPLOAD_SLACK = 0.1;
+
+// Samples are kept in place so recording them does not show up as allocations
+const size_t RESERVED_FRAMES = 1 << 16;
+
+std::atomic<uint64_t> allocations{0};
+
+enum StepKind { STEP_WAIT, STEP_CLICK, STEP_DRAG, STEP_UNTIL, STEP_LOOP, STEP_END, STEP_QUIT };
+
+struct ScriptStep {
+    StepKind kind;
+    int line;
+    std::string label;      // STEP_CLICK
+    int values[4] = {};     // Frames, or the drag's points
+    UiScene scene = SCENE_MENU;
+    size_t jump = 0;        // STEP_LOOP: the step after its end; STEP_END: its loop
+};
+
+struct SceneSamples {
+    std::vector<float> frameMilliseconds;
+    double drawMilliseconds = 0;
+    uint64_t allocations = 0;
+    long long textureUploads = 0;
+};
+
+// Per scene, as written to and read from the results file
+struct SceneResult {
+    int frames = 0;
+    double meanMilliseconds = 0;
+    double p95Milliseconds = 0;
+    double drawMilliseconds = 0;
+    double allocationsPerFrame = 0;
+    double uploadsPerFrame = 0;
+};
+
+bool active = false;
+bool finished = false;
+bool failed = false;
+uint64_t seed = 1;
+
+std::vector<ScriptStep> steps;
+std::vector<uint64_t> startedAt;    // Frame a STEP_UNTIL or STEP_LOOP began waiting, 0 if it is not
+size_t current = 0;
+int waitFrames = 0;
+uint64_t frameNumber = 0;
+
+SceneSamples samples[SCENE_COUNT];
+UiScene frameScene = SCENE_MENU;
+Uint64 frameStart = 0;
+uint64_t allocationsAtStart = 0;
+RenderStats statsAtStart;
+
+bool parseScene(const std::string& name, UiScene& scene) {
+    for (int i = 0; i < SCENE_COUNT; ++i) {
+        if (name == SCENE_NAMES[i]) {
+            scene = static_cast<UiScene>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void fail(const ScriptStep& step, const std::string& message) {
+    std::cerr << "UI script, line " << step.line << ": " << message << std::endl;
+    failed = true;
+}
+
+// Input goes straight to the game thread, so it is handled in the frame that posts it
+void quit() {
+    SDL_Event event = {};
+    event.type = SDL_QUIT;
+    RenderThread::pushEvent(event);
+    finished = true;
+}
+
+void pushButton(SDL_Window* window, Uint32 type, int x, int y) {
+    SDL_Event event = {};
+    event.type = type;
+    event.button.windowID = SDL_GetWindowID(window);
+    event.button.button = SDL_BUTTON_LEFT;
+    event.button.state = (type == SDL_MOUSEBUTTONDOWN) ? SDL_PRESSED : SDL_RELEASED;
+    event.button.clicks = 1;
+    event.button.x = x;
+    event.button.y = y;
+    RenderThread::pushEvent(event);
+}
+
+// Warping moves SDL's own idea of the mouse too, which the game reads with SDL_GetMouseState;
+// the window belongs to the render thread, so that is where it happens
+void warp(SDL_Window* window, int x, int y) {
+    RenderThread::invoke([window, x, y](SDL_Renderer*) { SDL_WarpMouseInWindow(window, x, y); });
+}
+
+void click(SDL_Window* window, int x, int y) {
+    warp(window, x, y);
+    pushButton(window, SDL_MOUSEBUTTONDOWN, x, y);
+    pushButton(window, SDL_MOUSEBUTTONUP, x, y);
+}
+
+void drag(SDL_Window* window, const int* points) {
+    warp(window, points[0], points[1]);
+    pushButton(window, SDL_MOUSEBUTTONDOWN, points[0], points[1]);
+    warp(window, points[2], points[3]);
+    pushButton(window, SDL_MOUSEBUTTONUP, points[2], points[3]);
+}
+
+// True once the wait started by this step has gone on too long
+bool timedOut(size_t index) {
+    if (startedAt[index] == 0) startedAt[index] = frameNumber;
+    return frameNumber - startedAt[index] > static_cast<uint64_t>(steps[index].values[0]);
+}
+
+SceneResult summarize(const SceneSamples& scene) {
+    SceneResult result;
+    result.frames = scene.frameMilliseconds.size();
+    if (result.frames == 0) return result;
+
+    std::vector<float> sorted = scene.frameMilliseconds;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0;
+    for (float milliseconds : sorted) total += milliseconds;
+    result.meanMilliseconds = total / result.frames;
+    result.p95Milliseconds = sorted[std::min<size_t>(sorted.size() - 1, sorted.size() * 95 / 100)];
+    result.drawMilliseconds = scene.drawMilliseconds / result.frames;
+    result.allocationsPerFrame = static_cast<double>(scene.allocations) / result.frames;
+    result.uploadsPerFrame = static_cast<double>(scene.textureUploads) / result.frames;
+    return result;
+}
+
+bool readResults(const std::string& path, SceneResult results[SCENE_COUNT]) {
+    std::ifstream in(path);
+    if (!in.is_open()) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string name;
+        SceneResult result;
+        UiScene scene;
+        if (fields >> name >> result.frames >> result.meanMilliseconds >> result.p95Milliseconds >> result.drawMilliseconds
+                   >> result.allocationsPerFrame >> result.uploadsPerFrame && parseScene(name, scene)) {
+            results[scene] = result;
+        }
+    }
+    return true;
+}
+
+bool slower(double now, double before) {
+    return now > before * TIME_RATIO && now - before > TIME_SLACK_MS;
+}
+
+}
+
+#ifdef UI_PERF_COUNT_ALLOCATIONS
+// Every allocation in the program is counted, so a screen that starts allocating each frame shows up.
+// Only built into main_perf (make perf-ui); the game itself keeps the standard allocator.
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+#endif
+
+
+bool UiScript::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cerr << "Could not open UI script: " << path << std::endl;
+        return false;
+    }
+
+    steps.clear();
+    std::vector<size_t> openLoops;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        std::istringstream fields(line);
+        std::string command;
+        if (!(fields >> command)) continue;
+
+        ScriptStep step;
+        step.line = lineNumber;
+        bool valid = true;
+        std::string sceneName;
+        if (command == "seed") {
+            valid = static_cast<bool>(fields >> seed);
+            if (valid) continue;
+        } else if (command == "wait") {
+            step.kind = STEP_WAIT;
+            valid = fields >> step.values[0] && step.values[0] > 0;
+        } else if (command == "click") {
+            step.kind = STEP_CLICK;
+            std::getline(fields >> std::ws, step.label);
+            while (!step.label.empty() && std::isspace(static_cast<unsigned char>(step.label.back()))) step.label.pop_back();
+            valid = !step.label.empty();
+        } else if (command == "drag") {
+            step.kind = STEP_DRAG;
+            valid = static_cast<bool>(fields >> step.values[0] >> step.values[1] >> step.values[2] >> step.values[3]);
+        } else if (command == "until" || command == "loop") {
+            step.kind = (command == "until") ? STEP_UNTIL : STEP_LOOP;
+            valid = fields >> sceneName >> step.values[0] && parseScene(sceneName, step.scene);
+            if (step.kind == STEP_LOOP) openLoops.push_back(steps.size());
+        } else if (command == "end") {
+            step.kind = STEP_END;
+            valid = !openLoops.empty();
+            if (valid) {
+                step.jump = openLoops.back();
+                steps[openLoops.back()].jump = steps.size() + 1;
+                openLoops.pop_back();
+            }
+        } else if (command == "quit") {
+            step.kind = STEP_QUIT;
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            std::cerr << path << ", line " << lineNumber << ": could not read \"" << line << "\"" << std::endl;
+            return false;
+        }
+        steps.push_back(step);
+    }
+    if (!openLoops.empty()) {
+        std::cerr << path << ": loop on line " << steps[openLoops.back()].line << " has no end" << std::endl;
+        return false;
+    }
+
+    startedAt.assign(steps.size(), 0);
+    for (SceneSamples& scene : samples) scene.frameMilliseconds.reserve(RESERVED_FRAMES);
+    active = true;
+    return true;
+}
+
+bool UiScript::isActive() {
+    return active;
+}
+
+uint64_t UiScript::getSeed() {
+    return seed;
+}
+
+void UiScript::beginFrame(SDL_Window* window, UiScene scene, const ButtonFinder& findButton) {
+    if (!active) return;
+    frameScene = scene;
+    frameStart = SDL_GetPerformanceCounter();
+    allocationsAtStart = allocations.load(std::memory_order_relaxed);
+    statsAtStart = RenderThread::getStats();
+    frameNumber++;
+
+    if (finished) return;
+    if (waitFrames > 0) {
+        waitFrames--;
+        return;
+    }
+
+    while (current < steps.size()) {
+        const ScriptStep& step = steps[current];
+        SDL_Rect rect;
+        switch (step.kind) {
+            case STEP_WAIT:
+                waitFrames = step.values[0] - 1;   // This frame is the first
+                current++;
+                return;
+            case STEP_CLICK:
+                if (findButton(step.label, rect)) click(window, rect.x + rect.w / 2, rect.y + rect.h / 2);
+                current++;
+                return;
+            case STEP_DRAG:
+                drag(window, step.values);
+                current++;
+                return;
+            case STEP_UNTIL:
+                if (scene == step.scene) {
+                    startedAt[current] = 0;
+                    current++;
+                    continue;
+                }
+                if (timedOut(current)) {
+                    fail(step, std::string("never reached ") + SCENE_NAMES[step.scene]);
+                    quit();
+                }
+                return;
+            case STEP_LOOP:
+                if (scene == step.scene) {
+                    startedAt[current] = 0;
+                    current = step.jump;
+                    continue;
+                }
+                if (timedOut(current)) {
+                    fail(step, std::string("never reached ") + SCENE_NAMES[step.scene]);
+                    quit();
+                    return;
+                }
+                current++;
+                continue;
+            case STEP_END:
+                current = step.jump;    // Back to the loop, which checks the scene next frame
+                return;
+            case STEP_QUIT:
+                quit();
+                return;
+        }
+    }
+    quit();
+}
+
+void UiScript::endFrame() {
+    if (!active) return;
+    RenderStats stats = RenderThread::getStats();
+    SceneSamples& scene = samples[frameScene];
+    scene.frameMilliseconds.push_back(1000.0f * (SDL_GetPerformanceCounter() - frameStart) / SDL_GetPerformanceFrequency());
+    scene.drawMilliseconds += stats.drawMilliseconds - statsAtStart.drawMilliseconds;
+    scene.allocations += allocations.load(std::memory_order_relaxed) - allocationsAtStart;
+    scene.textureUploads += stats.textureUploads - statsAtStart.textureUploads;
+}
+
+int UiScript::finish() {
+    if (!active) return 0;
+
+    SceneResult results[SCENE_COUNT];
+    std::ofstream out(RESULTS_FILE);
+    out << "# scene frames mean_ms p95_ms draw_ms allocations_per_frame uploads_per_frame" << std::endl;
+    std::cout << std::left << std::setw(10) << "scene" << std::right << std::setw(8) << "frames" << std::setw(10) << "mean ms"
+              << std::setw(10) << "p95 ms" << std::setw(10) << "draw ms" << std::setw(10) << "allocs" << std::setw(10) << "uploads" << std::endl;
+    for (int i = 0; i < SCENE_COUNT; ++i) {
+        results[i] = summarize(samples[i]);
+        if (results[i].frames == 0) continue;
+        const SceneResult& result = results[i];
+        out << SCENE_NAMES[i] << " " << result.frames << " " << result.meanMilliseconds << " " << result.p95Milliseconds << " "
+            << result.drawMilliseconds << " " << result.allocationsPerFrame << " " << result.uploadsPerFrame << std::endl;
+        std::cout << std::fixed << std::setprecision(3) << std::left << std::setw(10) << SCENE_NAMES[i] << std::right
+                  << std::setw(8) << result.frames << std::setw(10) << result.meanMilliseconds << std::setw(10) << result.p95Milliseconds
+                  << std::setw(10) << result.drawMilliseconds << std::setw(10) << std::setprecision(1) << result.allocationsPerFrame
+                  << std::setw(10) << std::setprecision(2) << result.uploadsPerFrame << std::endl;
+    }
+
+    for (int kind = 0; kind < INPUT_KIND_COUNT; ++kind) {
+        LatencySummary latency = InputLatency::getSummary(static_cast<InputKind>(kind));
+        if (latency.samples == 0) continue;
+        std::cout << std::setprecision(1) << "click to present, " << InputLatency::getName(static_cast<InputKind>(kind)) << ": p50 "
+                  << latency.p50Milliseconds << " ms, p99 " << latency.p99Milliseconds << " ms (" << latency.samples << " clicks)" << std::endl;
+    }
+
+    SceneResult baseline[SCENE_COUNT];
+    if (!readResults(BASELINE_FILE, baseline)) {
+        std::cout << "No " << BASELINE_FILE << " to compare with (make perf-ui-baseline keeps this run as one)" << std::endl;
+        return failed ? 1 : 0;
+    }
+
+    bool regressed = false;
+    for (int i = 0; i < SCENE_COUNT; ++i) {
+        const SceneResult& before = baseline[i];
+        const SceneResult& now = results[i];
+        if (before.frames == 0) continue;
+        std::string problem;
+        if (now.frames == 0) problem = "not reached";
+        else if (slower(now.p95Milliseconds, before.p95Milliseconds)) problem = "p95 frame time";
+        else if (slower(now.drawMilliseconds, before.drawMilliseconds)) problem = "draw time";
+        else if (now.allocationsPerFrame > before.allocationsPerFrame * ALLOCATION_RATIO + ALLOCATION_SLACK) problem = "allocations";
+        else if (now.uploadsPerFrame > before.uploadsPerFrame + UPLOAD_SLACK) problem = "texture uploads";
+        if (problem.empty()) continue;
+        std::cout << "REGRESSION in " << SCENE_NAMES[i] << ": " << problem << std::endl;
+        regressed = true;
+    }
+    return (failed || regressed) ? 1 : 0;
+}
+
+uint64_t UiScript::getAllocations() {
+    return allocations.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,61 @@
+#ifndef UI_SCRIPT_H
+#define UI_SCRIPT_H
+
+#include <SDL.h>
+#include <string>
+#include <cstdint>
+#include <functional>
+
+// The screens measured separately
+enum UiScene {
+    SCENE_MENU,         // Main menu and its submenus
+    SCENE_AWARDS,       // Awards & Statistics
+    SCENE_GAME,
+    SCENE_GAME_OVER,
+    SCENE_COUNT
+};
+
+// Looks up a button on the current screen by its label
+using ButtonFinder = std::function<bool(const std::string& label, SDL_Rect& rect)>;
+
+// Drives the real UI from a script (main --script=<file>) and measures each
+// scene: the game thread's time to handle input and record a frame, the
+// render thread's time to draw it, allocations and texture uploads. Meant
+// for a machine with no display, with SDL_VIDEODRIVER=dummy (make perf-ui).
+//
+// Script commands, one per line, # starts a comment:
+//   seed <n>                     Dice seed, so every run plays the same game
+//   wait <frames>
+//   click <label>                Clicks a button by its label; skipped if it is not on screen
+//   drag <x1> <y1> <x2> <y2>
+//   until <scene> <frames>       Waits for a scene; fails the run if it takes longer
+//   loop <scene> <frames>        Repeats up to the matching end until the scene shows
+//   end
+//   quit
+// Scenes are named menu, awards, game and game-over.
+//
+// At the end the results are written to ui_perf.txt and compared with
+// ui_perf_baseline.txt if there is one; a scene that got slower, allocates
+// more or uploads more textures fails the run. Allocations are only counted
+// when built with UI_PERF_COUNT_ALLOCATIONS, as main_perf is; otherwise
+// they read as none.
+class UiScript {
+public:
+    // False if the script could not be read or has a mistake in it
+    static bool load(const std::string& path);
+    static bool isActive();
+    static uint64_t getSeed();
+
+    // Start of a frame, before events are polled: posts whatever input the script has for it
+    static void beginFrame(SDL_Window* window, UiScene scene, const ButtonFinder& findButton);
+    // Once the frame is recorded, before it is submitted
+    static void endFrame();
+
+    // Reports and compares with the baseline; the exit status for main
+    static int finish();
+
+    // Allocations made by the whole program so far, when counted
+    static uint64_t getAllocations();
+};
+
+#endif
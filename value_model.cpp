@@ -0,0 +1,151 @@
+#include "value_model.h"
+#include "snapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VALUE_MODEL_SSE 1
+#endif
+
+namespace {
+
+const char MAGIC[4] = {'Z', 'V', 'A', 'L'};
+const size_t HEADER_SIZE = 8;
+const size_t WEIGHT_COUNT = VALUE_INPUTS * VALUE_HIDDEN + VALUE_HIDDEN * 2 + 1;
+
+// Every weight in file order
+template <typename Weights, typename Visit>
+void forEachWeight(Weights& weights, const Visit& visit) {
+    for (int i = 0; i < VALUE_INPUTS; ++i) {
+        for (int j = 0; j < VALUE_HIDDEN; ++j) visit(weights.input[i][j]);
+    }
+    for (int j = 0; j < VALUE_HIDDEN; ++j) visit(weights.hiddenBias[j]);
+    for (int j = 0; j < VALUE_HIDDEN; ++j) visit(weights.output[j]);
+    visit(weights.outputBias);
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back((value >> (8 * i)) & 0xFF);
+}
+
+uint32_t getU32(const uint8_t* in) {
+    return in[0] | (in[1] << 8) | (in[2] << 16) | (uint32_t(in[3]) << 24);
+}
+
+}
+
+
+void ValueModel::features(const ValueState& state, float out[VALUE_INPUTS]) {
+    float target = std::max(state.winningPoints, 1);
+    out[0] = state.turnPoints / target;
+    out[1] = state.diceToRoll / 6.0f;
+    out[2] = state.ownPoints / target;
+    out[3] = state.opponentPoints / target;
+    out[4] = (state.ownPoints + state.turnPoints - state.opponentPoints) / target;
+    out[5] = state.zilches / 2.0f;
+    out[6] = state.opponentPoints >= state.winningPoints ? 1.0f : 0.0f;  // This is the last turn
+    out[7] = state.winningPoints / 10000.0f;
+}
+
+uint64_t ValueModel::newId() {
+    static std::atomic<uint64_t> next{1};
+    return next++;
+}
+
+float ValueModel::evaluate(const ValueState& state) const {
+    float x[VALUE_INPUTS];
+    features(state, x);
+    return evaluateFeatures(x);
+}
+
+float ValueModel::evaluateFeatures(const float x[VALUE_INPUTS]) const {
+    float z;
+#ifdef VALUE_MODEL_SSE
+    const int GROUPS = VALUE_HIDDEN / 4;
+    __m128 hidden[GROUPS];
+    for (int g = 0; g < GROUPS; ++g) hidden[g] = _mm_load_ps(weights.hiddenBias + 4 * g);
+
+    // Each input scales one row of weights into all hidden units at once
+    for (int i = 0; i < VALUE_INPUTS; ++i) {
+        __m128 xi = _mm_set1_ps(x[i]);
+        for (int g = 0; g < GROUPS; ++g) {
+            hidden[g] = _mm_add_ps(hidden[g], _mm_mul_ps(xi, _mm_load_ps(weights.input[i] + 4 * g)));
+        }
+    }
+
+    __m128 zero = _mm_setzero_ps();
+    __m128 sum = zero;
+    for (int g = 0; g < GROUPS; ++g) {
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_max_ps(hidden[g], zero), _mm_load_ps(weights.output + 4 * g)));
+    }
+    __m128 swapped = _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1));
+    sum = _mm_add_ps(sum, swapped);
+    sum = _mm_add_ss(sum, _mm_movehl_ps(swapped, sum));
+    z = _mm_cvtss_f32(sum) + weights.outputBias;
+#else
+    float hidden[VALUE_HIDDEN];
+    std::memcpy(hidden, weights.hiddenBias, sizeof(hidden));
+    for (int i = 0; i < VALUE_INPUTS; ++i) {
+        for (int j = 0; j < VALUE_HIDDEN; ++j) hidden[j] += x[i] * weights.input[i][j];
+    }
+    z = weights.outputBias;
+    for (int j = 0; j < VALUE_HIDDEN; ++j) z += std::max(hidden[j], 0.0f) * weights.output[j];
+#endif
+    return 1.0f / (1.0f + std::exp(-z));
+}
+
+bool ValueModel::load(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    std::vector<uint8_t> data(HEADER_SIZE + WEIGHT_COUNT * 4 + 4);
+    bool read = std::fread(data.data(), 1, data.size(), file) == data.size() && std::fgetc(file) == EOF;
+    std::fclose(file);
+
+    if (!read || std::memcmp(data.data(), MAGIC, 4) != 0) return false;
+    if ((data[4] | (data[5] << 8)) != VERSION || data[6] != VALUE_INPUTS || data[7] != VALUE_HIDDEN) return false;
+    size_t end = data.size() - 4;
+    if (getU32(data.data() + end) != Snapshot::checksum(data.data(), end)) return false;
+
+    ValueWeights loaded;
+    size_t at = HEADER_SIZE;
+    forEachWeight(loaded, [&](float& weight) {
+        uint32_t bits = getU32(data.data() + at);
+        std::memcpy(&weight, &bits, 4);
+        at += 4;
+    });
+    weights = loaded;
+    id = newId();
+    return true;
+}
+
+// Written to a temporary file first like the snapshot, so a cut off run leaves the old model
+bool ValueModel::save(const std::string& path) const {
+    std::vector<uint8_t> data(MAGIC, MAGIC + 4);
+    data.push_back(VERSION & 0xFF);
+    data.push_back(VERSION >> 8);
+    data.push_back(VALUE_INPUTS);
+    data.push_back(VALUE_HIDDEN);
+    forEachWeight(weights, [&](const float& weight) {
+        uint32_t bits;
+        std::memcpy(&bits, &weight, 4);
+        putU32(data, bits);
+    });
+    putU32(data, Snapshot::checksum(data.data(), data.size()));
+
+    std::string tempPath = path + ".tmp";
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) return false;
+    bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    written = (std::fclose(file) == 0) && written;
+
+    if (!written || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,64 @@
+#ifndef VALUE_MODEL_H
+#define VALUE_MODEL_H
+
+#include <string>
+#include <cstdint>
+
+// Written by the trainer (make train), read by profiles with a "model"
+const std::string LEARNED_AI_MODEL_FILE = "assets/learned_ai.bin";
+
+const int VALUE_INPUTS = 8;
+const int VALUE_HIDDEN = 16;    // A multiple of 4, one SSE register per 4 units
+
+// A position from the view of the player about to roll
+struct ValueState {
+    int turnPoints;     // Soft points so far this turn
+    int diceToRoll;     // 1 to 6
+    int ownPoints;      // Banked
+    int opponentPoints;
+    int zilches;        // In a row, 0 to 2
+    int winningPoints;
+};
+
+// The weights of a one hidden layer network: ReLU units, then a sigmoid.
+// Input weights are stored input by input so four hidden units share a load.
+struct ValueWeights {
+    alignas(16) float input[VALUE_INPUTS][VALUE_HIDDEN];
+    alignas(16) float hiddenBias[VALUE_HIDDEN];
+    alignas(16) float output[VALUE_HIDDEN];
+    float outputBias;
+};
+
+// Chance the player about to roll goes on to win, learned from simulated games.
+// File layout (little endian):
+//   "ZVAL" | u16 version | u8 inputs | u8 hidden
+//   f32 input[inputs][hidden] | f32 hiddenBias[hidden] | f32 output[hidden] | f32 outputBias
+//   u32 checksum of everything before it
+class ValueModel {
+public:
+    static const uint16_t VERSION = 1;
+
+    // Scaled by the win target, so one model plays any target
+    static void features(const ValueState& state, float out[VALUE_INPUTS]);
+
+    float evaluate(const ValueState& state) const;
+    float evaluateFeatures(const float x[VALUE_INPUTS]) const;
+
+    const ValueWeights& getWeights() const { return weights; }
+    void setWeights(const ValueWeights& newWeights) { weights = newWeights; id = newId(); }
+
+    // Changes with the weights, so answers worked out with other ones are never reused
+    uint64_t getId() const { return id; }
+
+    // False if the file is missing, damaged or from another version or shape
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+private:
+    static uint64_t newId();
+
+    ValueWeights weights = {};
+    uint64_t id = newId();
+};
+
+#endif